@@ -35,6 +35,7 @@
  */
 
 #include "spi_master.h"
+#include "tcm.h"
 #if SAMG55
 #include "flexcom.h"
 #include "conf_board.h"
@@ -178,7 +179,7 @@ void spi_deselect_device(Spi *p_spi, struct spi_device *device)
  *
  * \pre SPI device must be selected with spi_select_device() first.
  */
-status_code_t spi_write_packet(Spi *p_spi, const uint8_t *data,
+ITCM_FUNC status_code_t spi_write_packet(Spi *p_spi, const uint8_t *data,
 		size_t len)
 {
 	uint32_t timeout = SPI_TIMEOUT;
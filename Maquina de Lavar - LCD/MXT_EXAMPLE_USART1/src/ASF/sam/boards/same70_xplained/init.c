@@ -328,8 +328,25 @@ static void _setup_memory_region( void )
 #ifdef CONF_BOARD_ENABLE_TCM_AT_INIT
 #if defined(__GNUC__)
 extern char _itcm_lma, _sitcm, _eitcm;
+extern char _sdtcm, _edtcm;
 #endif
 
+/* GPNVM bits 8:7 select the TCM size: 01 = 32 KB ITCM + 32 KB DTCM, which
+ * is what flash.ld takes off the system SRAM. */
+#define TCM_GPNVM_MASK   (3u << 7)
+#define TCM_GPNVM_32K    (1u << 7)
+
+/** \brief Run an EEFC command and return EEFC_FRR.
+ * The EEFC stalls flash reads while busy, so this runs from RAM.
+ */
+static RAMFUNC __no_inline uint32_t tcm_efc_command(uint32_t cmd, uint32_t arg)
+{
+	EFC->EEFC_FCR = EEFC_FCR_FKEY_PASSWD | EEFC_FCR_FARG(arg) | cmd;
+	while (!(EFC->EEFC_FSR & EEFC_FSR_FRDY)) {
+	}
+	return EFC->EEFC_FRR;
+}
+
 /** \brief  TCM memory enable
 * The function enables TCM memories
 */
@@ -380,11 +397,13 @@ void board_init(void)
 #endif
 
 #ifdef CONF_BOARD_ENABLE_TCM_AT_INIT
-	/* TCM Configuration */
-	EFC->EEFC_FCR = (EEFC_FCR_FKEY_PASSWD | EEFC_FCR_FCMD_CGPB 
-					| EEFC_FCR_FARG(8));
-	EFC->EEFC_FCR = (EEFC_FCR_FKEY_PASSWD | EEFC_FCR_FCMD_SGPB
-					| EEFC_FCR_FARG(7));
+	/* TCM Configuration: the GPNVM bits are only sampled at reset, so a
+	 * board that still has another size reboots once after the change */
+	if ((tcm_efc_command(EEFC_FCR_FCMD_GGPB, 0) & TCM_GPNVM_MASK) != TCM_GPNVM_32K) {
+		tcm_efc_command(EEFC_FCR_FCMD_CGPB, 8);
+		tcm_efc_command(EEFC_FCR_FCMD_SGPB, 7);
+		NVIC_SystemReset();
+	}
 	tcm_enable();
 #if defined(__GNUC__)
 	volatile char *dst = &_sitcm;
@@ -393,6 +412,12 @@ void board_init(void)
 	while(dst < &_eitcm){
 		*dst++ = *src++;
 	}
+	/* .dtcm is NOLOAD: zero it like .bss */
+	for (dst = &_sdtcm; dst < &_edtcm; ) {
+		*dst++ = 0;
+	}
+	__DSB();
+	__ISB();
 #endif
 #else
 	/* TCM Configuration */
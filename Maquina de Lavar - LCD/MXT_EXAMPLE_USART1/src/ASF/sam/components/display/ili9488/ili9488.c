@@ -49,6 +49,8 @@
 #include <assert.h>
 #include <stdlib.h>
 #include "pio.h"
+#include "prof.h"
+#include "tcm.h"
 #ifdef ILI9488_EBIMODE
 #  include "smc.h"
 #  include "pmc.h"
@@ -65,9 +67,12 @@
 /**INDENT-ON**/
 /// @endcond
 
-/* Pixel cache used to speed up communication */
+/* Pixel cache used to speed up communication, kept in DTCM (tcm.h) */
 #define LCD_DATA_CACHE_SIZE ILI9488_LCD_WIDTH
-static ili9488_color_t g_ul_pixel_cache[LCD_DATA_CACHE_SIZE*LCD_DATA_COLOR_UNIT];
+static ili9488_color_t g_ul_pixel_cache[LCD_DATA_CACHE_SIZE*LCD_DATA_COLOR_UNIT] DTCM_BSS;
+
+/* Bytes sent to the controller over SPI (commands and data), for telemetry */
+uint32_t ili9488_spi_bytes;
 
 /* Global variable describing the font size used by the driver */
 const struct ili9488_font gfont = {10, 14};
@@ -322,7 +327,7 @@ static void ili9488_write_ram(ili9488_color_t ul_color)
  * \param p_ul_buf data buffer.
  * \param ul_size size in pixels.
  */
-static void ili9488_write_ram_buffer(const ili9488_color_t *p_ul_buf, uint32_t ul_size)
+static ITCM_FUNC void ili9488_write_ram_buffer(const ili9488_color_t *p_ul_buf, uint32_t ul_size)
 {
 	pio_set(PIN_EBI_CDS_PIO, PIN_EBI_CDS_MASK);
 	LCD_MULTI_WD(p_ul_buf, ul_size);
@@ -335,7 +340,7 @@ static void ili9488_write_ram_buffer(const ili9488_color_t *p_ul_buf, uint32_t u
  * \param us_data data to be written.
  * \param size the number of parameters.
  */
-static void ili9488_write_register(uint8_t uc_reg, const ili9488_color_t *us_data, uint32_t size)
+static ITCM_FUNC void ili9488_write_register(uint8_t uc_reg, const ili9488_color_t *us_data, uint32_t size)
 {
 	/* CDS pin is set low level when writing command*/
 	pio_clear(PIN_EBI_CDS_PIO, PIN_EBI_CDS_MASK);
@@ -396,6 +401,7 @@ static void ili9488_write_ram_prepare(void)
 	volatile uint32_t i;
 	pio_set_pin_low(LCD_SPI_CDS_PIO);
 	spi_write(BOARD_ILI9488_SPI, ILI9488_CMD_MEMORY_WRITE, BOARD_ILI9488_SPI_NPCS, 0);
+	ili9488_spi_bytes++;
 	for(i = 0; i < 0xFF; i++);
 }
 
@@ -408,6 +414,7 @@ static void ili9488_write_ram(ili9488_color_t ul_color)
 {
 	pio_set_pin_high(LCD_SPI_CDS_PIO);
 	spi_write(BOARD_ILI9488_SPI, ul_color, BOARD_ILI9488_SPI_NPCS, 0);
+	ili9488_spi_bytes++;
 }
 
 /**
@@ -416,11 +423,12 @@ static void ili9488_write_ram(ili9488_color_t ul_color)
  * \param p_ul_buf data buffer.
  * \param ul_size size in pixels.
  */
-static void ili9488_write_ram_buffer(const ili9488_color_t *p_ul_buf, uint32_t ul_size)
+static ITCM_FUNC void ili9488_write_ram_buffer(const ili9488_color_t *p_ul_buf, uint32_t ul_size)
 {
 	volatile uint32_t i;
 	pio_set_pin_high(LCD_SPI_CDS_PIO);
 	spi_write_packet(BOARD_ILI9488_SPI, p_ul_buf, ul_size);
+	ili9488_spi_bytes += ul_size;
 	for(i = 0; i < 0xFF; i++);
 }
 
@@ -431,13 +439,14 @@ static void ili9488_write_ram_buffer(const ili9488_color_t *p_ul_buf, uint32_t u
  * \param us_data data to be written.
  * \param size the number of parameters.
  */
-static void ili9488_write_register(uint8_t uc_reg, const ili9488_color_t *us_data, uint32_t size)
+static ITCM_FUNC void ili9488_write_register(uint8_t uc_reg, const ili9488_color_t *us_data, uint32_t size)
 {
 	volatile uint32_t i;
 
 	/* Transfer cmd */
 	pio_set_pin_low(LCD_SPI_CDS_PIO);
 	spi_write(BOARD_ILI9488_SPI, uc_reg, BOARD_ILI9488_SPI_NPCS, 0);
+	ili9488_spi_bytes += 1 + size;
 	for(i = 0; i < 0xFF; i++);
 
 	if(size > 0) {
@@ -731,7 +740,7 @@ void ili9488_display_off(void)
  *
  * \param ul_color foreground color.
  */
-void ili9488_set_foreground_color(uint32_t ul_color)
+ITCM_FUNC void ili9488_set_foreground_color(uint32_t ul_color)
 {
 	uint32_t i;
 #ifdef ILI9488_EBIMODE
@@ -993,7 +1002,7 @@ void ili9488_draw_rectangle(uint32_t ul_x1, uint32_t ul_y1,
  * \param ul_x2 X coordinate of lower-right corner on LCD.
  * \param ul_y2 Y coordinate of lower-right corner on LCD.
  */
-void ili9488_draw_filled_rectangle(uint32_t ul_x1, uint32_t ul_y1,
+ITCM_FUNC void ili9488_draw_filled_rectangle(uint32_t ul_x1, uint32_t ul_y1,
 		uint32_t ul_x2, uint32_t ul_y2)
 {
 	uint32_t size, blocks;
@@ -1205,11 +1214,13 @@ void ili9488_draw_string(uint32_t ul_x, uint32_t ul_y, const uint8_t *p_str)
  * \param ul_height height of the picture.
  * \param p_ul_pixmap pixmap of the image.
  */
-void ili9488_draw_pixmap(uint32_t ul_x, uint32_t ul_y, uint32_t ul_width,
+ITCM_FUNC void ili9488_draw_pixmap(uint32_t ul_x, uint32_t ul_y, uint32_t ul_width,
 		uint32_t ul_height, const ili9488_color_t *p_ul_pixmap)
 {
 	uint32_t size;
 	uint32_t dwX1, dwY1, dwX2, dwY2;
+
+	PROF_BEGIN(PIXMAP);
 	dwX1 = ul_x;
 	dwY1 = ul_y;
 	dwX2 = ul_x + ul_width - 1;
@@ -1227,6 +1238,37 @@ void ili9488_draw_pixmap(uint32_t ul_x, uint32_t ul_y, uint32_t ul_width,
 
 	/* Reset the refresh window area */
 	ili9488_set_window(0, 0, ILI9488_LCD_WIDTH, ILI9488_LCD_HEIGHT);
+	PROF_END(PIXMAP);
+}
+
+/**
+ * \brief Draw a rectangle cut out of a larger pixmap on LCD.
+ *
+ * The rectangle goes out in a single window and GRAM write, one SPI
+ * packet per row, so a clipped image costs what a full one of the same
+ * size does.
+ *
+ * \param ul_x X coordinate of upper-left corner on LCD.
+ * \param ul_y Y coordinate of upper-left corner on LCD.
+ * \param ul_width width of the rectangle.
+ * \param ul_height height of the rectangle.
+ * \param p_ul_pixmap first pixel of the rectangle inside the pixmap.
+ * \param ul_stride width of the whole pixmap, in pixels.
+ */
+ITCM_FUNC void ili9488_draw_pixmap_rect(uint32_t ul_x, uint32_t ul_y, uint32_t ul_width,
+		uint32_t ul_height, const ili9488_color_t *p_ul_pixmap, uint32_t ul_stride)
+{
+	PROF_BEGIN(PIXMAP);
+	ili9488_set_window(ul_x, ul_y, ul_width, ul_height);
+	ili9488_write_ram_prepare();
+	while (ul_height--) {
+		ili9488_write_ram_buffer(p_ul_pixmap, ul_width * LCD_DATA_COLOR_UNIT);
+		p_ul_pixmap += ul_stride * LCD_DATA_COLOR_UNIT;
+	}
+
+	/* Reset the refresh window area */
+	ili9488_set_window(0, 0, ILI9488_LCD_WIDTH, ILI9488_LCD_HEIGHT);
+	PROF_END(PIXMAP);
 }
 
 /**
@@ -324,6 +324,11 @@ enum ili9488_display_direction{
 };
 
 
+#ifdef ILI9488_SPIMODE
+/** Bytes sent over SPI since reset (commands and pixel data) */
+extern uint32_t ili9488_spi_bytes;
+#endif
+
 uint32_t ili9488_init(struct ili9488_opt_t *p_opt);
 void ili9488_set_display_direction(enum ili9488_display_direction direction);
 void ili9488_set_window( uint16_t dwX, uint16_t dwY, uint16_t dwWidth, uint16_t dwHeight );
@@ -349,6 +354,8 @@ void ili9488_draw_prepare(uint32_t ul_x, uint32_t ul_y, uint32_t ul_width,
 void ili9488_draw_string(uint32_t ul_x, uint32_t ul_y, const uint8_t *p_str);
 void ili9488_draw_pixmap(uint32_t ul_x, uint32_t ul_y, uint32_t ul_width,
 		uint32_t ul_height, const ili9488_color_t *p_ul_pixmap);
+void ili9488_draw_pixmap_rect(uint32_t ul_x, uint32_t ul_y, uint32_t ul_width,
+		uint32_t ul_height, const ili9488_color_t *p_ul_pixmap, uint32_t ul_stride);
 void ili9488_delay(uint32_t ul_ms);
 void ili9488_write_brightness(uint16_t us_value);
 uint16_t ili9488_read_gram(void);
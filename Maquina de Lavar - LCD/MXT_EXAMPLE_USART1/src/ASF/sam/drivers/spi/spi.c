@@ -36,6 +36,7 @@
 
 #include "spi.h"
 #include "sysclk.h"
+#include "tcm.h"
 
 /**
  * \defgroup sam_drivers_spi_group Serial Peripheral Interface (SPI)
@@ -254,7 +255,7 @@ spi_status_t spi_read(Spi *p_spi, uint16_t *us_data, uint8_t *p_pcs)
  * \retval SPI_OK on Success.
  * \retval SPI_ERROR_TIMEOUT on Time-out.
  */
-spi_status_t spi_write(Spi *p_spi, uint16_t us_data,
+ITCM_FUNC spi_status_t spi_write(Spi *p_spi, uint16_t us_data,
 		uint8_t uc_pcs, uint8_t uc_last)
 {
 	uint32_t timeout = SPI_TIMEOUT;
@@ -0,0 +1,22 @@
+/*
+ * backup_gpbr.c
+ *
+ * Back end de hardware do backup_regs: os 8 GPBR do SAME70. O tipo do
+ * ultimo reset vem do RSTC; so o GENERAL_RST (primeira energizacao, sem
+ * VBAT) zera o dominio de backup.
+ */
+
+#include <compiler.h>
+#include "backup_regs.h"
+
+uint32_t backup_read(uint8_t index){
+	return GPBR->SYS_GPBR[index];
+}
+
+void backup_write(uint8_t index, uint32_t value){
+	GPBR->SYS_GPBR[index] = value;
+}
+
+bool backup_retained(void){
+	return (RSTC->RSTC_SR & RSTC_SR_RSTTYP_Msk) != RSTC_SR_RSTTYP_GENERAL_RST;
+}
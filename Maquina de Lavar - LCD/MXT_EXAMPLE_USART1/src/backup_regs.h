@@ -0,0 +1,31 @@
+/*
+ * backup_regs.h
+ *
+ * Registradores de backup: BACKUP_REGS palavras de 32 bits que sobrevivem a
+ * qualquer reset menos o de primeira energizacao (no SAME70 sao os GPBR, no
+ * mesmo dominio do RTT e do RTC). Escrever e so um acesso a registrador,
+ * entao cabe no caminho de uma troca de fase. backup_retained() diz se o
+ * dominio de backup passou pelo reset: se nao, os registradores estao
+ * zerados e o RTT e o RTC recomecaram. O back end do alvo e backup_gpbr.c;
+ * o de host e sim/backup_sim.c.
+ */
+
+
+#ifndef BACKUP_REGS_H_
+#define BACKUP_REGS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BACKUP_REGS  8u
+
+uint32_t backup_read(uint8_t index);
+void backup_write(uint8_t index, uint32_t value);
+bool backup_retained(void);
+
+#ifdef HOST_BUILD
+//QUEDA DE ENERGIA: COM keep_backup (BATERIA NO VBAT) OS REGISTRADORES FICAM
+void backup_sim_power_loss(bool keep_backup);
+#endif
+
+#endif /* BACKUP_REGS_H_ */
@@ -0,0 +1,20 @@
+#ifndef CICLO_H
+#define CICLO_H
+
+//DESCRICAO DE UM CICLO; OS CICLOS PRONTOS FICAM EM ciclos.def (cycle_table.h)
+
+typedef struct ciclo t_ciclo;
+
+struct ciclo{
+  char nome[32];           // nome do ciclo, para ser exibido
+  int  enxagueTempo;       // tempo que fica em cada enxague
+  int  enxagueQnt;         // quantidade de enxagues
+  int  centrifugacaoRPM;   // velocidade da centrifugacao
+  int  centrifugacaoTempo; // tempo que centrifuga
+  char heavy;              // modo pesado de lavagem
+  char bubblesOn;          // smart bubbles on (???)
+  t_ciclo *previous;
+  t_ciclo *next;
+};
+
+#endif
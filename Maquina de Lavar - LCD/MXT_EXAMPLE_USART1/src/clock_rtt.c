@@ -0,0 +1,112 @@
+/*
+ * clock_rtt.c
+ *
+ * Back end de hardware do clock_source: RTT a 32768 Hz / 32 = 1024 ticks
+ * por segundo, que continua contando com o core em WFI. O RTT_VR tem 32
+ * bits e da a volta em ~48 dias; a parte alta e estendida em software
+ * contando as voltas a cada leitura. Para nenhuma volta passar sem leitura,
+ * o alarme nunca fica mais de 2^31 ticks a frente (~24 dias), mesmo sem
+ * alarme pedido. O RTT fica no dominio de backup: num reset quente ele
+ * continua contando e o tempo segue do boot anterior, entao um prazo
+ * absoluto gravado antes do reset (wash_checkpoint.h) ainda vale.
+ */
+
+#include <compiler.h>
+#include <interrupt.h>
+#include <rtt.h>
+#include "clock_source.h"
+#include "backup_regs.h"
+
+#define RTT_PRESCALER    32
+#define RTT_TICK_HZ      1024
+#define MAX_ALARM_TICKS  0x80000000ull
+
+static uint32_t last_ticks;
+static uint32_t wraps;
+static uint64_t skew_ms;    // clock_skew(): o tempo do sistema e o RTT mais isto
+static clock_alarm_handler on_alarm;
+
+//TICKS DO RTT EM 64 BITS; PODE SER CHAMADO DE INTERRUPCAO
+static uint64_t now_ticks(void){
+	irqflags_t flags = cpu_irq_save();
+	uint32_t ticks = rtt_read_timer_value(RTT);
+
+	if (ticks < last_ticks){
+		wraps++;
+	}
+	last_ticks = ticks;
+	uint64_t t = ((uint64_t)wraps << 32) | ticks;
+	cpu_irq_restore(flags);
+	return t;
+}
+
+static inline uint64_t ticks_to_ms(uint64_t ticks){
+	return (ticks * 1000) / RTT_TICK_HZ;
+}
+
+//ARREDONDA PARA CIMA: O ALARME NUNCA DISPARA ANTES DO PRAZO
+static inline uint64_t ms_to_ticks(uint64_t ms){
+	return (ms * RTT_TICK_HZ + 999) / 1000;
+}
+
+void clock_init(clock_alarm_handler handler){
+	on_alarm = handler;
+	if (backup_retained() && (RTT->RTT_MR & RTT_MR_RTPRES_Msk) == RTT_MR_RTPRES(RTT_PRESCALER)){
+		//RESET QUENTE: NAO ZERA O CONTADOR, SO O ALARME DO BOOT ANTERIOR
+		rtt_disable_interrupt(RTT, RTT_MR_ALMIEN);
+	} else {
+		rtt_init(RTT, RTT_PRESCALER);
+	}
+	//AS VOLTAS DO BOOT ANTERIOR SE PERDEM (SO DEPOIS DE ~48 DIAS LIGADO)
+	last_ticks = rtt_read_timer_value(RTT);
+	wraps = 0;
+
+	NVIC_DisableIRQ(RTT_IRQn);
+	NVIC_ClearPendingIRQ(RTT_IRQn);
+	NVIC_SetPriority(RTT_IRQn, 2);
+	NVIC_EnableIRQ(RTT_IRQn);
+}
+
+uint64_t clock_now_ms(void){
+	return ticks_to_ms(now_ticks()) + skew_ms;
+}
+
+void clock_set_alarm(uint64_t at_ms){
+	uint64_t target = now_ticks() + MAX_ALARM_TICKS;
+
+	if (at_ms != CLOCK_NO_ALARM){
+		//+1: O FLAG DO ALARME PODE SUBIR UM TICK ANTES DO VALOR ESCRITO
+		uint64_t t = ms_to_ticks(at_ms > skew_ms ? at_ms - skew_ms : 0) + 1;
+		if (t < target){
+			target = t;
+		}
+	}
+	rtt_write_alarm_time(RTT, (uint32_t)target);
+	rtt_enable_interrupt(RTT, RTT_MR_ALMIEN);
+}
+
+//ESPERA OCUPADA: SO NO BOOT, ANTES DO LOOP DE EVENTOS (O ALARME E DA TIMEBASE)
+void clock_sleep_until(uint64_t at_ms){
+	while (clock_now_ms() < at_ms){
+	}
+}
+
+//O ALARME JA ESCRITO FICA ATRASADO ATE O PROXIMO clock_set_alarm()
+void clock_skew(uint64_t ms){
+	irqflags_t flags = cpu_irq_save();
+
+	skew_ms += ms;
+	cpu_irq_restore(flags);
+}
+
+void RTT_Handler(void)
+{
+	uint32_t ul_status = rtt_get_status(RTT);
+
+	if ((ul_status & RTT_SR_ALMS) == RTT_SR_ALMS) {
+		rtt_disable_interrupt(RTT, RTT_MR_ALMIEN);
+		if (on_alarm){
+			on_alarm();
+		}
+	}
+}
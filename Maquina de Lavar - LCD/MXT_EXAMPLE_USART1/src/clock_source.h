@@ -0,0 +1,38 @@
+/*
+ * clock_source.h
+ *
+ * Relogio do sistema: tempo monotonico em ms, um unico alarme absoluto e
+ * uma espera ate um instante. A timebase so fala com esta interface. O back
+ * end de hardware (clock_rtt.c) usa o RTT; o de host (sim/clock_sim.c) usa
+ * um tempo virtual que pula direto para o alarme ou anda em escala, entao o
+ * fluxo da lavagem roda no Linux de forma deterministica. clock_skew()
+ * adianta o relogio dos dois (console de bancada); quem chama roda a
+ * timebase depois, para os prazos que passaram vencerem.
+ */
+
+
+#ifndef CLOCK_SOURCE_H_
+#define CLOCK_SOURCE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CLOCK_NO_ALARM  UINT64_MAX
+
+//CHAMADO QUANDO O ALARME VENCE; NO HARDWARE RODA NA INTERRUPCAO
+typedef void (*clock_alarm_handler)(void);
+
+void clock_init(clock_alarm_handler handler);
+uint64_t clock_now_ms(void);
+void clock_set_alarm(uint64_t at_ms);
+void clock_sleep_until(uint64_t at_ms);
+void clock_skew(uint64_t ms);
+
+#ifdef HOST_BUILD
+void clock_sim_set_scale(uint32_t scale);
+void clock_sim_advance(uint64_t ms);
+void clock_sim_idle(void);
+uint32_t clock_sim_alarms(void);
+#endif
+
+#endif /* CLOCK_SOURCE_H_ */
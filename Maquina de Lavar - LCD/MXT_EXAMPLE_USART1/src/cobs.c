@@ -0,0 +1,55 @@
+/*
+ * cobs.c
+ *
+ * Cada grupo comeca com um byte de codigo: a distancia ate o proximo zero
+ * (que some da saida), ou 0xFF para 254 bytes sem zero nenhum.
+ */
+
+#include "cobs.h"
+
+uint16_t cobs_encode(const uint8_t *in, uint16_t len, uint8_t *out){
+	uint16_t code_at = 0;
+	uint16_t o = 1;
+	uint8_t code = 1;
+
+	for (uint16_t i = 0; i < len; i++){
+		if (in[i] == 0){
+			out[code_at] = code;
+			code_at = o++;
+			code = 1;
+			continue;
+		}
+		out[o++] = in[i];
+		if (++code == 0xFF){
+			out[code_at] = code;
+			code_at = o++;
+			code = 1;
+		}
+	}
+	out[code_at] = code;
+	return o;
+}
+
+//DEVOLVE O TAMANHO DECODIFICADO OU -1 SE O QUADRO ESTA CORROMPIDO
+int32_t cobs_decode(const uint8_t *in, uint16_t len, uint8_t *out){
+	uint16_t i = 0;
+	int32_t o = 0;
+
+	while (i < len){
+		uint8_t code = in[i++];
+
+		if (code == 0 || i + code - 1 > len){
+			return -1;
+		}
+		for (uint8_t k = 1; k < code; k++){
+			if (in[i] == 0){
+				return -1;
+			}
+			out[o++] = in[i++];
+		}
+		if (code != 0xFF && i < len){
+			out[o++] = 0;
+		}
+	}
+	return o;
+}
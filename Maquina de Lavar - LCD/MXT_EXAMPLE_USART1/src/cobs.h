@@ -0,0 +1,22 @@
+/*
+ * cobs.h
+ *
+ * Consistent Overhead Byte Stuffing: tira todos os zeros de um bloco
+ * custando no maximo 1 byte a cada 254, para o 0x00 servir de separador de
+ * quadros na serial. Quem recebe acha o fim do quadro sem olhar dentro e,
+ * depois de um byte perdido, se ressincroniza no proximo zero.
+ */
+
+
+#ifndef COBS_H_
+#define COBS_H_
+
+#include <stdint.h>
+
+//TAMANHO MAXIMO CODIFICADO DE len BYTES (SEM O 0x00 DO FIM)
+#define COBS_MAX(len)  ((len) + (len) / 254 + 1)
+
+uint16_t cobs_encode(const uint8_t *in, uint16_t len, uint8_t *out);
+int32_t cobs_decode(const uint8_t *in, uint16_t len, uint8_t *out);
+
+#endif /* COBS_H_ */
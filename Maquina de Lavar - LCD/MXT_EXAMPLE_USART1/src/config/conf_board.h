@@ -36,6 +36,9 @@
 /* Enable ICache and DCache */
 #define CONF_BOARD_ENABLE_CACHE
 
+/* 32 KB ITCM + 32 KB DTCM, filled from the .itcm/.dtcm sections (tcm.h) */
+#define CONF_BOARD_ENABLE_TCM_AT_INIT
+
 #define CONF_BOARD_UART_CONSOLE
 
 #define CONF_BOARD_MAXTOUCH_XPRO
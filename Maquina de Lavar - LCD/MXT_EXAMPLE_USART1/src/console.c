@@ -0,0 +1,191 @@
+/*
+ * console.c
+ *
+ * A linha vai acumulando ate '\r' ou '\n' (o que passar de
+ * CONSOLE_LINE_MAX descarta a linha toda), e quebrada em palavras e
+ * procurada na tabela de comandos. Numeros aceitam decimal ou 0x. As
+ * respostas saem por printf, que no alvo vai para o anel da serial.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "console.h"
+#include "prof.h"
+
+typedef struct {
+	const char *name;
+	const char *usage;
+	uint8_t min_args;
+	void (*run)(uint8_t argc, char *argv[]);
+} console_cmd;
+
+static const console_ops *ops;
+static char line[CONSOLE_LINE_MAX];
+static uint8_t line_len;
+static bool overflow;
+
+static bool parse_u32(const char *s, uint32_t *v){
+	char *end;
+
+	*v = strtoul(s, &end, 0);
+	return *s != '\0' && *end == '\0';
+}
+
+static void cmd_help(uint8_t argc, char *argv[]);
+
+static void cmd_touch(uint8_t argc, char *argv[]){
+	uint32_t x, y, hold = 50;
+
+	if (!parse_u32(argv[1], &x) || !parse_u32(argv[2], &y) || (argc > 3 && !parse_u32(argv[3], &hold))
+			|| x > 0xFFFF || y > 0xFFFF){
+		printf("touch: numero invalido\n\r");
+		return;
+	}
+	ops->touch(x, y, hold);
+}
+
+static void cmd_cycle(uint8_t argc, char *argv[]){
+	uint32_t id;
+
+	(void)argc;
+	if (!parse_u32(argv[1], &id) || id > 0xFF || !ops->cycle(id)){
+		printf("cycle: ciclo invalido ou maquina ocupada\n\r");
+	}
+}
+
+static void cmd_advance(uint8_t argc, char *argv[]){
+	uint32_t ms;
+
+	(void)argc;
+	if (!parse_u32(argv[1], &ms)){
+		printf("advance: numero invalido\n\r");
+		return;
+	}
+	ops->advance(ms);
+}
+
+static void cmd_redraw(uint8_t argc, char *argv[]){
+	(void)argc;
+	(void)argv;
+	ops->redraw();
+}
+
+static void cmd_stats(uint8_t argc, char *argv[]){
+	(void)argc;
+	(void)argv;
+	ops->stats();
+}
+
+static void cmd_bench(uint8_t argc, char *argv[]){
+	(void)argc;
+	(void)argv;
+	if (ops->bench == NULL){
+		printf("bench: nao disponivel\n\r");
+		return;
+	}
+	ops->bench();
+}
+
+//ZONAS DO prof.h; "prof reset" ZERA DEPOIS DE IMPRIMIR
+static void cmd_prof(uint8_t argc, char *argv[]){
+	prof_dump();
+	if (argc > 1 && strcmp(argv[1], "reset") == 0){
+		prof_reset();
+	}
+}
+
+//SEM ARGUMENTOS LISTA; "feature nome on|off" MUDA O BIT
+static void cmd_feature(uint8_t argc, char *argv[]){
+	if (argc == 1){
+		for (uint8_t i = 0; i < ops->feature_count; i++){
+			printf("%-12s %s\n\r", ops->features[i], (*ops->feature_flags >> i) & 1 ? "on" : "off");
+		}
+		return;
+	}
+	for (uint8_t i = 0; i < ops->feature_count; i++){
+		if (strcmp(argv[1], ops->features[i]) != 0){
+			continue;
+		}
+		if (argc > 2 && strcmp(argv[2], "on") == 0){
+			*ops->feature_flags |= 1u << i;
+		}
+		else if (argc > 2 && strcmp(argv[2], "off") == 0){
+			*ops->feature_flags &= ~(1u << i);
+		}
+		else {
+			*ops->feature_flags ^= 1u << i;
+		}
+		printf("%s %s\n\r", argv[1], (*ops->feature_flags >> i) & 1 ? "on" : "off");
+		return;
+	}
+	printf("feature: %s desconhecido\n\r", argv[1]);
+}
+
+static const console_cmd commands[] = {
+	{"touch",   "x y [ms]",         2, cmd_touch},
+	{"cycle",   "id",               1, cmd_cycle},
+	{"advance", "ms",               1, cmd_advance},
+	{"redraw",  "",                 0, cmd_redraw},
+	{"stats",   "",                 0, cmd_stats},
+	{"prof",    "[reset]",          0, cmd_prof},
+	{"bench",   "",                 0, cmd_bench},
+	{"feature", "[nome [on|off]]",  0, cmd_feature},
+	{"help",    "",                 0, cmd_help},
+};
+#define COMMANDS_SIZE (sizeof(commands) / sizeof(commands[0]))
+
+static void cmd_help(uint8_t argc, char *argv[]){
+	(void)argc;
+	(void)argv;
+	for (uint8_t i = 0; i < COMMANDS_SIZE; i++){
+		printf("%s%s%s\n\r", commands[i].name, commands[i].usage[0] ? " " : "", commands[i].usage);
+	}
+}
+
+void console_init(const console_ops *o){
+	ops = o;
+	line_len = 0;
+	overflow = false;
+}
+
+//QUEBRA A LINHA EM PALAVRAS (NO PROPRIO BUFFER) E CHAMA O COMANDO
+void console_exec(char *s){
+	char *argv[CONSOLE_ARGS_MAX + 1];
+	uint8_t argc = 0;
+
+	for (char *tok = strtok(s, " \t"); tok && argc <= CONSOLE_ARGS_MAX; tok = strtok(NULL, " \t")){
+		argv[argc++] = tok;
+	}
+	if (argc == 0){
+		return;
+	}
+	for (uint8_t i = 0; i < COMMANDS_SIZE; i++){
+		if (strcmp(argv[0], commands[i].name) == 0){
+			if (argc - 1 < commands[i].min_args || argc > CONSOLE_ARGS_MAX){
+				printf("uso: %s %s\n\r", commands[i].name, commands[i].usage);
+			} else {
+				commands[i].run(argc, argv);
+			}
+			return;
+		}
+	}
+	printf("%s: comando desconhecido (help)\n\r", argv[0]);
+}
+
+void console_feed(char c){
+	if (c == '\r' || c == '\n'){
+		if (!overflow){
+			line[line_len] = '\0';
+			console_exec(line);
+		}
+		line_len = 0;
+		overflow = false;
+	}
+	else if (line_len < CONSOLE_LINE_MAX - 1){
+		line[line_len++] = c;
+	}
+	else {
+		overflow = true;
+	}
+}
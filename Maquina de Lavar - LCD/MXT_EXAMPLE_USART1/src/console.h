@@ -0,0 +1,40 @@
+/*
+ * console.h
+ *
+ * Console de linha para bancada: comandos de texto pela serial (ou pelo
+ * stdin no host) que injetam toques, escolhem o ciclo, adiantam o relogio,
+ * forcam o redesenho, despejam os contadores (e as zonas do prof.h), rodam
+ * o benchmark do tcm.h e ligam/desligam recursos do desenho. O console so
+ * interpreta; cada acao e um ponteiro do
+ * console_ops, entao o main.c liga no hardware e o sim/console_sim.c no
+ * host com a mesma tabela de comandos. console_feed() roda no main, so
+ * quando chegou uma linha inteira: parado, nao custa nada por quadro.
+ */
+
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CONSOLE_LINE_MAX  64
+#define CONSOLE_ARGS_MAX  4
+
+typedef struct {
+	void (*touch)(uint16_t x, uint16_t y, uint32_t hold_ms);
+	bool (*cycle)(uint8_t id);               // false: ciclo invalido ou lavando
+	void (*advance)(uint32_t ms);
+	void (*redraw)(void);
+	void (*stats)(void);
+	void (*bench)(void);                     // NULL: sem benchmark (host, CONF_TCM_BENCH 0)
+	const char *const *features;             // nome de cada bit de *feature_flags
+	uint8_t feature_count;
+	uint32_t *feature_flags;
+} console_ops;
+
+void console_init(const console_ops *ops);
+void console_feed(char c);
+void console_exec(char *line);
+
+#endif /* CONSOLE_H_ */
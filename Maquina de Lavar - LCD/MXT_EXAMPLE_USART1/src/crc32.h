@@ -0,0 +1,24 @@
+/*
+ * crc32.h
+ *
+ * CRC-32 (IEEE 802.3, o mesmo do zlib) com tabela de 16 entradas: pouco
+ * flash e um laco por nibble. crc32_update() continua um CRC ja iniciado,
+ * para calcular sobre pedacos sem juntar num buffer.
+ */
+
+
+#ifndef CRC32_H_
+#define CRC32_H_
+
+#include <stdint.h>
+
+#define CRC32_INIT  0xFFFFFFFFu
+
+uint32_t crc32_update(uint32_t crc, const void *data, uint32_t len);
+
+//CRC COMPLETO DE UM BLOCO
+static inline uint32_t crc32(const void *data, uint32_t len){
+	return ~crc32_update(CRC32_INIT, data, len);
+}
+
+#endif /* CRC32_H_ */
@@ -0,0 +1,136 @@
+/*
+ * cycle_table.c
+ *
+ * GERADO por sim/gen_cycle_table.c a partir de ciclos.def; nao editar.
+ * Fases: {tipo, enxague, rpm, inicio_ms, duracao_ms}.
+ */
+
+#include "cycle_table.h"
+
+const cycle_entry cycle_table[CYCLE_COUNT] = {
+	[CYCLE_RAPIDO] = {
+		.ciclo = {.nome = "Rapido", .enxagueTempo = 5, .enxagueQnt = 3, .centrifugacaoRPM = 900,
+				.centrifugacaoTempo = 5, .heavy = 0, .bubblesOn = 1},
+		.program = {
+			.phases = {
+				{WASH_PHASE_FILL, 0, 0, 0, 60000},
+				{WASH_PHASE_WASH, 0, 0, 60000, 300000},
+				{WASH_PHASE_RINSE, 1, 0, 360000, 300000},
+				{WASH_PHASE_RINSE, 2, 0, 660000, 300000},
+				{WASH_PHASE_RINSE, 3, 0, 960000, 300000},
+				{WASH_PHASE_SPIN_RAMP, 0, 900, 1260000, 30000},
+				{WASH_PHASE_SPIN, 0, 900, 1290000, 300000},
+				{WASH_PHASE_DONE, 0, 0, 1590000, 0},
+			},
+			.count = 8,
+			.total_ms = 1590000
+		},
+		.total_ms = 1590000,
+		.heavy_ms = 1830000,
+		.labels = {
+			{"Rapido", 75},
+			{"5 minutos", 106},
+			{"3 enxagues", 118},
+			{"900 RPM", 93},
+			{"5 minutos", 106},
+		}
+	},
+	[CYCLE_CENTRIFUGA] = {
+		.ciclo = {.nome = "Centrifuga", .enxagueTempo = 0, .enxagueQnt = 0, .centrifugacaoRPM = 1200,
+				.centrifugacaoTempo = 10, .heavy = 0, .bubblesOn = 0},
+		.program = {
+			.phases = {
+				{WASH_PHASE_SPIN_RAMP, 0, 1200, 0, 30000},
+				{WASH_PHASE_SPIN, 0, 1200, 30000, 600000},
+				{WASH_PHASE_DONE, 0, 0, 630000, 0},
+			},
+			.count = 3,
+			.total_ms = 630000
+		},
+		.total_ms = 630000,
+		.heavy_ms = 630000,
+		.labels = {
+			{"Centrifuga", 112},
+			{"0 minutos", 106},
+			{"0 enxagues", 118},
+			{"1200 RPM", 106},
+			{"10 minutos", 119},
+		}
+	},
+	[CYCLE_PESADO] = {
+		.ciclo = {.nome = "Pesado", .enxagueTempo = 10, .enxagueQnt = 3, .centrifugacaoRPM = 1200,
+				.centrifugacaoTempo = 10, .heavy = 1, .bubblesOn = 1},
+		.program = {
+			.phases = {
+				{WASH_PHASE_FILL, 0, 0, 0, 60000},
+				{WASH_PHASE_WASH, 0, 0, 60000, 720000},
+				{WASH_PHASE_RINSE, 1, 0, 780000, 720000},
+				{WASH_PHASE_RINSE, 2, 0, 1500000, 720000},
+				{WASH_PHASE_RINSE, 3, 0, 2220000, 720000},
+				{WASH_PHASE_SPIN_RAMP, 0, 1200, 2940000, 30000},
+				{WASH_PHASE_SPIN, 0, 1200, 2970000, 600000},
+				{WASH_PHASE_DONE, 0, 0, 3570000, 0},
+			},
+			.count = 8,
+			.total_ms = 3570000
+		},
+		.total_ms = 3570000,
+		.heavy_ms = 3570000,
+		.labels = {
+			{"Pesado", 76},
+			{"10 minutos", 119},
+			{"3 enxagues", 118},
+			{"1200 RPM", 106},
+			{"10 minutos", 119},
+		}
+	},
+	[CYCLE_ENXAGUE] = {
+		.ciclo = {.nome = "Enxague", .enxagueTempo = 10, .enxagueQnt = 1, .centrifugacaoRPM = 0,
+				.centrifugacaoTempo = 0, .heavy = 0, .bubblesOn = 0},
+		.program = {
+			.phases = {
+				{WASH_PHASE_FILL, 0, 0, 0, 60000},
+				{WASH_PHASE_WASH, 0, 0, 60000, 600000},
+				{WASH_PHASE_RINSE, 1, 0, 660000, 600000},
+				{WASH_PHASE_DONE, 0, 0, 1260000, 0},
+			},
+			.count = 4,
+			.total_ms = 1260000
+		},
+		.total_ms = 1260000,
+		.heavy_ms = 1500000,
+		.labels = {
+			{"Enxague", 89},
+			{"10 minutos", 119},
+			{"1 enxagues", 118},
+			{"0 RPM", 67},
+			{"0 minutos", 106},
+		}
+	},
+	[CYCLE_DIARIO] = {
+		.ciclo = {.nome = "Diario", .enxagueTempo = 15, .enxagueQnt = 2, .centrifugacaoRPM = 1200,
+				.centrifugacaoTempo = 8, .heavy = 0, .bubblesOn = 1},
+		.program = {
+			.phases = {
+				{WASH_PHASE_FILL, 0, 0, 0, 60000},
+				{WASH_PHASE_WASH, 0, 0, 60000, 900000},
+				{WASH_PHASE_RINSE, 1, 0, 960000, 900000},
+				{WASH_PHASE_RINSE, 2, 0, 1860000, 900000},
+				{WASH_PHASE_SPIN_RAMP, 0, 1200, 2760000, 30000},
+				{WASH_PHASE_SPIN, 0, 1200, 2790000, 480000},
+				{WASH_PHASE_DONE, 0, 0, 3270000, 0},
+			},
+			.count = 7,
+			.total_ms = 3270000
+		},
+		.total_ms = 3270000,
+		.heavy_ms = 3810000,
+		.labels = {
+			{"Diario", 65},
+			{"15 minutos", 119},
+			{"2 enxagues", 118},
+			{"1200 RPM", 106},
+			{"8 minutos", 106},
+		}
+	},
+};
@@ -0,0 +1,53 @@
+/*
+ * cycle_table.h
+ *
+ * Tabela const dos ciclos (em flash), gerada de ciclos.def antes do build:
+ * alem do t_ciclo, cada entrada traz o programa de fases ja compilado, a
+ * duracao total, a duracao com o modo pesado e os textos da tela ja
+ * formatados com a largura em pixels na calibri_24. Escolher um ciclo e so
+ * indexar a tabela, sem sprintf nem conta.
+ */
+
+
+#ifndef CYCLE_TABLE_H_
+#define CYCLE_TABLE_H_
+
+#include <stdint.h>
+#include "ciclo.h"
+#include "wash_program.h"
+
+enum {
+#define CICLO(id, nome, enxT, enxQ, rpm, centT, heavy, bubbles) CYCLE_##id,
+#include "ciclos.def"
+#undef CICLO
+	CYCLE_COUNT
+};
+
+//LINHAS DO TEXTO DO CICLO NA TELA (labels em screens.c)
+enum {
+	CYCLE_LABEL_NAME,
+	CYCLE_LABEL_RINSE_TIME,
+	CYCLE_LABEL_RINSES,
+	CYCLE_LABEL_RPM,
+	CYCLE_LABEL_SPIN_TIME,
+	CYCLE_LABELS
+};
+
+typedef struct {
+	const char *text;
+	uint16_t width;          // pixels na calibri_24 com espacamento SPACE
+} cycle_label;
+
+typedef struct {
+	t_ciclo ciclo;
+	wash_program program;    // fases do ciclo como definido
+	uint32_t total_ms;       // == program.total_ms
+	uint32_t heavy_ms;       // total se o modo pesado estiver ligado
+	cycle_label labels[CYCLE_LABELS];
+} cycle_entry;
+
+#define CYCLE_LABEL_HEIGHT  24   // altura dos glifos da calibri_24
+
+extern const cycle_entry cycle_table[CYCLE_COUNT];
+
+#endif /* CYCLE_TABLE_H_ */
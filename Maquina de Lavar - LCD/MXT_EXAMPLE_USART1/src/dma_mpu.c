@@ -0,0 +1,73 @@
+/*
+ * dma_mpu.c
+ *
+ * Back end de hardware do dma_pool: a regiao "nocache" do flash.ld vira
+ * Normal nao cacheavel (TEX 001, C 0, B 0) e sem execucao pelo MPU, numa
+ * regiao de numero alto para ganhar de qualquer outra que a cubra. O resto
+ * do mapa continua o padrao (PRIVDEFENA), que e o que vale com o MPU
+ * desligado. A manutencao do D-cache e por endereco, uma linha por
+ * escrita no SCB, entre DSBs.
+ */
+
+#include <asf.h>
+#include "dma_pool.h"
+
+//O MPU_NOCACHE_SRAM_REGION DO mpu.h SO EXISTE COM O MPU_HAS_NOCACHE_REGION,
+//QUE VEM DOS SIMBOLOS DO .cproj PARA TODO ARQUIVO VER O MESMO mpu.h. A
+//REGIAO EM SI VEM DO flash.ld E NAO DO SRAM_NOCACHE_* DELE (O init.c SO A
+//USA COM CONF_BOARD_CONFIG_MPU_AT_INIT, QUE ESTE PROJETO NAO LIGA)
+#ifndef MPU_HAS_NOCACHE_REGION
+#error "MPU_HAS_NOCACHE_REGION tem que vir dos simbolos do projeto"
+#endif
+
+extern char _snocache, _nocache_size;
+
+//A SECAO .nocache TODA, NAO SO OS POOLS: O MPU PEDE TAMANHO POTENCIA DE 2
+void dma_region_setup(uintptr_t start, uint32_t size){
+	uintptr_t base = (uintptr_t)&_snocache;
+	uint32_t region = (uint32_t)(uintptr_t)&_nocache_size;
+
+	Assert(start >= base && start + size <= base + region);
+	Assert((region & (region - 1)) == 0 && (base & (region - 1)) == 0);
+
+	//NADA DA REGIAO PODE FICAR NO CACHE QUANDO ELA DEIXAR DE SER CACHEAVEL
+	dma_cache_flush(base, base + region);
+	mpu_update_regions(MPU_NOCACHE_SRAM_REGION,
+			base | MPU_REGION_VALID | MPU_NOCACHE_SRAM_REGION,
+			MPU_AP_FULL_ACCESS |
+			MPU_REGION_EXECUTE_NEVER |
+			INNER_OUTER_NORMAL_NOCACHE_TYPE( SHAREABLE ) |
+			mpu_cal_mpu_region_size(region) |
+			MPU_REGION_ENABLE);
+	mpu_enable(MPU_ENABLE | MPU_PRIVDEFENA);
+	__DSB();
+	__ISB();
+}
+
+void dma_cache_clean(uintptr_t start, uintptr_t end){
+	__DSB();
+	for (; start < end; start += DMA_LINE){
+		SCB->DCCMVAC = start;
+	}
+	__DSB();
+	__ISB();
+}
+
+//NO core_cm7.h DESTE ASF O DCIMVAC (0x25C) SE CHAMA DCIMVAU
+void dma_cache_invalidate(uintptr_t start, uintptr_t end){
+	__DSB();
+	for (; start < end; start += DMA_LINE){
+		SCB->DCIMVAU = start;
+	}
+	__DSB();
+	__ISB();
+}
+
+void dma_cache_flush(uintptr_t start, uintptr_t end){
+	__DSB();
+	for (; start < end; start += DMA_LINE){
+		SCB->DCCIMVAC = start;
+	}
+	__DSB();
+	__ISB();
+}
@@ -0,0 +1,185 @@
+/*
+ * dma_pool.c
+ *
+ * As areas dos pools NOCACHE ficam todas numa struct so, para a regiao
+ * sem cache ser um intervalo contiguo; as dos CACHED sao arrays soltos
+ * alinhados a linha. Bit em 1 no bitmap = bloco livre, e o proximo livre
+ * sai do __builtin_ctz(). Alocar e liberar seguram a interrupcao: o fim de
+ * um DMA pode liberar o buffer no handler. Com o dma_pools.def vazio a
+ * struct e as tabelas ficam com tamanho 0 (extensao do GCC) e so sobra o
+ * back end de cache, que o flash_efc.c usa.
+ */
+
+#include <stddef.h>
+#include "dma_pool.h"
+
+#ifdef HOST_BUILD
+#define NOCACHE_BSS     __attribute__((aligned(DMA_LINE)))
+#define lock()          0
+#define unlock(flags)   (void)(flags)
+#else
+#include <compiler.h>
+#include <interrupt.h>
+#define NOCACHE_BSS     __attribute__((section(".nocache"), aligned(DMA_LINE)))
+#define lock()          cpu_irq_save()
+#define unlock(flags)   cpu_irq_restore(flags)
+#endif
+
+#define NOCACHE_AREA_NOCACHE(id, bytes, count)  uint8_t id[DMA_BLOCK(bytes) * (count)];
+#define NOCACHE_AREA_CACHED(id, bytes, count)
+#define CACHED_AREA_NOCACHE(id, bytes, count)
+#define CACHED_AREA_CACHED(id, bytes, count) \
+	static uint8_t id##_area[DMA_BLOCK(bytes) * (count)] __attribute__((aligned(DMA_LINE)));
+#define AREA_NOCACHE(id)    nocache.id
+#define AREA_CACHED(id)     id##_area
+#define IS_CACHED_NOCACHE   false
+#define IS_CACHED_CACHED    true
+
+static struct {
+#define DMA_POOL(id, bytes, count, kind) NOCACHE_AREA_##kind(id, bytes, count)
+#include DMA_POOLS_DEF
+#undef DMA_POOL
+} nocache NOCACHE_BSS;
+
+#define DMA_POOL(id, bytes, count, kind) CACHED_AREA_##kind(id, bytes, count)
+#include DMA_POOLS_DEF
+#undef DMA_POOL
+
+#define DMA_POOL(id, bytes, count, kind) \
+	_Static_assert((count) > 0 && (count) <= 32, "dma_pools.def: " #id " com mais de 32 blocos");
+#include DMA_POOLS_DEF
+#undef DMA_POOL
+
+typedef struct {
+	const char *name;
+	uint8_t *area;
+	uint16_t block;
+	uint8_t count;
+	bool cached;
+} dma_pool_desc;
+
+static const dma_pool_desc pools[DMA_POOLS] = {
+#define DMA_POOL(id, bytes, count, kind) {#id, AREA_##kind(id), DMA_BLOCK(bytes), (count), IS_CACHED_##kind},
+#include DMA_POOLS_DEF
+#undef DMA_POOL
+};
+
+typedef struct {
+	uint32_t free;          // bit i = bloco i livre
+	uint8_t used;
+	uint8_t high_water;
+	uint32_t failures;
+	uint32_t bad_frees;
+} dma_pool_state;
+
+static dma_pool_state state[DMA_POOLS];
+
+static inline uint32_t all_blocks(uint8_t count){
+	return count == 32 ? 0xFFFFFFFFu : (1u << count) - 1;
+}
+
+void dma_pool_init(void){
+	for (uint8_t i = 0; i < DMA_POOLS; i++){
+		state[i] = (dma_pool_state){all_blocks(pools[i].count), 0, 0, 0, 0};
+	}
+	dma_region_setup((uintptr_t)&nocache, sizeof(nocache));
+}
+
+void *dma_alloc(dma_pool_id id){
+	const dma_pool_desc *p = &pools[id];
+	dma_pool_state *s = &state[id];
+	uint32_t flags = lock();
+
+	if (s->free == 0){
+		s->failures++;
+		unlock(flags);
+		return NULL;
+	}
+	uint8_t i = __builtin_ctz(s->free);
+	s->free &= ~(1u << i);
+	if (++s->used > s->high_water){
+		s->high_water = s->used;
+	}
+	unlock(flags);
+	return p->area + (uint32_t)i * p->block;
+}
+
+//SO ACEITA O INICIO DE UM BLOCO OCUPADO DO PROPRIO POOL
+void dma_free(dma_pool_id id, void *buf){
+	const dma_pool_desc *p = &pools[id];
+	dma_pool_state *s = &state[id];
+	uintptr_t offset = (uintptr_t)buf - (uintptr_t)p->area;
+	uint32_t i = offset / p->block;
+	uint32_t flags = lock();
+
+	if (buf == NULL || (uintptr_t)buf < (uintptr_t)p->area || i >= p->count || offset % p->block != 0
+			|| (s->free & (1u << i))){
+		s->bad_frees++;
+		unlock(flags);
+		return;
+	}
+	s->free |= 1u << i;
+	s->used--;
+	unlock(flags);
+}
+
+bool dma_is_cached(const void *buf){
+	uintptr_t a = (uintptr_t)buf;
+	return a < (uintptr_t)&nocache || a >= (uintptr_t)&nocache + sizeof(nocache);
+}
+
+//ANTES DO DMA LER: O QUE A CPU ESCREVEU SAI DO CACHE PARA A SRAM
+void dma_clean(const void *buf, uint32_t len){
+	uintptr_t start = (uintptr_t)buf & ~(uintptr_t)(DMA_LINE - 1);
+	uintptr_t end = DMA_BLOCK((uintptr_t)buf + len);
+
+	if (len == 0 || !dma_is_cached(buf)){
+		return;
+	}
+	dma_cache_clean(start, end);
+}
+
+//DEPOIS DO DMA ESCREVER: A CPU PARA DE VER AS LINHAS VELHAS DO CACHE. UMA
+//PONTA FORA DE LINHA E DIVIDIDA COM OUTRO DADO, QUE PODE ESTAR SUJO NO
+//CACHE: ESSA LINHA E LIMPA ANTES DE INVALIDAR (BLOCO DO dma_alloc() NAO TEM)
+void dma_invalidate(void *buf, uint32_t len){
+	uintptr_t first = (uintptr_t)buf;
+	uintptr_t last = first + len;
+	uintptr_t start = DMA_BLOCK(first);
+	uintptr_t end = last & ~(uintptr_t)(DMA_LINE - 1);
+
+	if (len == 0 || !dma_is_cached(buf)){
+		return;
+	}
+	if (start > end){
+		//CABE NUMA LINHA SO, SEM ALINHAR NAS DUAS PONTAS
+		dma_cache_flush(first & ~(uintptr_t)(DMA_LINE - 1), DMA_BLOCK(last));
+		return;
+	}
+	if (first < start){
+		dma_cache_flush(start - DMA_LINE, start);
+	}
+	if (start < end){
+		dma_cache_invalidate(start, end);
+	}
+	if (last > end){
+		dma_cache_flush(end, end + DMA_LINE);
+	}
+}
+
+void dma_get_stats(dma_pool_id id, dma_pool_stats *stats){
+	const dma_pool_desc *p = &pools[id];
+	const dma_pool_state *s = &state[id];
+
+	stats->block = p->block;
+	stats->count = p->count;
+	stats->used = s->used;
+	stats->high_water = s->high_water;
+	stats->cached = p->cached;
+	stats->failures = s->failures;
+	stats->bad_frees = s->bad_frees;
+}
+
+const char *dma_pool_name(dma_pool_id id){
+	return id < DMA_POOLS ? pools[id].name : "?";
+}
@@ -0,0 +1,60 @@
+/*
+ * dma_pool.h
+ *
+ * Buffers de DMA com o D-cache ligado (CONF_BOARD_ENABLE_CACHE). Cada pool
+ * do dma_pools.def tem blocos de tamanho fixo marcados num bitmap, entao
+ * dma_alloc() e dma_free() sao O(1) e nao fragmentam. Os pools NOCACHE
+ * ficam na secao .nocache, que dma_pool_init() torna nao cacheavel pelo
+ * MPU; os CACHED precisam de dma_clean()/dma_invalidate() em volta do DMA.
+ * O back end (dma_mpu.c no alvo, sim/cache_sim.c no host com um modelo do
+ * cache) so configura a regiao e faz a manutencao por linha.
+ */
+
+
+#ifndef DMA_POOL_H_
+#define DMA_POOL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//A LISTA DE POOLS; O sim/dma_sim.c TROCA PELA DELE
+#ifndef DMA_POOLS_DEF
+#define DMA_POOLS_DEF   "dma_pools.def"
+#endif
+
+#define DMA_LINE        32   // linha do D-cache do Cortex-M7
+#define DMA_BLOCK(n)    (((n) + DMA_LINE - 1) & ~(DMA_LINE - 1))
+
+typedef enum {
+#define DMA_POOL(id, bytes, count, kind) DMA_##id,
+#include DMA_POOLS_DEF
+#undef DMA_POOL
+	DMA_POOLS
+} dma_pool_id;
+
+typedef struct {
+	uint16_t block;         // bytes, ja arredondado para DMA_LINE
+	uint8_t count;
+	uint8_t used;
+	uint8_t high_water;
+	bool cached;
+	uint32_t failures;      // dma_alloc() com o pool vazio
+	uint32_t bad_frees;     // ponteiro de fora do pool ou bloco ja livre
+} dma_pool_stats;
+
+void dma_pool_init(void);
+void *dma_alloc(dma_pool_id id);
+void dma_free(dma_pool_id id, void *buf);
+bool dma_is_cached(const void *buf);
+void dma_clean(const void *buf, uint32_t len);
+void dma_invalidate(void *buf, uint32_t len);
+void dma_get_stats(dma_pool_id id, dma_pool_stats *stats);
+const char *dma_pool_name(dma_pool_id id);
+
+//BACK END: [start, end) SEMPRE ALINHADO A DMA_LINE
+void dma_region_setup(uintptr_t start, uint32_t size);
+void dma_cache_clean(uintptr_t start, uintptr_t end);
+void dma_cache_invalidate(uintptr_t start, uintptr_t end);
+void dma_cache_flush(uintptr_t start, uintptr_t end);   // limpa e invalida
+
+#endif /* DMA_POOL_H_ */
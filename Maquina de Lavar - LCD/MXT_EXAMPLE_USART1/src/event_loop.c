@@ -0,0 +1,121 @@
+/*
+ * event_loop.c
+ *
+ * O WFI e feito com as interrupcoes mascaradas (PRIMASK): uma interrupcao
+ * pendente ainda acorda o core, e so roda quando o loop libera a mascara,
+ * entao nao existe janela entre testar as filas e dormir.
+ */
+
+#include "event_loop.h"
+
+#ifdef HOST_BUILD
+void (*event_loop_sim_idle)(void);
+uint32_t event_loop_sim_cycles;
+
+static inline uint32_t cycles_now(void){
+	return event_loop_sim_cycles;
+}
+
+static inline void irq_disable(void){
+}
+
+static inline void irq_enable(void){
+}
+
+static void cpu_sleep(void){
+	if (event_loop_sim_idle){
+		event_loop_sim_idle();
+	}
+}
+#else
+#include <compiler.h>
+#include <interrupt.h>
+#include "prof.h"
+
+static inline uint32_t cycles_now(void){
+	return prof_ticks();
+}
+
+static inline void irq_disable(void){
+	cpu_irq_disable();
+}
+
+static inline void irq_enable(void){
+	cpu_irq_enable();
+}
+
+//SLEEP MODE NORMAL (SLEEPDEEP = 0): QUALQUER INTERRUPCAO ACORDA
+static void cpu_sleep(void){
+	__DSB();
+	__WFI();
+}
+#endif
+
+static event_queue *const *sources;
+static uint8_t sources_size;
+static uint32_t (*wall_clock)(void);
+static uint32_t cpu_hz;
+static uint32_t wake_stamp;
+static uint32_t wall_start;
+static event_loop_stats stats;
+
+void event_loop_init(uint32_t hz, uint32_t (*wall_ms)(void),
+		event_queue *const queues[], uint8_t n){
+	cpu_hz = hz;
+	wall_clock = wall_ms;
+	sources = queues;
+	sources_size = n;
+	event_loop_reset_stats();
+}
+
+static bool has_event(void){
+	for (uint8_t i = 0; i < sources_size; i++){
+		if (!event_queue_empty(sources[i])){
+			return true;
+		}
+	}
+	return false;
+}
+
+//DORME ATE ALGUMA FILA TER EVENTO; O MAIN ESVAZIA AS FILAS DEPOIS. A DIFERENCA
+//DE 32 BITS DE UMA VOLTA ACORDADA SOBREVIVE A VOLTA DO CYCCNT; O TOTAL E DE 64
+void event_wait(void){
+	stats.busy_cycles += cycles_now() - wake_stamp;
+
+	irq_disable();
+	while (!has_event()){
+		cpu_sleep();
+		stats.wakeups++;
+		irq_enable();
+		irq_disable();
+	}
+	irq_enable();
+
+	wake_stamp = cycles_now();
+	stats.dispatches++;
+}
+
+void event_loop_get_stats(event_loop_stats *out){
+	*out = stats;
+	out->wall_ms = wall_clock ? wall_clock() - wall_start : 0;
+}
+
+//CARGA DA CPU EM POR MIL DESDE O ULTIMO RESET
+uint32_t event_loop_load_permille(void){
+	event_loop_stats s;
+
+	event_loop_get_stats(&s);
+	if (s.wall_ms == 0 || cpu_hz < 1000){
+		return 0;
+	}
+	uint64_t wall_cycles = (uint64_t)s.wall_ms * (cpu_hz / 1000);
+	return (uint32_t)(s.busy_cycles * 1000 / wall_cycles);
+}
+
+void event_loop_reset_stats(void){
+	stats.wakeups = 0;
+	stats.dispatches = 0;
+	stats.busy_cycles = 0;
+	wake_stamp = cycles_now();
+	wall_start = wall_clock ? wall_clock() : 0;
+}
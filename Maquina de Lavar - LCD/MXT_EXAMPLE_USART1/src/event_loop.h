@@ -0,0 +1,39 @@
+/*
+ * event_loop.h
+ *
+ * Loop de eventos do main: as interrupcoes so postam nas suas filas
+ * (event_queue.h) e o main dorme em WFI ate alguma fila ter evento. Tambem
+ * mede a carga da CPU
+ * (ciclos acordado / tempo de parede) e conta os wakeups.
+ * No host (HOST_BUILD) o WFI vira um hook que avanca o tempo simulado.
+ */
+
+
+#ifndef EVENT_LOOP_H_
+#define EVENT_LOOP_H_
+
+#include <stdint.h>
+#include "event_queue.h"
+
+typedef struct {
+	uint32_t wakeups;      // saidas do WFI
+	uint32_t dispatches;   // voltas do loop com evento
+	uint64_t busy_cycles;  // ciclos de CPU fora do WFI (32 bits voltam em ~14 s a 300 MHz)
+	uint32_t wall_ms;      // tempo de parede desde o reset das estatisticas
+} event_loop_stats;
+
+void event_loop_init(uint32_t cpu_hz, uint32_t (*wall_ms)(void),
+		event_queue *const queues[], uint8_t n);
+void event_wait(void);
+void event_loop_get_stats(event_loop_stats *stats);
+uint32_t event_loop_load_permille(void);
+void event_loop_reset_stats(void);
+
+#ifdef HOST_BUILD
+//CHAMADO NO LUGAR DO WFI; DEVE AVANCAR O TEMPO E POSTAR O PROXIMO EVENTO
+extern void (*event_loop_sim_idle)(void);
+//O CYCCNT DO HOST: SO ANDA QUANDO O SIM MANDA
+extern uint32_t event_loop_sim_cycles;
+#endif
+
+#endif /* EVENT_LOOP_H_ */
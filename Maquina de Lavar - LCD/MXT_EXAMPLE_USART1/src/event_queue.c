@@ -0,0 +1,80 @@
+/*
+ * event_queue.c
+ *
+ * O produtor grava o evento e so depois publica o head; o consumidor copia o
+ * evento e so depois libera o slot no tail. A barreira entre os dois passos
+ * garante a ordem das escritas vista pelo outro lado. A capacidade util e
+ * size - 1: um slot fica vazio para distinguir cheia de vazia.
+ */
+
+#include <stdio.h>
+#include "event_queue.h"
+
+#ifdef HOST_BUILD
+#define barrier()   __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#include <compiler.h>   // barrier() = __DMB()
+#endif
+
+//CHAMADO SO PELA INTERRUPCAO DONA DA FILA
+bool event_queue_post(event_queue *q, uint8_t type, uint8_t arg, uint32_t stamp){
+	uint8_t head = q->head;
+	uint8_t next = (head + 1) & q->mask;
+
+	if (next == q->tail){
+		q->dropped++;
+		return false;
+	}
+
+	event *ev = &q->buf[head];
+	ev->type = type;
+	ev->arg = arg;
+	ev->stamp = stamp;
+	barrier();
+	q->head = next;
+	q->posted++;
+
+	uint8_t depth = (next - q->tail) & q->mask;
+	if (depth > q->high_water){
+		q->high_water = depth;
+	}
+	return true;
+}
+
+//CHAMADO SO PELO MAIN
+bool event_queue_get(event_queue *q, event *ev){
+	uint8_t tail = q->tail;
+
+	if (tail == q->head){
+		return false;
+	}
+	barrier();
+	*ev = q->buf[tail];
+	barrier();
+	q->tail = (tail + 1) & q->mask;
+	return true;
+}
+
+bool event_queue_empty(const event_queue *q){
+	return q->head == q->tail;
+}
+
+void event_queue_get_stats(const event_queue *q, event_queue_stats *stats){
+	stats->depth = (q->head - q->tail) & q->mask;
+	stats->capacity = q->mask;
+	stats->high_water = q->high_water;
+	stats->posted = q->posted;
+	stats->dropped = q->dropped;
+}
+
+//IMPRIME PROFUNDIDADE E DESCARTES DE CADA FILA
+void event_queue_dump(event_queue *const queues[], uint8_t n){
+	event_queue_stats st;
+
+	for (uint8_t i = 0; i < n; i++){
+		event_queue_get_stats(queues[i], &st);
+		printf("%-10s %u/%u max %u, %lu eventos, %lu descartados\n\r", queues[i]->name,
+				st.depth, st.capacity, st.high_water,
+				(unsigned long)st.posted, (unsigned long)st.dropped);
+	}
+}
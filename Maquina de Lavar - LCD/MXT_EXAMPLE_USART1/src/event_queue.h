@@ -0,0 +1,61 @@
+/*
+ * event_queue.h
+ *
+ * Fila de eventos de capacidade fixa, um produtor (uma interrupcao) e um
+ * consumidor (o main). Cada lado so escreve o seu indice, entao
+ * event_queue_post() nao precisa mascarar interrupcoes. Fila cheia descarta o
+ * evento novo e conta no "dropped".
+ */
+
+
+#ifndef EVENT_QUEUE_H_
+#define EVENT_QUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tcm.h"
+
+typedef enum {
+	EV_TOUCH,       // borda de descida do CHG do maXTouch
+	EV_BUTTON,      // borda numa entrada do PIO, arg = linha da tabela (input.h)
+	EV_TIMER,       // alarme do RTT: algum prazo da timebase venceu
+	EV_CONSOLE      // chegou uma linha inteira na serial (console.h)
+} event_type;
+
+typedef struct {
+	uint8_t type;   // event_type
+	uint8_t arg;    // dado do evento, depende do tipo
+	uint32_t stamp; // ms (RTT) em que a interrupcao postou; EV_TOUCH: latency_now()
+} event;
+
+typedef struct {
+	const char *name;
+	event *buf;
+	uint8_t mask;            // capacidade - 1, capacidade potencia de 2
+	volatile uint8_t head;   // so o produtor escreve
+	volatile uint8_t tail;   // so o consumidor escreve
+	uint8_t high_water;
+	volatile uint32_t posted;
+	volatile uint32_t dropped;
+} event_queue;
+
+typedef struct {
+	uint8_t depth;
+	uint8_t capacity;
+	uint8_t high_water;
+	uint32_t posted;
+	uint32_t dropped;
+} event_queue_stats;
+
+//CRIA A FILA E O BUFFER; size TEM QUE SER POTENCIA DE 2 (ATE 128)
+#define EVENT_QUEUE_DEFINE(q, size) \
+	static event q##_buf[(size)] DTCM_BSS; \
+	event_queue q = {#q, q##_buf, (size) - 1, 0, 0, 0, 0, 0}
+
+bool event_queue_post(event_queue *q, uint8_t type, uint8_t arg, uint32_t stamp);
+bool event_queue_get(event_queue *q, event *ev);
+bool event_queue_empty(const event_queue *q);
+void event_queue_get_stats(const event_queue *q, event_queue_stats *stats);
+void event_queue_dump(event_queue *const queues[], uint8_t n);
+
+#endif /* EVENT_QUEUE_H_ */
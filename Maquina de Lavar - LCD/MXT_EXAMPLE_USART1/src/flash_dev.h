@@ -0,0 +1,43 @@
+/*
+ * flash_dev.h
+ *
+ * Regiao de flash reservada para dados do usuario (kv_store.h), vista como
+ * FLASH_DEV_SECTORS setores apagaveis de FLASH_DEV_SECTOR_SIZE bytes. Como
+ * em NOR, apagar deixa tudo em 0xFF e gravar so pode levar bits a 0. A
+ * flash do SAME70 tem ECC por palavra de 128 bits, entao cada bloco de
+ * FLASH_DEV_WRITE_ALIGN bytes e gravado uma unica vez entre apagamentos.
+ * O back end do alvo e flash_efc.c; o de host e sim/flash_file.c.
+ */
+
+
+#ifndef FLASH_DEV_H_
+#define FLASH_DEV_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FLASH_DEV_SECTOR_SIZE  8192u   // 16 paginas de 512 B (menor EPA nos setores grandes)
+#define FLASH_DEV_SECTORS      4u
+#define FLASH_DEV_SIZE         (FLASH_DEV_SECTOR_SIZE * FLASH_DEV_SECTORS)
+#define FLASH_DEV_WRITE_ALIGN  16u
+
+//offset e relativo ao inicio da regiao; write exige offset e len alinhados
+bool flash_dev_init(void);
+bool flash_dev_read(uint32_t offset, void *buf, uint32_t len);
+bool flash_dev_write(uint32_t offset, const void *data, uint32_t len);
+bool flash_dev_erase(uint8_t sector);
+
+#ifdef HOST_BUILD
+typedef struct {
+	uint32_t bytes_written;
+	uint32_t erases[FLASH_DEV_SECTORS];
+	uint32_t violations;   // bloco regravado ou bit levado de 0 a 1 sem apagar
+} flash_sim_stats;
+
+void flash_sim_set_file(const char *path);
+void flash_sim_power_cut_after(uint32_t bytes);
+void flash_sim_get_stats(flash_sim_stats *stats);
+void flash_sim_reset_stats(void);
+#endif
+
+#endif /* FLASH_DEV_H_ */
@@ -0,0 +1,97 @@
+/*
+ * flash_efc.c
+ *
+ * Back end do flash_dev sobre o EEFC do SAME70. A regiao sao os ultimos
+ * FLASH_DEV_SIZE bytes da flash interna, tirados do "rom" no flash.ld para
+ * o linker nunca colocar codigo ali. Durante um comando o EEFC nao deixa ler
+ * a flash, entao o comando roda da RAM (RAMFUNC) com as interrupcoes
+ * desligadas (os handlers e a tabela de vetores estao na flash). Depois de
+ * gravar ou apagar, as linhas da regiao saem do D-cache pelo mesmo
+ * dma_cache_invalidate() do dma_pool.
+ */
+
+#include <string.h>
+#include <compiler.h>
+#include <interrupt.h>
+#include "flash_dev.h"
+#include "dma_pool.h"
+
+#define REGION_ADDR     (IFLASH_ADDR + IFLASH_SIZE - FLASH_DEV_SIZE)
+#define PAGE_WORDS      (IFLASH_PAGE_SIZE / 4)
+#define EPA_16_PAGES    2u          // FARG[1:0] do EPA: 16 paginas
+
+static RAMFUNC __no_inline uint32_t efc_command(uint32_t cmd, uint32_t arg){
+	uint32_t status;
+
+	EFC->EEFC_FCR = EEFC_FCR_FKEY_PASSWD | EEFC_FCR_FARG(arg) | cmd;
+	do {
+		status = EFC->EEFC_FSR;
+	} while (!(status & EEFC_FSR_FRDY));
+	return status & (EEFC_FSR_FCMDE | EEFC_FSR_FLOCKE | EEFC_FSR_FLERR);
+}
+
+//A FLASH MUDOU POR BAIXO DO CACHE; AS LINHAS DELA NUNCA ESTAO SUJAS
+static void dcache_invalidate(uint32_t addr, uint32_t len){
+	dma_cache_invalidate(addr & ~(DMA_LINE - 1u), addr + len);
+}
+
+bool flash_dev_init(void){
+	return true;
+}
+
+bool flash_dev_read(uint32_t offset, void *buf, uint32_t len){
+	if (offset + len > FLASH_DEV_SIZE){
+		return false;
+	}
+	memcpy(buf, (const void *)(REGION_ADDR + offset), len);
+	return true;
+}
+
+//O LATCH VOLTA A 0xFF DEPOIS DE CADA COMANDO, ENTAO SO AS PALAVRAS DO
+//INTERVALO SAO ESCRITAS NELE; AS OUTRAS PALAVRAS DA PAGINA NAO MUDAM
+bool flash_dev_write(uint32_t offset, const void *data, uint32_t len){
+	const uint8_t *src = data;
+	uint32_t status = 0;
+
+	if (offset + len > FLASH_DEV_SIZE || (offset | len) % FLASH_DEV_WRITE_ALIGN){
+		return false;
+	}
+	while (len > 0 && status == 0){
+		uint32_t addr = REGION_ADDR + offset;
+		uint32_t in_page = IFLASH_PAGE_SIZE - (addr % IFLASH_PAGE_SIZE);
+		uint32_t n = len < in_page ? len : in_page;
+		volatile uint32_t *latch = (volatile uint32_t *)addr;
+		uint32_t word;
+
+		irqflags_t flags = cpu_irq_save();
+		for (uint32_t i = 0; i < n; i += 4){
+			memcpy(&word, src + i, 4);
+			*latch++ = word;
+		}
+		__DSB();
+		status = efc_command(EEFC_FCR_FCMD_WP, (addr - IFLASH_ADDR) / IFLASH_PAGE_SIZE);
+		cpu_irq_restore(flags);
+
+		dcache_invalidate(addr, n);
+		offset += n;
+		src += n;
+		len -= n;
+	}
+	return status == 0;
+}
+
+bool flash_dev_erase(uint8_t sector){
+	uint32_t addr = REGION_ADDR + (uint32_t)sector * FLASH_DEV_SECTOR_SIZE;
+	uint32_t page = (addr - IFLASH_ADDR) / IFLASH_PAGE_SIZE;
+	uint32_t status;
+
+	if (sector >= FLASH_DEV_SECTORS){
+		return false;
+	}
+	irqflags_t flags = cpu_irq_save();
+	status = efc_command(EEFC_FCR_FCMD_EPA, page | EPA_16_PAGES);
+	cpu_irq_restore(flags);
+
+	dcache_invalidate(addr, FLASH_DEV_SECTOR_SIZE);
+	return status == 0;
+}
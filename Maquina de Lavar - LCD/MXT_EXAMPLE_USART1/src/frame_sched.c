@@ -0,0 +1,117 @@
+/*
+ * frame_sched.c
+ *
+ * O proximo quadro pode sair no inicio do periodo seguinte ao fim do
+ * anterior, alinhado ao comeco dele: um quadro de 2,5 periodos perde 2
+ * periodos e o seguinte sai no terceiro. O tempo de cada chamada so conta
+ * entre frame_begin() e frame_end(); desenhos fora de um quadro (avisos
+ * dos handlers) nao entram.
+ */
+
+#include <string.h>
+#include "frame_sched.h"
+
+static const char *const call_names[DRAW_CALLS] = {
+#define DRAW_CALL(id, name) name,
+#include "draw_calls.def"
+#undef DRAW_CALL
+};
+
+static uint32_t period;
+static uint32_t budget;
+static uint32_t ticks_per_us = 1;
+
+static bool pending;
+static bool in_frame;
+static uint64_t next_ms;        // inicio do proximo periodo livre
+static uint64_t start_ms;
+static uint32_t start_ticks;
+static uint8_t top_call;        // mais cara do quadro em curso
+static uint32_t top_ticks;
+static frame_stats stats;
+
+void frame_init(uint32_t period_ms, uint32_t budget_us, uint32_t cpu_hz){
+#ifdef HOST_BUILD
+	(void)cpu_hz;
+	ticks_per_us = 1000;
+#else
+	ticks_per_us = cpu_hz / 1000000 ? cpu_hz / 1000000 : 1;
+#endif
+	period = period_ms ? period_ms : 1;
+	budget = budget_us;
+	pending = true;   // o primeiro quadro
+	in_frame = false;
+	next_ms = 0;
+	frame_reset();
+}
+
+void frame_request(void){
+	if (pending){
+		stats.coalesced++;
+	}
+	pending = true;
+}
+
+bool frame_pending(void){
+	return pending;
+}
+
+bool frame_ready(uint64_t now_ms){
+	return pending && now_ms >= next_ms;
+}
+
+uint64_t frame_next_ms(void){
+	return next_ms;
+}
+
+void frame_begin(uint64_t now_ms, uint32_t now_ticks){
+	pending = false;
+	in_frame = true;
+	start_ms = now_ms;
+	start_ticks = now_ticks;
+	top_call = DRAW_NONE;
+	top_ticks = 0;
+}
+
+void frame_call(uint8_t call, uint32_t start, uint32_t end){
+	if (in_frame && end - start >= top_ticks){
+		top_call = call;
+		top_ticks = end - start;
+	}
+}
+
+//true SE ESTOUROU O ORCAMENTO; O QUE ESTOUROU FICA EM frame_get_stats()
+bool frame_end(uint64_t now_ms, uint32_t now_ticks, uint32_t flush_us){
+	uint32_t us = (now_ticks - start_ticks) / ticks_per_us;
+	uint32_t periods = (uint32_t)((now_ms - start_ms) / period) + 1;
+
+	in_frame = false;
+	next_ms = start_ms + (uint64_t)periods * period;
+	stats.skipped += periods - 1;
+	stats.frames++;
+	stats.last_us = us;
+	stats.flush_us = flush_us;
+	if (us > stats.max_us){
+		stats.max_us = us;
+	}
+	if (us <= budget){
+		return false;
+	}
+	stats.overruns++;
+	stats.worst_call = top_call;
+	stats.worst_call_us = top_ticks / ticks_per_us;
+	return true;
+}
+
+void frame_get_stats(frame_stats *s){
+	*s = stats;
+}
+
+void frame_reset(void){
+	memset(&stats, 0, sizeof(stats));
+	stats.worst_call = DRAW_NONE;
+}
+
+const char *frame_call_name(uint8_t call){
+	return call < DRAW_CALLS ? call_names[call] : "-";
+}
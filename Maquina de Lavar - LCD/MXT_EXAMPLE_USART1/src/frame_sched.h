@@ -0,0 +1,60 @@
+/*
+ * frame_sched.h
+ *
+ * Quadros da interface com periodo fixo e orcamento de tempo. Quem muda o
+ * estado chama frame_request(); o loop desenha quando frame_ready() diz
+ * que o periodo chegou, e pedidos no meio viram um quadro so. Um quadro
+ * mais longo que o periodo pula os periodos que ocupou (o LCD ainda estava
+ * recebendo). frame_begin()/frame_end() medem o render, e FRAME_DRAW()
+ * em volta das chamadas de desenho (draw_calls.def) guarda a mais cara do
+ * quadro, para dizer o que estourou. So o main usa.
+ */
+
+
+#ifndef FRAME_SCHED_H_
+#define FRAME_SCHED_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "prof.h"
+
+typedef enum {
+#define DRAW_CALL(id, name) DRAW_##id,
+#include "draw_calls.def"
+#undef DRAW_CALL
+	DRAW_CALLS,
+	DRAW_NONE = 0xFF
+} draw_call;
+
+typedef struct {
+	uint32_t frames;        // quadros desenhados
+	uint32_t overruns;      // quadros acima do orcamento
+	uint32_t skipped;       // periodos perdidos por quadros longos
+	uint32_t coalesced;     // pedidos que cairam num quadro ja pendente
+	uint32_t last_us;       // render do ultimo quadro
+	uint32_t max_us;
+	uint32_t flush_us;      // tempo no fio dos bytes do ultimo quadro
+	uint8_t worst_call;     // chamada mais cara do ultimo estouro
+	uint32_t worst_call_us;
+} frame_stats;
+
+//TEMPO NO RELOGIO DO prof (CYCCNT NO ALVO, ns NO HOST)
+#define FRAME_DRAW(id, call) do { \
+		uint32_t frame_t0_ = prof_ticks(); \
+		call; \
+		frame_call(DRAW_##id, frame_t0_, prof_ticks()); \
+	} while (0)
+
+void frame_init(uint32_t period_ms, uint32_t budget_us, uint32_t cpu_hz);
+void frame_request(void);
+bool frame_pending(void);
+bool frame_ready(uint64_t now_ms);
+uint64_t frame_next_ms(void);
+void frame_begin(uint64_t now_ms, uint32_t now_ticks);
+void frame_call(uint8_t call, uint32_t start_ticks, uint32_t end_ticks);
+bool frame_end(uint64_t now_ms, uint32_t now_ticks, uint32_t flush_us);
+void frame_get_stats(frame_stats *stats);
+void frame_reset(void);
+const char *frame_call_name(uint8_t call);
+
+#endif /* FRAME_SCHED_H_ */
@@ -0,0 +1,132 @@
+/*
+ * gesture.c
+ *
+ * Maquina de estados por ID de toque. O long-press e checado em
+ * gesture_poll(); gesture_next_deadline() diz quando chamar, para o loop
+ * principal armar um timer em vez de ficar consultando.
+ */
+
+#include <stdlib.h>
+#include "gesture.h"
+#include "tcm.h"
+
+typedef struct {
+	uint8_t active;
+	uint8_t dragging;
+	uint8_t long_fired;
+	uint16_t x0;
+	uint16_t y0;
+	uint16_t x;
+	uint16_t y;
+	uint32_t t0;
+} touch_track;
+
+static gesture_config cfg;
+static gesture_handler on_gesture;
+static touch_track tracks[GESTURE_MAX_TOUCHES];
+
+static void emit(gesture_type type, uint8_t id, const touch_track *t, uint32_t now_ms){
+	gesture_event ev = {
+		.type = type,
+		.id = id,
+		.x = t->x,
+		.y = t->y,
+		.x0 = t->x0,
+		.y0 = t->y0,
+		.duration = now_ms - t->t0
+	};
+
+	if (on_gesture){
+		on_gesture(&ev);
+	}
+}
+
+void gesture_init(const gesture_config *config, gesture_handler handler){
+	cfg = *config;
+	on_gesture = handler;
+	for (int i = 0; i < GESTURE_MAX_TOUCHES; i++){
+		tracks[i].active = 0;
+	}
+}
+
+ITCM_FUNC void gesture_feed(uint8_t id, uint8_t status, uint16_t x, uint16_t y, uint32_t now_ms){
+	if (id >= GESTURE_MAX_TOUCHES){
+		return;
+	}
+	touch_track *t = &tracks[id];
+
+	//INICIO DO TOQUE
+	if ((status & GESTURE_T9_PRESS) || ((status & GESTURE_T9_DETECT) && !t->active)){
+		t->active = 1;
+		t->dragging = 0;
+		t->long_fired = 0;
+		t->x0 = t->x = x;
+		t->y0 = t->y = y;
+		t->t0 = now_ms;
+		emit(GESTURE_PRESS, id, t, now_ms);
+		return;
+	}
+
+	if (!t->active){
+		return;
+	}
+
+	t->x = x;
+	t->y = y;
+	int dx = (int)x - t->x0;
+	int dy = (int)y - t->y0;
+
+	//FIM DO TOQUE
+	if (status & GESTURE_T9_RELEASE){
+		uint32_t dt = now_ms - t->t0;
+
+		if (abs(dx) >= cfg.swipe_px && abs(dx) > 2 * abs(dy) && dt <= cfg.swipe_ms){
+			emit(dx < 0 ? GESTURE_SWIPE_LEFT : GESTURE_SWIPE_RIGHT, id, t, now_ms);
+		} else if (!t->dragging && !t->long_fired){
+			emit(GESTURE_TAP, id, t, now_ms);
+		}
+		emit(GESTURE_RELEASE, id, t, now_ms);
+		t->active = 0;
+		return;
+	}
+
+	//ARRASTO
+	if (status & GESTURE_T9_MOVE){
+		if (!t->dragging && (abs(dx) + abs(dy)) >= cfg.drag_px){
+			t->dragging = 1;
+		}
+		if (t->dragging){
+			emit(GESTURE_DRAG, id, t, now_ms);
+		}
+	}
+}
+
+void gesture_poll(uint32_t now_ms){
+	for (uint8_t i = 0; i < GESTURE_MAX_TOUCHES; i++){
+		touch_track *t = &tracks[i];
+
+		if (t->active && !t->dragging && !t->long_fired
+				&& (now_ms - t->t0) >= cfg.long_press_ms){
+			t->long_fired = 1;
+			emit(GESTURE_LONG_PRESS, i, t, now_ms);
+		}
+	}
+}
+
+//PROXIMO INSTANTE (ms) EM QUE UM LONG-PRESS PODE DISPARAR; 0 SE NAO HA NENHUM
+int gesture_next_deadline(uint32_t *deadline_ms){
+	int found = 0;
+
+	for (uint8_t i = 0; i < GESTURE_MAX_TOUCHES; i++){
+		const touch_track *t = &tracks[i];
+
+		if (t->active && !t->dragging && !t->long_fired){
+			uint32_t d = t->t0 + cfg.long_press_ms;
+			if (!found || (int32_t)(d - *deadline_ms) < 0){
+				*deadline_ms = d;
+			}
+			found = 1;
+		}
+	}
+	return found;
+}
@@ -0,0 +1,57 @@
+/*
+ * gesture.h
+ *
+ * Reconhecedor de gestos sobre os eventos T9 do maXTouch. Cada ID de toque
+ * tem seu estado (DETECT/PRESS/MOVE/RELEASE) com tempo em ms, e o modulo
+ * gera press, release, tap, long-press, drag e swipe horizontal.
+ */
+
+
+#ifndef GESTURE_H_
+#define GESTURE_H_
+
+#include <stdint.h>
+
+#define GESTURE_MAX_TOUCHES 4
+
+/* Bits de status do T9 (mesmos valores de mxt_device_1.h) */
+#define GESTURE_T9_MOVE     16
+#define GESTURE_T9_RELEASE  32
+#define GESTURE_T9_PRESS    64
+#define GESTURE_T9_DETECT   128
+
+typedef enum {
+	GESTURE_PRESS,
+	GESTURE_RELEASE,
+	GESTURE_TAP,
+	GESTURE_LONG_PRESS,
+	GESTURE_DRAG,
+	GESTURE_SWIPE_LEFT,
+	GESTURE_SWIPE_RIGHT
+} gesture_type;
+
+typedef struct {
+	gesture_type type;
+	uint8_t id;
+	uint16_t x;        // posicao atual
+	uint16_t y;
+	uint16_t x0;       // posicao onde o toque comecou
+	uint16_t y0;
+	uint32_t duration; // ms desde o press
+} gesture_event;
+
+typedef void (*gesture_handler)(const gesture_event *ev);
+
+typedef struct {
+	uint32_t long_press_ms; // tempo segurando para long-press
+	uint16_t drag_px;       // deslocamento minimo para virar drag
+	uint16_t swipe_px;      // deslocamento horizontal minimo do swipe
+	uint32_t swipe_ms;      // duracao maxima do swipe
+} gesture_config;
+
+void gesture_init(const gesture_config *config, gesture_handler handler);
+void gesture_feed(uint8_t id, uint8_t status, uint16_t x, uint16_t y, uint32_t now_ms);
+void gesture_poll(uint32_t now_ms);
+int gesture_next_deadline(uint32_t *deadline_ms);
+
+#endif /* GESTURE_H_ */
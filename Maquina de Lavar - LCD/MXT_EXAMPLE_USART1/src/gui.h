@@ -1,28 +1,26 @@
-const uint8_t TEXTX = 20;
-const uint8_t NAMEY = 100;
-const uint8_t TEMPY = 130;
-const uint8_t EXAQY = 155;
-const uint8_t RPMY = 185;
-const uint8_t CTIMY = 210;
-const uint8_t RECTY = 100;
-const uint8_t RECTX = 20;
-const uint8_t RECTY2 = 235;
-const uint8_t SPACE = 1;
-const uint8_t CLOSEX = 110;
-const uint8_t CLOSEY = 100;
-const uint8_t CLOSEY2 = 130;
-
-const uint8_t CENTRIFX = 227;
-const uint16_t LINEBUT1 = 285;
-const uint16_t LINEBUT2 = 385;
-const uint8_t LOCX = 0;
-const uint8_t LOCY = 0;
-const uint8_t SLOWX = 0;
-const uint8_t FASTX = 110;
-const uint8_t DAYX = 45;
-const uint8_t ENXX = 182;
-const uint8_t STARTX = 227;
-const uint8_t STARTY = 0;
-
+#define TEXTX 20
+#define NAMEY 100
+#define TEMPY 130
+#define EXAQY 155
+#define RPMY 185
+#define CTIMY 210
+#define RECTY 100
+#define RECTX 20
+#define RECTY2 235
+#define SPACE 1
+#define CLOSEX 110
+#define CLOSEY 100
+#define CLOSEY2 130
 
+#define CENTRIFX 227
+#define LINEBUT1 285
+#define LINEBUT2 385
+#define LOCX 0
+#define LOCY 0
+#define SLOWX 0
+#define FASTX 110
+#define DAYX 45
+#define ENXX 182
+#define STARTX 227
+#define STARTY 0
 
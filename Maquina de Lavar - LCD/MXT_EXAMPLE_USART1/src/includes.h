@@ -2,23 +2,33 @@
 
 
 #include "tfont.h"
-#include "calibri_24.h"
-#include "maquina1.h"
+#include "screens.h"
+#include "cycle_table.h"
+#include "touch_grid.h"
+#include "gesture.h"
+#include "input.h"
+#include "touch_calib.h"
+#include "touch.h"
+#include "latency.h"
+#include "prof.h"
+#include "tcm.h"
+#include "dma_pool.h"
+#include "frame_sched.h"
+#include "event_queue.h"
+#include "event_loop.h"
+#include "serial_tx.h"
+#include "console.h"
+#include "tlog.h"
+#include "cobs.h"
+#include "telemetry.h"
+#include "timer_wheel.h"
+#include "clock_source.h"
+#include "timebase.h"
+#include "wash_program.h"
+#include "wash_flow.h"
+#include "wash_checkpoint.h"
+#include "backup_regs.h"
+#include "user_programs.h"
 #include "conf_board.h"
 #include "conf_example.h"
 #include "conf_uart_serial.h"
-#include "logo.h"
-#include "icones/water.h"
-#include "icones/water_click.h"
-#include "icones/lock_white.h"
-#include "icones/unlock_white.h"
-#include "icones/fast.h"
-#include "icones/fast_click.h"
-#include "icones/clean.h"
-#include "icones/clean_click.h"
-#include "icones/centrifuge.h"
-#include "icones/centrifuge_click.h"
-#include "icones/daily.h"
-#include "icones/daily_click.h"
-#include "icones/heavy.h"
-#include "icones/heavy_click.h"
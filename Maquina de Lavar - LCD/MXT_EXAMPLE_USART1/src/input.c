@@ -0,0 +1,96 @@
+/*
+ * input.c
+ *
+ * Debounce por espera de silencio: cada borda (re)arma o timer de
+ * estabilizacao da entrada para borda + debounce_ms; quando ele vence, o
+ * nivel lido e o estado novo. O press conta da primeira borda, entao o hold
+ * e a duracao nao dependem do debounce. Os carimbos das bordas sao ms de 32
+ * bits (o stamp da fila) e sao estendidos pelo tempo da timebase.
+ */
+
+#include "input.h"
+#include "timebase.h"
+
+typedef struct {
+	uint8_t pressed;      // estado estavel
+	uint8_t settling;     // ja houve borda desde o ultimo estado estavel
+	uint64_t first_edge;  // primeira borda da mudanca em curso
+	uint64_t press_at;
+} input_state;
+
+static const input_pin *table;
+static uint8_t count;
+static input_handler on_input;
+static input_state inputs[INPUT_MAX];
+static timebase_timer settle_timers[INPUT_MAX];
+static timebase_timer hold_timers[INPUT_MAX];
+
+static void emit(uint8_t type, uint8_t index, uint32_t duration){
+	input_event ev = {type, index, duration};
+
+	if (on_input){
+		on_input(&ev);
+	}
+}
+
+static void on_hold(timebase_timer *t){
+	uint8_t i = (uint8_t)(t - hold_timers);
+
+	if (inputs[i].pressed){
+		emit(INPUT_HOLD, i, (uint32_t)(timebase_now() - inputs[i].press_at));
+	}
+}
+
+static void on_settle(timebase_timer *t){
+	uint8_t i = (uint8_t)(t - settle_timers);
+	input_state *s = &inputs[i];
+	bool level = input_hw_read(i);
+
+	s->settling = 0;
+	if (level == s->pressed){
+		return;  // so ruido: voltou ao que era
+	}
+	s->pressed = level;
+	if (level){
+		s->press_at = s->first_edge;
+		emit(INPUT_PRESS, i, 0);
+		if (table[i].hold_ms){
+			timebase_start(&hold_timers[i], s->press_at + table[i].hold_ms, on_hold);
+		}
+	} else {
+		timebase_stop(&hold_timers[i]);
+		emit(INPUT_RELEASE, i, (uint32_t)(timebase_now() - s->press_at));
+	}
+}
+
+void input_init(const input_pin pins[], uint8_t n, input_edge_handler on_edge, input_handler handler){
+	table = pins;
+	count = n < INPUT_MAX ? n : INPUT_MAX;
+	on_input = handler;
+	input_hw_init(pins, count, on_edge);
+	for (uint8_t i = 0; i < count; i++){
+		inputs[i].pressed = input_hw_read(i);
+		inputs[i].settling = 0;
+		inputs[i].press_at = timebase_now();
+	}
+}
+
+//NO MAIN, PARA CADA EV_BUTTON DA FILA
+void input_edge(uint8_t index, uint32_t stamp_ms){
+	if (index >= count){
+		return;
+	}
+	input_state *s = &inputs[index];
+	uint64_t now = timebase_now();
+	uint64_t t = now - (uint32_t)((uint32_t)now - stamp_ms);
+
+	if (!s->settling){
+		s->settling = 1;
+		s->first_edge = t;
+	}
+	timebase_start(&settle_timers[index], t + table[index].debounce_ms, on_settle);
+}
+
+bool input_pressed(uint8_t index){
+	return index < count && inputs[index].pressed;
+}
@@ -0,0 +1,59 @@
+/*
+ * input.h
+ *
+ * Entradas digitais do PIO (botoes, sensor da porta...) descritas numa
+ * tabela. A interrupcao de cada pino so carimba a borda e avisa quem chamou
+ * (on_edge, que posta na fila de eventos); o debounce e o hold rodam no
+ * main, pela timebase: a entrada so muda depois de debounce_ms sem bordas,
+ * e segurando hold_ms sai um INPUT_HOLD. O back end do alvo e
+ * input_pio.c; o de host e sim/input_sim.c.
+ */
+
+
+#ifndef INPUT_H_
+#define INPUT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define INPUT_MAX  8
+
+typedef enum {
+	INPUT_PRESS,
+	INPUT_RELEASE,
+	INPUT_HOLD
+} input_event_type;
+
+typedef struct {
+	uint8_t type;       // input_event_type
+	uint8_t index;      // linha da tabela
+	uint32_t duration;  // ms desde o press (0 no press)
+} input_event;
+
+typedef struct {
+	const char *name;
+	void *port;          // Pio * no alvo; ignorado no host
+	uint32_t port_id;    // ID_PIOx
+	uint32_t mask;
+	uint8_t active_low;  // pressionado = nivel 0 (com pull-up)
+	uint16_t debounce_ms;
+	uint16_t hold_ms;    // 0 = sem INPUT_HOLD
+} input_pin;
+
+typedef void (*input_edge_handler)(uint8_t index);   // roda na interrupcao
+typedef void (*input_handler)(const input_event *ev);
+
+void input_init(const input_pin pins[], uint8_t n, input_edge_handler on_edge, input_handler handler);
+void input_edge(uint8_t index, uint32_t stamp_ms);
+bool input_pressed(uint8_t index);
+
+//BACK END: CONFIGURA OS PINOS E LE O NIVEL ATUAL (true = PRESSIONADO)
+void input_hw_init(const input_pin pins[], uint8_t n, input_edge_handler on_edge);
+bool input_hw_read(uint8_t index);
+
+#ifdef HOST_BUILD
+//MUDA O NIVEL DO PINO E GERA A BORDA, COMO A INTERRUPCAO
+void input_sim_set(uint8_t index, bool pressed);
+#endif
+
+#endif /* INPUT_H_ */
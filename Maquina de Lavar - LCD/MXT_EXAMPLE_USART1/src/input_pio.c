@@ -0,0 +1,48 @@
+/*
+ * input_pio.c
+ *
+ * Back end de hardware do input: cada pino da tabela vira entrada com
+ * interrupcao nas duas bordas, todas no mesmo handler, que acha a linha
+ * pelo (id, mask) que o pio_handler entrega. O filtro de debounce do PIO
+ * fica ligado so para cortar glitches; o debounce de verdade e o do input.c.
+ */
+
+#include <asf.h>
+#include "input.h"
+
+static const input_pin *table;
+static uint8_t count;
+static input_edge_handler edge;
+
+static void pin_handler(uint32_t id, uint32_t mask){
+	for (uint8_t i = 0; i < count; i++){
+		if (table[i].port_id == id && (table[i].mask & mask)){
+			edge(i);
+		}
+	}
+}
+
+void input_hw_init(const input_pin pins[], uint8_t n, input_edge_handler on_edge){
+	table = pins;
+	count = n;
+	edge = on_edge;
+
+	for (uint8_t i = 0; i < n; i++){
+		Pio *pio = (Pio *)pins[i].port;
+
+		pmc_enable_periph_clk(pins[i].port_id);
+		pio_set_input(pio, pins[i].mask, (pins[i].active_low ? PIO_PULLUP : 0) | PIO_DEBOUNCE);
+		pio_handler_set(pio, pins[i].port_id, pins[i].mask, PIO_IT_EDGE, pin_handler);
+		pio_enable_interrupt(pio, pins[i].mask);
+
+		NVIC_EnableIRQ((IRQn_Type)pins[i].port_id);
+		NVIC_SetPriority((IRQn_Type)pins[i].port_id, 1);
+	}
+}
+
+bool input_hw_read(uint8_t index){
+	const input_pin *p = &table[index];
+	bool high = pio_get((Pio *)p->port, PIO_INPUT, p->mask) != 0;
+
+	return p->active_low ? !high : high;
+}
@@ -0,0 +1,449 @@
+/*
+ * kv_store.c
+ *
+ * Setor: cabecalho de 16 B {magic, seq, apagamentos, crc} e registros
+ * alinhados em 16 B: {key, len, crc} + valor. len com o bit 15 e um
+ * tombstone (kv_delete). A ordem do log e (seq do setor, posicao), entao o
+ * ultimo registro lido de uma chave e o valido. Bloco todo em 0xFF e o fim
+ * do setor so quando todo o resto tambem esta em 0xFF (ver walk_sector()).
+ *
+ * Sempre existe um setor livre depois do topo: ao abrir um setor novo, o
+ * seguinte a ele (o mais antigo do anel) e compactado para dentro do novo.
+ * Se a energia cair no meio, o kv_mount() termina a compactacao; o que ja
+ * tinha sido copiado e mais novo e o indice ja aponta para a copia.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "kv_store.h"
+#include "flash_dev.h"
+#include "crc32.h"
+
+#define SECTOR_MAGIC    0x3153564Bu   // "KVS1"
+#define HEADER_SIZE     16u
+#define RECORD_HEADER   8u
+#define TOMBSTONE       0x8000u
+#define ALIGN(n)        (((n) + FLASH_DEV_WRITE_ALIGN - 1) & ~(FLASH_DEV_WRITE_ALIGN - 1))
+#define RECORD_MAX      ALIGN(RECORD_HEADER + KV_MAX_VALUE)
+#define SECTOR_DATA     (FLASH_DEV_SECTOR_SIZE - HEADER_SIZE)
+//UM SETOR FICA LIVRE PARA A COMPACTACAO E OUTRO E FOLGA: COM ISSO UMA VOLTA
+//NO ANEL SEMPRE ACHA ESPACO PARA UM REGISTRO
+#define LIVE_LIMIT      ((FLASH_DEV_SECTORS - 2) * SECTOR_DATA)
+
+//O INDICE CHEIO COM VALORES MAXIMOS CABE: KV_ERR_FULL SO POR FALTA DE CHAVE
+_Static_assert(KV_MAX_KEYS * RECORD_MAX <= LIVE_LIMIT, "regiao pequena para KV_MAX_KEYS");
+
+typedef struct {
+	uint32_t magic;
+	uint32_t seq;
+	uint32_t erase_count;
+	uint32_t crc;
+} sector_header;
+
+typedef struct {
+	uint16_t key;
+	uint16_t len;
+	uint32_t crc;      // de key, len e valor
+} record_header;
+
+typedef struct {
+	uint16_t key;
+	uint16_t len;
+	uint32_t addr;     // offset do registro na regiao
+} kv_entry;
+
+enum {SECTOR_FREE, SECTOR_USED, SECTOR_DIRTY};
+enum {REC_OK, REC_BLANK, REC_BAD, REC_END};
+
+static kv_entry entries[KV_MAX_KEYS];
+static uint8_t entry_count;
+static uint8_t state[FLASH_DEV_SECTORS];
+static uint32_t seq[FLASH_DEV_SECTORS];
+static uint32_t erase_count[FLASH_DEV_SECTORS];
+static uint32_t top_seq;
+static uint8_t head;
+static uint32_t wp;          // onde vai o proximo registro
+static kv_stats stats;
+static uint8_t buf[RECORD_MAX] __attribute__((aligned(4)));
+
+static inline uint32_t record_size(uint16_t len){
+	return ALIGN(RECORD_HEADER + (len & ~TOMBSTONE));
+}
+
+static inline uint32_t sector_end(uint8_t s){
+	return ((uint32_t)s + 1) * FLASH_DEV_SECTOR_SIZE;
+}
+
+static bool blank(const uint8_t *p, uint32_t len){
+	while (len--){
+		if (*p++ != 0xFF){
+			return false;
+		}
+	}
+	return true;
+}
+
+//CRC DO REGISTRO QUE ESTA EM buf
+static uint32_t record_crc(uint16_t len){
+	uint32_t crc = crc32_update(CRC32_INIT, buf, 4);
+	return ~crc32_update(crc, buf + RECORD_HEADER, len & ~TOMBSTONE);
+}
+
+//###############################################################################################################
+//INDICE
+
+static kv_entry *find(uint16_t key){
+	for (uint8_t i = 0; i < entry_count; i++){
+		if (entries[i].key == key){
+			return &entries[i];
+		}
+	}
+	return NULL;
+}
+
+static void index_set(uint16_t key, uint16_t len, uint32_t addr){
+	kv_entry *e = find(key);
+
+	if (e){
+		stats.live_bytes -= record_size(e->len);
+	} else if (entry_count < KV_MAX_KEYS){
+		e = &entries[entry_count++];
+		e->key = key;
+	} else {
+		return;
+	}
+	e->len = len;
+	e->addr = addr;
+	stats.live_bytes += record_size(len);
+}
+
+static void index_remove(uint16_t key){
+	kv_entry *e = find(key);
+
+	if (e){
+		stats.live_bytes -= record_size(e->len);
+		*e = entries[--entry_count];
+	}
+}
+
+//###############################################################################################################
+//LOG
+
+static bool range_blank(uint32_t off, uint32_t end){
+	while (off < end){
+		uint32_t n = end - off < RECORD_MAX ? end - off : RECORD_MAX;
+		if (!flash_dev_read(off, buf, n) || !blank(buf, n)){
+			return false;
+		}
+		off += n;
+	}
+	return true;
+}
+
+//LE O REGISTRO EM off PARA buf
+static uint8_t read_record(uint32_t off, uint32_t end, record_header *h){
+	if (off + FLASH_DEV_WRITE_ALIGN > end || !flash_dev_read(off, buf, FLASH_DEV_WRITE_ALIGN)){
+		return REC_END;
+	}
+	if (blank(buf, FLASH_DEV_WRITE_ALIGN)){
+		return REC_BLANK;
+	}
+	memcpy(h, buf, sizeof(*h));
+	if (h->key == KV_KEY_INVALID || (h->len & ~TOMBSTONE) > KV_MAX_VALUE || off + record_size(h->len) > end){
+		return REC_BAD;
+	}
+	if (!flash_dev_read(off, buf, record_size(h->len)) || record_crc(h->len) != h->crc){
+		return REC_BAD;
+	}
+	return REC_OK;
+}
+
+//PERCORRE O SETOR CHAMANDO visit EM CADA REGISTRO VALIDO (QUE FICA EM buf)
+//E DEVOLVE ONDE E SEGURO CONTINUAR O LOG (0 SE visit FALHOU). O FIM DO LOG
+//E O RESTO DO SETOR TODO EM 0xFF. UM REGISTRO CORTADO PELA QUEDA E O
+//PREFIXO DELE, COM O RESTO AINDA APAGADO: O LOG PULA DE 16 EM 16 B ATE O
+//PROXIMO REGISTRO E SO CONTINUA DEPOIS DE TODA A EXTENSAO QUE ELE PODIA TER
+static uint32_t walk_sector(uint8_t s, bool (*visit)(uint32_t off, const record_header *h)){
+	uint32_t off = s * FLASH_DEV_SECTOR_SIZE + HEADER_SIZE;
+	uint32_t end = sector_end(s);
+	uint32_t torn = 0;       // inicio do trecho invalido depois do ultimo registro
+	record_header h;
+	uint8_t r;
+
+	while ((r = read_record(off, end, &h)) != REC_END){
+		if (r == REC_BLANK && range_blank(off, end)){
+			break;
+		}
+		if (r != REC_OK){
+			torn = torn ? torn : off;
+			off += FLASH_DEV_WRITE_ALIGN;
+			continue;
+		}
+		if (!visit(off, &h)){
+			return 0;
+		}
+		torn = 0;
+		off += record_size(h.len);
+	}
+	if (torn && off < torn + RECORD_MAX){
+		off = torn + RECORD_MAX < end ? torn + RECORD_MAX : end;
+	}
+	return off;
+}
+
+static bool apply_record(uint32_t off, const record_header *h){
+	if (h->len & TOMBSTONE){
+		index_remove(h->key);
+	} else {
+		index_set(h->key, h->len, off);
+	}
+	stats.records++;
+	return true;
+}
+
+static bool erase_sector(uint8_t s){
+	if (!flash_dev_erase(s)){
+		return false;
+	}
+	erase_count[s]++;
+	state[s] = SECTOR_FREE;
+	stats.erases++;
+	return true;
+}
+
+static bool open_sector(uint8_t s){
+	sector_header h;
+
+	if ((state[s] != SECTOR_FREE || !range_blank(s * FLASH_DEV_SECTOR_SIZE, sector_end(s)))
+			&& !erase_sector(s)){
+		return false;
+	}
+	h.magic = SECTOR_MAGIC;
+	h.seq = ++top_seq;
+	h.erase_count = erase_count[s];
+	h.crc = crc32(&h, offsetof(sector_header, crc));
+	if (!flash_dev_write(s * FLASH_DEV_SECTOR_SIZE, &h, sizeof(h))){
+		return false;
+	}
+	state[s] = SECTOR_USED;
+	seq[s] = h.seq;
+	head = s;
+	wp = s * FLASH_DEV_SECTOR_SIZE + HEADER_SIZE;
+	stats.flash_bytes += sizeof(h);
+	return true;
+}
+
+static bool copy_live(uint32_t off, const record_header *h){
+	uint32_t size = record_size(h->len);
+	kv_entry *e = find(h->key);
+
+	if ((h->len & TOMBSTONE) || !e || e->addr != off){
+		return true;
+	}
+	if (wp + size > sector_end(head) || !flash_dev_write(wp, buf, size)){
+		return false;
+	}
+	e->addr = wp;
+	wp += size;
+	stats.flash_bytes += size;
+	return true;
+}
+
+//COPIA OS REGISTROS AINDA VALIDOS DO SETOR PARA O TOPO E APAGA O SETOR
+static bool compact(uint8_t s){
+	if (walk_sector(s, copy_live) == 0){
+		return false;
+	}
+	stats.compactions++;
+	return erase_sector(s);
+}
+
+//ABRE O PROXIMO SETOR DO ANEL E LIBERA O SEGUINTE A ELE
+static bool advance(void){
+	uint8_t next = (head + 1) % FLASH_DEV_SECTORS;
+	uint8_t after = (next + 1) % FLASH_DEV_SECTORS;
+
+	if (state[next] == SECTOR_USED || !open_sector(next)){
+		return false;
+	}
+	return state[after] != SECTOR_USED || compact(after);
+}
+
+static kv_status ensure_room(uint32_t size){
+	for (uint8_t i = 0; i <= FLASH_DEV_SECTORS && wp + size > sector_end(head); i++){
+		if (!advance()){
+			return KV_ERR_FLASH;
+		}
+	}
+	return wp + size <= sector_end(head) ? KV_OK : KV_ERR_FULL;
+}
+
+static kv_status append(uint16_t key, uint16_t len, const void *value){
+	record_header h = {key, len, 0};
+	uint32_t size = record_size(len);
+	kv_status st = ensure_room(size);
+
+	if (st != KV_OK){
+		return st;
+	}
+	memset(buf, 0, size);
+	memcpy(buf, &h, sizeof(h));
+	if (value){
+		memcpy(buf + RECORD_HEADER, value, len & ~TOMBSTONE);
+	}
+	h.crc = record_crc(len);
+	memcpy(buf, &h, sizeof(h));
+	if (!flash_dev_write(wp, buf, size)){
+		return KV_ERR_FLASH;
+	}
+	wp += size;
+	stats.flash_bytes += size;
+	return KV_OK;
+}
+
+//###############################################################################################################
+//API
+
+kv_status kv_mount(void){
+	uint8_t order[FLASH_DEV_SECTORS];
+	uint8_t used = 0;
+	uint32_t max_erase = 0;
+	sector_header h;
+
+	memset(&stats, 0, sizeof(stats));
+	entry_count = 0;
+	top_seq = 0;
+	if (!flash_dev_init()){
+		return KV_ERR_FLASH;
+	}
+	for (uint8_t s = 0; s < FLASH_DEV_SECTORS; s++){
+		erase_count[s] = 0;
+		if (!flash_dev_read(s * FLASH_DEV_SECTOR_SIZE, &h, sizeof(h))){
+			return KV_ERR_FLASH;
+		}
+		if (blank((const uint8_t *)&h, sizeof(h))){
+			state[s] = SECTOR_FREE;
+		} else if (h.magic == SECTOR_MAGIC && h.crc == crc32(&h, offsetof(sector_header, crc))){
+			state[s] = SECTOR_USED;
+			seq[s] = h.seq;
+			erase_count[s] = h.erase_count;
+			if (h.erase_count > max_erase){
+				max_erase = h.erase_count;
+			}
+			if (h.seq > top_seq){
+				top_seq = h.seq;
+			}
+			//ORDENA POR seq (INSERCAO; SAO POUCOS SETORES)
+			uint8_t i = used++;
+			while (i > 0 && seq[order[i - 1]] > h.seq){
+				order[i] = order[i - 1];
+				i--;
+			}
+			order[i] = s;
+		} else {
+			state[s] = SECTOR_DIRTY;
+		}
+	}
+	//O CABECALHO SO E GRAVADO AO ABRIR: SEM ELE, ESTIMA PELO ANEL
+	for (uint8_t s = 0; s < FLASH_DEV_SECTORS; s++){
+		if (state[s] != SECTOR_USED){
+			erase_count[s] = max_erase;
+		}
+	}
+
+	if (used == 0){
+		return open_sector(0) ? KV_OK : KV_ERR_FLASH;
+	}
+	for (uint8_t i = 0; i < used; i++){
+		head = order[i];
+		wp = walk_sector(head, apply_record);
+	}
+
+	//QUEDA NO MEIO DE UMA COMPACTACAO: TERMINA AGORA
+	uint8_t after = (head + 1) % FLASH_DEV_SECTORS;
+	if (state[after] == SECTOR_USED && !compact(after)){
+		return KV_ERR_FLASH;
+	}
+	return KV_OK;
+}
+
+kv_status kv_put(uint16_t key, const void *value, uint16_t len){
+	kv_entry *e = find(key);
+	uint32_t size = record_size(len);
+	kv_status st;
+
+	if (key == KV_KEY_INVALID){
+		return KV_ERR_NOT_FOUND;
+	}
+	if (len > KV_MAX_VALUE){
+		return KV_ERR_TOO_BIG;
+	}
+	if ((!e && entry_count == KV_MAX_KEYS)
+			|| stats.live_bytes - (e ? record_size(e->len) : 0) + size > LIVE_LIMIT){
+		return KV_ERR_FULL;
+	}
+	st = append(key, len, value);
+	if (st == KV_OK){
+		index_set(key, len, wp - size);
+		stats.user_bytes += len;
+	}
+	return st;
+}
+
+kv_status kv_get(uint16_t key, void *value, uint16_t size, uint16_t *len){
+	kv_entry *e = find(key);
+
+	if (!e){
+		return KV_ERR_NOT_FOUND;
+	}
+	if (e->len > size){
+		return KV_ERR_TOO_BIG;
+	}
+	if (!flash_dev_read(e->addr + RECORD_HEADER, value, e->len)){
+		return KV_ERR_FLASH;
+	}
+	if (len){
+		*len = e->len;
+	}
+	return KV_OK;
+}
+
+kv_status kv_delete(uint16_t key){
+	kv_status st;
+
+	if (!find(key)){
+		return KV_ERR_NOT_FOUND;
+	}
+	st = append(key, TOMBSTONE, NULL);
+	if (st == KV_OK){
+		index_remove(key);
+	}
+	return st;
+}
+
+bool kv_exists(uint16_t key){
+	return find(key) != NULL;
+}
+
+uint8_t kv_count(void){
+	return entry_count;
+}
+
+uint16_t kv_key_at(uint8_t i){
+	return i < entry_count ? entries[i].key : KV_KEY_INVALID;
+}
+
+void kv_get_stats(kv_stats *out){
+	*out = stats;
+	out->keys = entry_count;
+	out->erase_min = UINT32_MAX;
+	out->erase_max = 0;
+	for (uint8_t s = 0; s < FLASH_DEV_SECTORS; s++){
+		if (erase_count[s] < out->erase_min){
+			out->erase_min = erase_count[s];
+		}
+		if (erase_count[s] > out->erase_max){
+			out->erase_max = erase_count[s];
+		}
+	}
+}
@@ -0,0 +1,53 @@
+/*
+ * kv_store.h
+ *
+ * Chave/valor persistente e log-structured sobre o flash_dev: cada
+ * kv_put() acrescenta um registro (com CRC) no fim do log, nunca regrava no
+ * lugar. Os setores sao usados em anel, entao todos apagam no mesmo ritmo
+ * (wear levelling); quando o proximo setor livre e o ultimo, o mais antigo
+ * e compactado: os registros ainda validos vao para o topo do log e ele e
+ * apagado. kv_mount() le o log uma vez, em O(registros), e monta o indice
+ * em RAM; kv_get() vai direto ao endereco do registro.
+ */
+
+
+#ifndef KV_STORE_H_
+#define KV_STORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define KV_MAX_KEYS     32
+#define KV_MAX_VALUE    240      // registro inteiro <= 256 B
+#define KV_KEY_INVALID  0xFFFF   // flash apagada
+
+typedef enum {
+	KV_OK,
+	KV_ERR_NOT_FOUND,
+	KV_ERR_TOO_BIG,     // valor maior que KV_MAX_VALUE ou que o buffer do kv_get
+	KV_ERR_FULL,        // sem chave livre no indice ou sem espaco garantido
+	KV_ERR_FLASH        // o flash_dev recusou (ou a energia caiu)
+} kv_status;
+
+typedef struct {
+	uint32_t user_bytes;     // bytes de valor pedidos em kv_put()
+	uint32_t flash_bytes;    // bytes gravados: registros, cabecalhos e copias
+	uint32_t live_bytes;     // registros validos hoje no log
+	uint32_t compactions;
+	uint32_t erases;
+	uint32_t erase_min;      // menor e maior contagem de apagamentos por setor
+	uint32_t erase_max;
+	uint16_t records;        // registros lidos no ultimo kv_mount()
+	uint8_t keys;
+} kv_stats;
+
+kv_status kv_mount(void);
+kv_status kv_put(uint16_t key, const void *value, uint16_t len);
+kv_status kv_get(uint16_t key, void *buf, uint16_t size, uint16_t *len);
+kv_status kv_delete(uint16_t key);
+bool kv_exists(uint16_t key);
+uint8_t kv_count(void);
+uint16_t kv_key_at(uint8_t i);
+void kv_get_stats(kv_stats *stats);
+
+#endif /* KV_STORE_H_ */
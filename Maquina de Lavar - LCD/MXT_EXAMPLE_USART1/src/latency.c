@@ -0,0 +1,146 @@
+/*
+ * latency.c
+ *
+ * Cada amostra comeca em LAT_CHG e so e registrada quando chega em
+ * LAT_DISPLAY passando pelas etapas em ordem. Marcas repetidas de uma etapa
+ * ja vista sao ignoradas; pular uma etapa descarta a amostra (ex.: leitura
+ * sem press nao gera hit-test).
+ * A linha de LAT_CHG no histograma guarda o tempo total.
+ * Pode ser chamado de interrupcao so o latency_now(); as marcas sao do main.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "latency.h"
+
+#ifdef HOST_BUILD
+static uint32_t sim_cycles;
+
+void latency_sim_advance(uint32_t cycles){
+	sim_cycles += cycles;
+}
+
+static inline uint32_t cycles_now(void){
+	return sim_cycles;
+}
+#else
+#include "prof.h"
+
+//O CYCCNT E LIGADO PELO prof_init()
+static inline uint32_t cycles_now(void){
+	return prof_ticks();
+}
+#endif
+
+static const char *stage_names[LAT_STAGES] = {"total", "twi", "hit", "callback", "display"};
+
+static uint32_t cycles_per_us = 1;
+static uint32_t stamps[LAT_STAGES];
+static uint8_t last_stage = LAT_NONE;
+static uint32_t samples;
+static uint32_t hist[LAT_STAGES][LATENCY_BUCKETS];
+static uint32_t min_us[LAT_STAGES];
+static uint32_t max_us[LAT_STAGES];
+
+static uint8_t bucket(uint32_t us){
+	uint8_t b = 0;
+
+	while (us > 1 && b < LATENCY_BUCKETS - 1){
+		us >>= 1;
+		b++;
+	}
+	return b;
+}
+
+static void record(uint8_t row, uint32_t cycles){
+	uint32_t us = cycles / cycles_per_us;
+
+	hist[row][bucket(us)]++;
+	if (us < min_us[row]){
+		min_us[row] = us;
+	}
+	if (us > max_us[row]){
+		max_us[row] = us;
+	}
+}
+
+void latency_reset(void){
+	memset(hist, 0, sizeof(hist));
+	memset(max_us, 0, sizeof(max_us));
+	memset(min_us, 0xff, sizeof(min_us));
+	samples = 0;
+	last_stage = LAT_NONE;
+}
+
+void latency_init(uint32_t cpu_hz){
+	cycles_per_us = cpu_hz / 1000000;
+	if (cycles_per_us == 0){
+		cycles_per_us = 1;
+	}
+	latency_reset();
+}
+
+uint32_t latency_now(void){
+	return cycles_now();
+}
+
+void latency_mark(latency_stage stage){
+	latency_mark_at(stage, cycles_now());
+}
+
+//stamp EM CICLOS DO latency_now(), TOMADO ANTES (EX.: NA INTERRUPCAO)
+void latency_mark_at(latency_stage stage, uint32_t stamp){
+	if (stage == LAT_CHG){
+		stamps[LAT_CHG] = stamp;
+		last_stage = LAT_CHG;
+		return;
+	}
+
+	if (last_stage == LAT_NONE || stage <= (latency_stage)last_stage){
+		return;
+	}
+
+	//PULOU UMA ETAPA: DESCARTA A AMOSTRA
+	if (stage != (latency_stage)(last_stage + 1)){
+		last_stage = LAT_NONE;
+		return;
+	}
+
+	stamps[stage] = stamp;
+	last_stage = stage;
+
+	if (stage == LAT_DISPLAY){
+		for (uint8_t s = LAT_TWI; s < LAT_STAGES; s++){
+			record(s, stamps[s] - stamps[s - 1]);
+		}
+		record(LAT_CHG, stamps[LAT_DISPLAY] - stamps[LAT_CHG]);
+		samples++;
+		last_stage = LAT_NONE;
+	}
+}
+
+uint32_t latency_count(void){
+	return samples;
+}
+
+void latency_get_stats(uint8_t stage, latency_stats *stats){
+	stats->min_us = min_us[stage];
+	stats->max_us = max_us[stage];
+	memcpy(stats->hist, hist[stage], sizeof(stats->hist));
+}
+
+//IMPRIME OS HISTOGRAMAS NO CONSOLE
+void latency_dump(void){
+	printf("\n\rlatencia touch->lcd, %lu amostras (us)\n\r", (unsigned long)samples);
+	if (samples == 0){
+		return;
+	}
+	for (uint8_t s = 0; s < LAT_STAGES; s++){
+		printf("%-8s min %6lu max %6lu |", stage_names[s],
+				(unsigned long)min_us[s], (unsigned long)max_us[s]);
+		for (uint8_t b = 0; b < LATENCY_BUCKETS; b++){
+			printf(" %lu", (unsigned long)hist[s][b]);
+		}
+		printf("\n\r");
+	}
+}
@@ -0,0 +1,49 @@
+/*
+ * latency.h
+ *
+ * Medicao touch-to-photon: marca o tempo de cada etapa entre o CHG do
+ * maXTouch e o fim da escrita no LCD com o contador de ciclos DWT e guarda
+ * um histograma log2 (em us) por etapa. O CHG e marcado no main com o
+ * latency_now() que a interrupcao pos no evento, entao a espera na fila
+ * entra na conta. No host (HOST_BUILD) o relogio e simulado e avancado por
+ * latency_sim_advance() (sim/latency_sim.c).
+ */
+
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include <stdint.h>
+
+#define LATENCY_BUCKETS 16 // 1us .. 32ms, o ultimo acumula o resto
+
+typedef enum {
+	LAT_CHG,        // CHG em nivel baixo (inicio da amostra)
+	LAT_TWI,        // fim da leitura TWI (a espera na fila entra aqui)
+	LAT_HIT,        // fim do hit-test em touch_buttons()
+	LAT_CALLBACK,   // fim do callback do botao
+	LAT_DISPLAY,    // fim da escrita do icone no LCD (fecha a amostra)
+	LAT_STAGES,
+	LAT_NONE = 0xFF // sem amostra aberta
+} latency_stage;
+
+typedef struct {
+	uint32_t min_us;
+	uint32_t max_us;
+	uint32_t hist[LATENCY_BUCKETS];
+} latency_stats;
+
+void latency_init(uint32_t cpu_hz);
+uint32_t latency_now(void);
+void latency_mark(latency_stage stage);
+void latency_mark_at(latency_stage stage, uint32_t stamp);
+uint32_t latency_count(void);
+void latency_get_stats(uint8_t stage, latency_stats *stats);
+void latency_dump(void);
+void latency_reset(void);
+
+#ifdef HOST_BUILD
+void latency_sim_advance(uint32_t cycles);
+#endif
+
+#endif /* LATENCY_H_ */
@@ -102,16 +102,6 @@
 #define MINUTE      0
 #define SECOND      0
 
-#define CLICKED 1
-#define RELEASED 2
-
-#define WASHING 1
-#define FINISHED 2
-
-#define MAX_ENTRIES        3
-#define STRING_LENGTH     70
-#define USART_TX_MAX_LENGTH     0xff
-
 #define LED_PIO_ID	   ID_PIOC
 #define LED_PIO        PIOC
 #define LED_PIN		   8
@@ -122,53 +112,130 @@
 #define BUT_PIN		   11
 #define BUT_PIN_MASK   (1<<BUT_PIN)
 
+//CHG DO MAXTOUCH (MAXTOUCH_XPRO_CHG_PIO = PA2), ATIVO EM NIVEL BAIXO
+#define CHG_PIO_ID     ID_PIOA
+#define CHG_PIO        PIOA
+#define CHG_PIN_MASK   PIO_PA2
+
+//ENTRADAS DO PIO (input.h)
+#define BUT_DEBOUNCE_MS     20
+#define BUT_HOLD_MS         3000   // segurar o botao da placa cancela a lavagem
+
+//GESTOS
+#define LOCK_LONG_PRESS_MS  3000
+#define DRAG_MIN_PX         12
+#define SWIPE_MIN_PX        80
+#define SWIPE_MAX_MS        600
+
+//IMPRIME OS HISTOGRAMAS DE LATENCIA A CADA N TOQUES
+#define LATENCY_DUMP_EVERY  32
+
+//CONSOLE: ID DO TOQUE INJETADO (O ULTIMO DO gesture.c, LONGE DOS DEDOS REAIS)
+#define CONSOLE_TOUCH_ID    (GESTURE_MAX_TOUCHES - 1)
+
+//TIMEOUTS DA INTERFACE
+#define PRESS_HIGHLIGHT_MS  300    // start volta ao icone normal
+#define DOOR_MSG_MS         3000   // "FECHAR PORTA!" some
+#define SCREEN_DIM_MS       60000  // backlight apaga sem toque
+
+//QUADROS DA TELA (frame_sched.h)
+#define FRAME_PERIOD_MS     50     // no maximo um quadro por periodo
+#define FRAME_BUDGET_US     50000  // render acima disso conta como estouro
+
 //############################################################################################################
 // STRUCTS
-typedef struct {
-	uint8_t   state;
-	tImage icon1;
-	tImage icon2;
-	uint16_t x0;
-	uint16_t y0;
-	void (*callback)();
-} button;
+typedef struct button_t button;
+typedef void (*button_callback)(const button *b, uint8_t index);
+
+//ICONES E POSICOES EM screens.c (button_icons), MESMOS INDICES
+struct button_t {
+	uint8_t long_press; // callback no long-press em vez do press
+	button_callback callback;
+};
 
 struct ili9488_opt_t g_ili9488_display_opt;
 
+void callback_lock(const button *b, uint8_t index);
+void callback_wash_buttons(const button *b, uint8_t index);
+void callback_start(const button *b, uint8_t index);
+
+//TABELA DE BOTOES EM FLASH
+const button buttons[BUTTONS_SIZE] = {
+	[BUT_LOCK]       = {.callback = callback_lock, .long_press = 1},
+	[BUT_START]      = {.callback = callback_start},
+	[BUT_FAST]       = {.callback = callback_wash_buttons},
+	[BUT_CENTRIFUGA] = {.callback = callback_wash_buttons},
+	[BUT_SLOW]       = {.callback = callback_wash_buttons},
+	[BUT_ENXAGUE]    = {.callback = callback_wash_buttons},
+	[BUT_DAILY]      = {.callback = callback_wash_buttons},
+};
+
+//CAIXAS DE TOQUE, MESMA ORDEM DA TABELA; SAEM DE button_icons NO BOOT
+hit_box button_boxes[BUTTONS_SIZE];
+
+touch_grid buttons_grid;
+
+//ENTRADAS DIGITAIS: UMA LINHA POR BOTAO OU SENSOR, TODAS COM A MESMA ISR
+enum {
+	IN_BUT1,       // SW0 da placa, faz o papel da porta
+	INPUTS_SIZE
+};
+
+const input_pin input_pins[INPUTS_SIZE] = {
+	[IN_BUT1] = {.name = "SW0", .port = BUT_PIO, .port_id = BUT_PIO_ID, .mask = BUT_PIN_MASK, .active_low = 1,
+			.debounce_ms = BUT_DEBOUNCE_MS, .hold_ms = BUT_HOLD_MS},
+};
+
+//UMA FILA POR FONTE DE INTERRUPCAO; SO AS INTERRUPCOES POSTAM, SO O MAIN LE
+EVENT_QUEUE_DEFINE(touch_events, 8);
+EVENT_QUEUE_DEFINE(button_events, 4);
+EVENT_QUEUE_DEFINE(timer_events, 4);
+EVENT_QUEUE_DEFINE(console_events, 2);
+
+event_queue *const event_sources[] = {&touch_events, &button_events, &timer_events, &console_events};
+#define EVENT_SOURCES_SIZE (sizeof(event_sources) / sizeof(event_sources[0]))
+
 //###############################################################################################################
 //VARIAVEIS GLOBAIS
-volatile uint8_t locked = 1;
-volatile uint8_t flag_led = 0;
-volatile uint8_t wash_mode = 0;
-volatile uint8_t cleanScreen = 0;
-volatile uint8_t isWashing = 0;
-volatile uint32_t minute = 0;
-volatile uint32_t second = 0;
-volatile uint8_t washingLockScreen = 0;
-volatile uint8_t isLocking = 0;
-volatile uint16_t event_status = 0;
-
-button *buttons2[] ;
-
-int wash_times[] = {0,0,0,0,0};
+uint8_t locked = 1;
+uint8_t flag_led = 0;
+uint8_t wash_mode = 0;
+uint8_t door_msg = 0;          // "FECHAR PORTA!" na tela
+
+//RECURSOS DO DESENHO, LIGADOS E DESLIGADOS PELO CONSOLE ("feature")
+enum {
+	RENDER_ONLY_DIRTY,   // desligado: redesenha a cada FRAME_PERIOD_MS
+	RENDER_TELEMETRY,    // tempo e bytes de cada quadro na telemetria
+	RENDER_LATENCY,      // histogramas de latencia a cada LATENCY_DUMP_EVERY
+	RENDER_FEATURES
+};
+const char *const render_feature_names[RENDER_FEATURES] = {"dirty", "telemetry", "latency"};
+uint32_t render_features = (1 << RENDER_ONLY_DIRTY) | (1 << RENDER_TELEMETRY) | (1 << RENDER_LATENCY);
+#define RENDER_ON(f) ((render_features >> (f)) & 1)
+
+//ESTADO (CLICKED/RELEASED) DE CADA BOTAO DA TABELA
+uint8_t button_state[BUTTONS_SIZE] = {CLICKED, CLICKED, CLICKED, CLICKED, CLICKED, CLICKED, CLICKED};
+
+//CALIBRACAO DO TOUCH: MATRIZ DO PAINEL (ORIENTACAO 0) E A USADA NO TOQUE
+touch_calib touch_panel;
+touch_calib touch_map;
+uint8_t lcd_orientation = ILI9488_SWITCH_XY; // MADCTL 0x48 do ili9488_init()
+
+//ALVOS DA TELA DE CALIBRACAO
+const touch_point calib_targets[3] = {{32, 48}, {288, 240}, {96, 432}};
+
+//TIMERS DA INTERFACE (O CICLO E A CONTAGEM FICAM EM wash_flow.c)
+timebase_timer gesture_timer;
+timebase_timer highlight_timer;
+timebase_timer door_msg_timer;
+timebase_timer dim_timer;
+timebase_timer console_touch_timer;
+timebase_timer frame_timer;
+touch_point console_touch;     // posicao do toque injetado, para o release
+uint8_t backlight_on = 1;
 //###############################################################################################################
 //CONFIGURAR E ETC
 
-//DESENHA A FONTE EM TEXTO NA TELA
-void font_draw_text(tFont *font, const char *text, int x, int y, int spacing) {
-	char *p = text;
-	while(*p != NULL) {
-		char letter = *p;
-		int letter_offset = letter - font->start_char;
-		if(letter <= font->end_char) {
-			tChar *current_char = font->chars + letter_offset;
-			ili9488_draw_pixmap(x, y, current_char->image->width, current_char->image->height, current_char->image->data);
-			x += current_char->image->width + spacing;
-		}
-		p++;
-	}
-}
-
 static void configure_lcd(void){
 	/* Initialize display parameter */
 	g_ili9488_display_opt.ul_width = ILI9488_LCD_WIDTH;
@@ -180,49 +247,11 @@ static void configure_lcd(void){
 	ili9488_init(&g_ili9488_display_opt);
 }
 
-/**
- * \brief Set maXTouch configuration
- *
- * This function writes a set of predefined, optimal maXTouch configuration data
- * to the maXTouch Xplained Pro.
- *
- * \param device Pointer to mxt_device struct
- */
+//BARRAMENTO DO MAXTOUCH; OS OBJETOS DO CHIP SAO CONFIGURADOS EM touch.c
 static void mxt_init(struct mxt_device *device)
 {
 	enum status_code status;
 
-	/* T8 configuration object data */
-	uint8_t t8_object[] = {
-		0x0d, 0x00, 0x05, 0x0a, 0x4b, 0x00, 0x00,
-		0x00, 0x32, 0x19
-	};
-
-	/* T9 configuration object data */
-	uint8_t t9_object[] = {
-		0x8B, 0x00, 0x00, 0x0E, 0x08, 0x00, 0x80,
-		0x32, 0x05, 0x02, 0x0A, 0x03, 0x03, 0x20,
-		0x02, 0x0F, 0x0F, 0x0A, 0x00, 0x00, 0x00,
-		0x00, 0x18, 0x18, 0x20, 0x20, 0x00, 0x00,
-		0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x02,
-		0x02
-	};
-
-	/* T46 configuration object data */
-	uint8_t t46_object[] = {
-		0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x03,
-		0x00, 0x00
-	};
-	
-	/* T56 configuration object data */
-	uint8_t t56_object[] = {
-		0x02, 0x00, 0x01, 0x18, 0x1E, 0x1E, 0x1E,
-		0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E,
-		0x1E, 0x1E, 0x1E, 0x1E, 0x00, 0x00, 0x00,
-		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-		0x00, 0x00, 0x00, 0x00, 0x00
-	};
-
 	/* TWI configuration */
 	twihs_master_options_t twi_opt = {
 		.speed = MXT_TWI_SPEED,
@@ -232,45 +261,7 @@ static void mxt_init(struct mxt_device *device)
 	status = (enum status_code)twihs_master_setup(MAXTOUCH_TWI_INTERFACE, &twi_opt);
 	Assert(status == STATUS_OK);
 
-	/* Initialize the maXTouch device */
-	status = mxt_init_device(device, MAXTOUCH_TWI_INTERFACE,
-			MAXTOUCH_TWI_ADDRESS, MAXTOUCH_XPRO_CHG_PIO);
-	Assert(status == STATUS_OK);
-
-	/* Issue soft reset of maXTouch device by writing a non-zero value to
-	 * the reset register */
-	mxt_write_config_reg(device, mxt_get_object_address(device,
-			MXT_GEN_COMMANDPROCESSOR_T6, 0)
-			+ MXT_GEN_COMMANDPROCESSOR_RESET, 0x01);
-
-	/* Wait for the reset of the device to complete */
-	delay_ms(MXT_RESET_TIME);
-
-	/* Write data to configuration registers in T7 configuration object */
-	mxt_write_config_reg(device, mxt_get_object_address(device,
-			MXT_GEN_POWERCONFIG_T7, 0) + 0, 0x20);
-	mxt_write_config_reg(device, mxt_get_object_address(device,
-			MXT_GEN_POWERCONFIG_T7, 0) + 1, 0x10);
-	mxt_write_config_reg(device, mxt_get_object_address(device,
-			MXT_GEN_POWERCONFIG_T7, 0) + 2, 0x4b);
-	mxt_write_config_reg(device, mxt_get_object_address(device,
-			MXT_GEN_POWERCONFIG_T7, 0) + 3, 0x84);
-
-	/* Write predefined configuration data to configuration objects */
-	mxt_write_config_object(device, mxt_get_object_address(device,
-			MXT_GEN_ACQUISITIONCONFIG_T8, 0), &t8_object);
-	mxt_write_config_object(device, mxt_get_object_address(device,
-			MXT_TOUCH_MULTITOUCHSCREEN_T9, 0), &t9_object);
-	mxt_write_config_object(device, mxt_get_object_address(device,
-			MXT_SPT_CTE_CONFIGURATION_T46, 0), &t46_object);
-	mxt_write_config_object(device, mxt_get_object_address(device,
-			MXT_PROCI_SHIELDLESS_T56, 0), &t56_object);
-
-	/* Issue recalibration command to maXTouch device by writing a non-zero
-	 * value to the calibrate register */
-	mxt_write_config_reg(device, mxt_get_object_address(device,
-			MXT_GEN_COMMANDPROCESSOR_T6, 0)
-			+ MXT_GEN_COMMANDPROCESSOR_CALIBRATE, 0x01);
+	touch_device_init(device);
 }
 
 //MUDA O VALOR NO PINO
@@ -283,334 +274,380 @@ void pin_toggle(Pio *pio, uint32_t mask){
 
 //###############################################################################################################
 
-//DESENHA A TELA BRANCA DE FUNDO
-void draw_screen(void) {
-	ili9488_set_foreground_color(COLOR_CONVERT(COLOR_WHITE));
-	ili9488_draw_filled_rectangle(0, 0, ILI9488_LCD_WIDTH-1, ILI9488_LCD_HEIGHT-1);
-}
+//###############################################################################################################
+//CALIBRACAO DO TOUCH
 
-//PINTA QUADRADO BRANCO SEM O LOCK
-void draw_lockscreen(void) {
-	ili9488_set_foreground_color(COLOR_CONVERT(COLOR_WHITE));
-	ili9488_draw_filled_rectangle(93, 0, ILI9488_LCD_WIDTH-1, 93);
-	ili9488_draw_filled_rectangle(0, 94, ILI9488_LCD_WIDTH-1, ILI9488_LCD_HEIGHT-1);
+void draw_calib_target(touch_point p, uint32_t color){
+	ili9488_set_foreground_color(COLOR_CONVERT(color));
+	ili9488_draw_line(p.x - 10, p.y, p.x + 10, p.y);
+	ili9488_draw_line(p.x, p.y - 10, p.x, p.y + 10);
 }
 
-//TROCA O ICON DO BUTTON DESENHADO
-void draw_icon_button(button b) {
-	if(b.state == RELEASED) {
-		ili9488_draw_pixmap(b.x0, b.y0, b.icon2.width, b.icon2.height, b.icon2.data);
-	} else if(b.state == CLICKED){
-		ili9488_draw_pixmap(b.x0, b.y0, b.icon1.width, b.icon1.height, b.icon1.data);
-	}
-}
+//ESPERA UM TOQUE E RETORNA A POSICAO CRUA DO PRESS
+static touch_point read_raw_touch(struct mxt_device *device){
+	struct mxt_touch_event touch_event;
+	touch_point p = {0, 0};
+	uint8_t pressed = 0;
 
-//DESENHA DE ACORDO COM STRUCT
-void draw_wash_mode(t_ciclo cicles[] ,uint8_t mode) {
-	
-	if (mode >= 0){
-		
-		char nome[32];
-		char enxagueTempo[32];
-		char enxagueQnt[32];
-		char centrifugacaoRPM[32];
-		char centrifugacaoTempo[32];
-		
-		//LIMPAR A TELA
-		if (cleanScreen){
-			ili9488_set_foreground_color(COLOR_CONVERT(COLOR_WHITE));
-			ili9488_draw_filled_rectangle(RECTX, RECTY, ILI9488_LCD_WIDTH-1, RECTY2);
-			cleanScreen = 0;
+	while (true){
+		if (!mxt_is_message_pending(device) || mxt_read_touch_event(device, &touch_event) != STATUS_OK){
+			continue;
+		}
+		if (touch_event.status & MXT_PRESS_EVENT){
+			p.x = touch_event.x;
+			p.y = touch_event.y;
+			pressed = 1;
+		} else if (pressed && (touch_event.status & MXT_RELEASE_EVENT)){
+			return p;
 		}
-		sprintf(nome,"%s",cicles[mode].nome);
-		font_draw_text(&calibri_24, nome, TEXTX, NAMEY, SPACE);
-		
-		sprintf(enxagueTempo,"%d minutos",cicles[mode].enxagueTempo);
-		font_draw_text(&calibri_24, enxagueTempo, TEXTX, TEMPY, SPACE);
-		
-		sprintf(enxagueQnt,"%d enxagues",cicles[mode].enxagueQnt);
-		font_draw_text(&calibri_24, enxagueQnt, TEXTX, EXAQY, SPACE);
-		
-		sprintf(centrifugacaoRPM,"%d RPM",cicles[mode].centrifugacaoRPM);
-		font_draw_text(&calibri_24, centrifugacaoRPM, TEXTX, RPMY, SPACE);
-		
-		sprintf(centrifugacaoTempo,"%d minutos",cicles[mode].centrifugacaoTempo);
-		font_draw_text(&calibri_24, centrifugacaoTempo, TEXTX, CTIMY, SPACE);
 	}
 }
 
-//DESENHA O BOT�O DA LISTA
-void draw_buttons(button b[], int size){
-	for (int i = 0; i < size; i++){
-		draw_icon_button(b[i]);
-	}	
-}
+//TELA DE CALIBRACAO: 3 ALVOS -> MATRIZ AFIM
+void calibrate_touch(struct mxt_device *device){
+	touch_point raw[3];
+	touch_calib m;
 
-//DESENHA A MENSAGEM DE FECHAR A PORTA
-void draw_closeDoor(int shouldIDrawTheCloseTheDoorMessage){
-	char aviso[32];
-	
-	if (shouldIDrawTheCloseTheDoorMessage) {
-		draw_screen();
-	
-		sprintf(aviso,"%s","FECHAR PORTA!");
-		font_draw_text(&calibri_24, aviso, CLOSEX, CLOSEY, SPACE);
+	draw_screen();
+	font_draw_text(&calibri_24, "TOQUE NOS ALVOS", 60, 200, SPACE);
+	for (int i = 0; i < 3; i++){
+		draw_calib_target(calib_targets[i], COLOR_BLACK);
+		raw[i] = read_raw_touch(device);
+		draw_calib_target(calib_targets[i], COLOR_WHITE);
 	}
-	else {
-		ili9488_set_foreground_color(COLOR_CONVERT(COLOR_WHITE));
-		ili9488_draw_filled_rectangle(CLOSEX, CLOSEY, ILI9488_LCD_WIDTH-1, CLOSEY2);
+
+	if (touch_calib_compute(&m, raw, calib_targets)){
+		m.width = touch_map.width;
+		m.height = touch_map.height;
+		touch_calib_to_panel(&m, lcd_orientation, &touch_panel);
+		touch_calib_orient(&touch_panel, lcd_orientation, &touch_map);
 	}
+	screens_repaint();
 }
 
-//DESENHA O TIMER
-void draw_timer(){
-	
-	char tim[32];
-		
-	sprintf(tim,"%02d:%02d",minute, second);
-	font_draw_text(&calibri_24, tim, ILI9488_LCD_WIDTH/2 - 30, ILI9488_LCD_HEIGHT - 210, SPACE);
-}
+//###############################################################################################################
+//HANDLERS
 
-//DESENHA O DISPLAY GERAL
-void draw_display(button b[], int size, t_ciclo cicles[] ,uint8_t mode) {
+//TEMPO EM ms DESDE O BOOT, 32 BITS PARA OS GESTOS E CARIMBOS DOS EVENTOS
+uint32_t ms_now(void){
+	return (uint32_t)clock_now_ms();
+}
 
-	draw_icon_button(b[0]);
+/**
+*  Borda numa entrada do PIO (input_pio.c): so carimba e posta, o debounce e no main
+*/
+static void on_input_edge(uint8_t index){
+	event_queue_post(&button_events, EV_BUTTON, index, ms_now());
+}
 
-	if(locked){
-		draw_lockscreen();
-		//COMECOU A LAVAGEM
-		if (isWashing == WASHING){
-			draw_timer(minute,second);
-		}
-		//TERMINOU A LAVAGEM
-		else if (isWashing == FINISHED){
-			font_draw_text(&calibri_24, "yah boi terminou", ILI9488_LCD_WIDTH/2 - 30, ILI9488_LCD_HEIGHT - 210, SPACE);
-		}
-	}else{
-		draw_buttons(b,size);
-		draw_wash_mode(cicles,mode);
-	}
+/**
+*  Fim de linha na USART (serial_tx.c): so avisa, o console interpreta no main
+*/
+static void on_console_line(void){
+	event_queue_post(&console_events, EV_CONSOLE, 0, ms_now());
+}
 
+/**
+*  Handle borda de descida do CHG: o maXTouch tem mensagem na fila. O stamp e
+*  o inicio da amostra de latencia, entao a espera na fila entra na conta
+*/
+static void Touch_Handler(uint32_t id, uint32_t mask){
+	event_queue_post(&touch_events, EV_TOUCH, 0, latency_now());
+}
 
+/**
+* Alarme do relogio (RTT_Handler em clock_rtt.c): algum prazo da timebase venceu
+*/
+static void on_clock_alarm(void){
+	event_queue_post(&timer_events, EV_TIMER, 0, ms_now());
 }
 
 //###############################################################################################################
-//CONVERTS
-uint32_t convert_axis_system_x(uint32_t touch_y) {
-	// entrada: 4096 - 0 (sistema de coordenadas atual)
-	// saida: 0 - 320
-	return ILI9488_LCD_WIDTH - ILI9488_LCD_WIDTH*touch_y/4096;
+
+
+//###############################################################################################################
+//EVENTOS
+
+//IMPRIME A CARGA DA CPU E OS WAKEUPS DO ESTADO QUE ESTA ACABANDO
+void report_load(const char *state){
+	event_loop_stats st;
+	tx_ring_stats tx;
+
+	event_loop_get_stats(&st);
+	if (st.wall_ms){
+		printf("\n\r%s: carga %lu/1000, %lu wakeups em %lu ms (%lu/min)\n\r", state,
+				(unsigned long)event_loop_load_permille(), (unsigned long)st.wakeups,
+				(unsigned long)st.wall_ms, (unsigned long)((uint64_t)st.wakeups * 60000 / st.wall_ms));
+		event_queue_dump(event_sources, EVENT_SOURCES_SIZE);
+		serial_tx_get_stats(&tx);
+		printf("serial     %u/%u max %u, %lu bytes, %lu descartados, %lu esperas\n\r", tx.depth, tx.capacity,
+				tx.high_water, (unsigned long)tx.written, (unsigned long)tx.dropped, (unsigned long)tx.blocked);
+	}
+	for (uint8_t i = 0; i < EVENT_SOURCES_SIZE; i++){
+		event_queue_stats q;
+		event_queue_get_stats(event_sources[i], &q);
+		telem_queue(i, q.depth, q.high_water, q.dropped);
+	}
+	event_loop_reset_stats();
 }
 
-uint32_t convert_axis_system_y(uint32_t touch_x) {
-	// entrada: 0 - 4096 (sistema de coordenadas atual)
-	// saida: 0 - 320
-	return ILI9488_LCD_HEIGHT*touch_x/4096;
+void on_dim(timebase_timer *t){
+	pio_set_pin_low(LCD_SPI_BACKLIGHT_PIO);
+	backlight_on = 0;
 }
 
-//###############################################################################################################
-//HANDLERS
-/**
-*  Handle Interrupcao botao 1
-*/
-static void Button1_Handler(uint32_t id, uint32_t mask){
-	if(!locked){
-		flag_led = !flag_led;
-		pin_toggle(LED_PIO, LED_PIN_MASK);
+//QUALQUER TOQUE ACENDE A TELA E REINICIA O TIMEOUT (CANCELAR + INSERIR E O(1))
+void screen_activity(void){
+	if (!backlight_on){
+		pio_set_pin_high(LCD_SPI_BACKLIGHT_PIO);
+		backlight_on = 1;
 	}
+	timebase_start(&dim_timer, timebase_now() + SCREEN_DIM_MS, on_dim);
 }
 
-/**
-* \brief Interrupt handler for the RTC. Refresh the display.
-*/
-void RTC_Handler(void)
-{
-	uint32_t ul_status = rtc_get_status(RTC);
-	uint16_t hour;
-	uint16_t m;
-	uint16_t se;
-	//INTERRUP��O POR SEGUNDO
-	if ((ul_status & RTC_SR_SEC) == RTC_SR_SEC) {
-		rtc_clear_status(RTC, RTC_SCCR_SECCLR);
-		//MUDA AS VARIAVEIS DE ACORDO COM O TEMPO
-		if ((isLocking >=1 && isLocking <4) && (event_status > 32 && event_status <192)){
-			isLocking++;
-		}
-		else if( isLocking >= 4){
-			locked = !locked;
-			buttons2[0]->state = buttons2[0]->state == 1 ? 2 : 1;
-			isLocking = 0;
-		}
-		if (isWashing==1){
-			if (second == 0){
-				minute--;
-				second = 59;
-				}else{
-				second--;
-			}
-		}
+//BYTES RECEBIDOS PARA O CONSOLE; SO RODA QUANDO CHEGOU UMA LINHA
+void console_poll(void){
+	char c;
 
-		
+	while (serial_rx_getc(&c)){
+		console_feed(c);
 	}
-	
-	//INTERRUP��O POR ALARME
-	if ((ul_status & RTC_SR_ALARM) == RTC_SR_ALARM) {
-		//Terminou a lavagem mudando valor da variavel para o mesmo
-		if (isWashing == 1){
-			isWashing = 2 ;
-		}
+}
 
-		rtc_clear_status(RTC, RTC_SCCR_ALRCLR);
-			
+//chg_stamp: latency_now() DA BORDA DO CHG
+void on_touch(struct mxt_device *device, uint32_t chg_stamp){
+	if (mxt_is_message_pending(device)){
+		screen_activity();
 	}
-	
-	rtc_clear_status(RTC, RTC_SCCR_ACKCLR);
-	rtc_clear_status(RTC, RTC_SCCR_TIMCLR);
-	rtc_clear_status(RTC, RTC_SCCR_CALCLR);
-	rtc_clear_status(RTC, RTC_SCCR_TDERRCLR);
-	
+	touch_read(device, chg_stamp);
 }
 
-int mxt_handler(struct mxt_device *device, uint16_t *x, uint16_t *y, uint16_t *event_status)
-{
-	/* USART tx buffer initialized to 0 */
-	char tx_buf[STRING_LENGTH * MAX_ENTRIES] = {0};
-	uint8_t i = 0; /* Iterator */
-	uint8_t found =0;
+//CONTAGEM, TROCA DE FASE E FIM DO CICLO (wash_flow.c)
+void on_wash_flow(uint8_t ev, const wash_phase *ph){
+	if (ev == WASH_FLOW_EV_PHASE){
+		telem_phase(wash_mode, ph->type, ph->index, wash_flow_seconds_left());
+	}
+	else if (ev == WASH_FLOW_EV_DONE){
+		TLOG(FIM);
+		report_load("lavando");
+	}
+	frame_request();
+}
 
-	/* Temporary touch event data struct */
-	struct mxt_touch_event touch_event;
+//REGISTROS INTEIROS DO tlog DENTRO DA TELEMETRIA; O QUADRO SO VAI PARA O
+//ANEL DA SERIAL SE COUBER, ENTAO NADA ESPERA A LINHA
+void telemetry_flush(void){
+	uint8_t buf[64];
+	uint16_t n;
 
-	/* Collect touch events and put the data in a string,
-	 * maximum 2 events at the time */
-	do {
-		/* Temporary buffer for each new touch event line */
-		char buf[STRING_LENGTH];
-	
-		/* Read next next touch event in the queue, discard if read fails */
-		if (mxt_read_touch_event(device, &touch_event) != STATUS_OK) {
-			continue;
+	while ((n = tlog_drain(buf, sizeof(buf))) != 0){
+		telem_log(buf, n);
+	}
+	telem_flush();
+}
+
+//DESENHA UM QUADRO E MANDA O TEMPO DE RENDERIZACAO, OS BYTES QUE FORAM PARA
+//O LCD E, SE PASSOU DO ORCAMENTO, A CHAMADA DE DESENHO MAIS CARA
+void draw_display_timed(uint8_t mode){
+	uint32_t spi = ili9488_spi_bytes;
+	frame_stats f;
+	ui_view view = {
+		.locked = locked,
+		.door_msg = door_msg,
+		.wash_state = wash_flow_get_state(),
+		.mode = mode,
+		.button_state = button_state,
+	};
+
+	if (view.wash_state == WASH_FLOW_WASHING){
+		view.seconds_left = wash_flow_seconds_left();
+		view.phase = wash_flow_phase()->type;
+	}
+	frame_begin(timebase_now(), prof_ticks());
+	draw_display(&view);
+	spi = ili9488_spi_bytes - spi;
+	//O SPI DO DRIVER BLOQUEIA: O TEMPO NO FIO JA ESTA DENTRO DO RENDER
+	bool overrun = frame_end(timebase_now(), prof_ticks(), (uint64_t)spi * 8 * 1000000 / ILI9488_SPI_BAUDRATE);
+	if (!RENDER_ON(RENDER_TELEMETRY)){
+		return;
+	}
+	frame_get_stats(&f);
+	telem_frame(f.last_us);
+	telem_bus(spi);
+	if (overrun){
+		telem_overrun(f.last_us, f.flush_us, f.worst_call, f.worst_call_us);
+	}
+}
+
+void on_frame_timer(timebase_timer *t);
+
+//DESENHA O QUADRO PENDENTE SE O PERIODO JA CHEGOU; SENAO ARMA O frame_timer
+//PARA O INICIO DO PROXIMO, E O CALLBACK DELE VOLTA AQUI
+void frame_service(void){
+	if (frame_ready(timebase_now())) {
+		draw_display_timed(wash_mode);
+		if (RENDER_ON(RENDER_LATENCY) && latency_count() >= LATENCY_DUMP_EVERY){
+			latency_dump();
+			latency_reset();
 		}
-		
-		 // eixos trocados (quando na vertical LCD)
-		uint32_t conv_x = convert_axis_system_x(touch_event.y);
-		uint32_t conv_y = convert_axis_system_y(touch_event.x);
-		
-		//printf("%d", conv_x);
-		//printf("%d", conv_y);
-		//printf("\nstatus do evento: %d",touch_event.status);
-		if (touch_event.status == 192)
-			found = 1;
-	
-		*x = conv_x;
-		*y = conv_y;
-		*event_status = touch_event.status;
-		
-		/* Format a new entry in the data string that will be sent over USART */
-		//sprintf(buf, "Nr: %1d, X:%4d, Y:%4d, Status:0x%2x conv X:%3d Y:%3d\n\r",
-				//touch_event.id, touch_event.x, touch_event.y,
-				//touch_event.status, conv_x, conv_y);
-		//update_screen(conv_x, conv_y);
+	} else if (frame_pending()) {
+		/* Periodo ainda nao chegou (ou o quadro anterior ainda ocupa): acorda nele */
+		timebase_start(&frame_timer, frame_next_ms(), on_frame_timer);
+	}
+}
 
-		/* Add the new string to the string buffer */
-		strcat(tx_buf, buf);
-		i++;
+void on_frame_timer(timebase_timer *t){
+	(void)t;
+	frame_service();
+}
 
-		/* Check if there is still messages in the queue and
-		 * if we have reached the maximum numbers of events */
-	} while ((mxt_is_message_pending(device)) & (i < MAX_ENTRIES));
+void on_highlight_revert(timebase_timer *t){
+	button_state[BUT_START] = CLICKED;
+	frame_request();
+}
+
+//APAGA O AVISO; O MENU VOLTA NO PROXIMO QUADRO
+void on_door_msg_timeout(timebase_timer *t){
+	door_msg = 0;
+	frame_request();
+}
 
-	/* If there is any entries in the buffer, send them over USART */
-	if (i > 0) {
-		usart_serial_write_packet(USART_SERIAL_EXAMPLE, (uint8_t *)tx_buf, strlen(tx_buf));
+//CANCELA O CICLO EM CURSO E VOLTA PARA O MENU DESBLOQUEADO
+void cancel_washing(void){
+	TLOG(CANCELA);
+	report_load("lavando");
+	wash_flow_reset();
+	locked = 0;
+	button_state[BUT_LOCK] = RELEASED;
+	frame_request();
+}
+
+//ENTRADAS JA COM DEBOUNCE (input.c)
+void on_input(const input_event *ev){
+	TLOG3(ENTRADA, ev->index, ev->type, ev->duration);
+	switch (ev->index){
+		case IN_BUT1:
+			if (ev->type == INPUT_PRESS && !locked){
+				flag_led = !flag_led;
+				pin_toggle(LED_PIO, LED_PIN_MASK);
+			}
+			else if (ev->type == INPUT_HOLD && wash_flow_get_state() != WASH_FLOW_IDLE){
+				cancel_washing();
+			}
+			break;
+		default: break;
 	}
-	
-	return(found);
 }
 
-//###############################################################################################################
+void on_gesture_timer(timebase_timer *t){
+	gesture_poll(ms_now());
+}
 
+//ARMA O TIMER DO LONG-PRESS; O PRAZO DOS GESTOS E ms DE 32 BITS
+void arm_gesture_timer(void){
+	uint32_t deadline;
 
-//###############################################################################################################
-//CALL BACKS
-void callback_lock(button *b){
-	printf("\nCALLBACK DO LOCK");
-	if(isLocking < 1 ){
-		isLocking = 1 ;
+	if (gesture_next_deadline(&deadline)){
+		uint64_t now = timebase_now();
+		int32_t dt = (int32_t)(deadline - (uint32_t)now);
+		timebase_start(&gesture_timer, dt > 0 ? now + dt : now, on_gesture_timer);
+	} else {
+		timebase_stop(&gesture_timer);
 	}
-	isWashing = 0;
-	//draw_lockscreen();
+}
 
+//ESVAZIA AS FILAS NA ORDEM DE event_sources E CHAMA O HANDLER DE CADA EVENTO
+void dispatch_events(struct mxt_device *device){
+	event ev;
+
+	PROF_BEGIN(DISPATCH);
+	for (uint8_t i = 0; i < EVENT_SOURCES_SIZE; i++){
+		while (event_queue_get(event_sources[i], &ev)){
+			switch (ev.type){
+				case EV_TOUCH:  on_touch(device, ev.stamp);  break;
+				case EV_BUTTON: input_edge(ev.arg, ev.stamp); break;
+				case EV_TIMER:  timebase_process(); break;
+				case EV_CONSOLE: console_poll(); break;
+				default: break;
+			}
+		}
+	}
+	PROF_END(DISPATCH);
 }
 
-void callback_wash_buttons(button *b, uint8_t index){
-	b->state = b->state == 1 ? 2 : 1;
-	wash_mode = index-2;
-	cleanScreen = 1;
-	isWashing = 0;
+//###############################################################################################################
+//CALL BACKS
+void callback_lock(const button *b, uint8_t index){
+	report_load(locked ? "bloqueado" : "desbloqueado");
+	locked = !locked;
+	TLOG1(LOCK, locked);
+	button_state[index] = button_state[index] == CLICKED ? RELEASED : CLICKED;
+	wash_flow_reset();
 }
 
-void callback_fast_wash(button *b){
-	b->state = b->state == 1 ? 2 : 1;
-	cleanScreen = 1;
+void callback_wash_buttons(const button *b, uint8_t index){
+	button_state[index] = button_state[index] == CLICKED ? RELEASED : CLICKED;
+	wash_mode = index - BUT_FIRST_CICLE;
+	wash_flow_reset();
 }
 
-void handler_wash_buttons(button buttons[], int size){
-	for (int i = 2; i<size; i++){
-		buttons[i].state = 1;
+void handler_wash_buttons(int size){
+	for (int i = BUT_FIRST_CICLE; i<size; i++){
+		button_state[i] = CLICKED;
 	}
 }
 
-void callback_start(button *b, uint8_t index){
-	b->state = b->state == 1 ? 2 : 1;
+void callback_start(const button *b, uint8_t index){
+	button_state[index] = button_state[index] == CLICKED ? RELEASED : CLICKED;
+	timebase_start(&highlight_timer, timebase_now() + PRESS_HIGHLIGHT_MS, on_highlight_revert);
 	
 	if (flag_led){
 		//SETA A FLAG DE LAVANDO
-		printf("flag led ativado: %d",flag_led);
-		uint16_t hour;
-		uint16_t m;
-		uint16_t se;
+		TLOG2(START, wash_mode, flag_led);
 		
-		isWashing = 1;	
-		washingLockScreen = 1;
-		draw_closeDoor(0);
+		report_load("desbloqueado");
+		timebase_stop(&door_msg_timer);
+		door_msg = 0;
 		
-		rtc_get_time(RTC,&hour,&m,&se);
-		rtc_set_time_alarm(RTC, 1, hour, 1, m + wash_times[index-2], 1, se);
 		locked = 1;
-		buttons2[0]->state = 1;
-		draw_lockscreen();
-
-
+		wash_flow_start(wash_mode, &cycle_table[wash_mode].program);
+		button_state[BUT_LOCK] = CLICKED;
 	}else{
-		draw_closeDoor(1);
+		door_msg = 1;
+		timebase_start(&door_msg_timer, timebase_now() + DOOR_MSG_MS, on_door_msg_timeout);
 	}
 	
 }
 
-//###############################################################################################################
-//FUN��ES
-
-void BUT_init(void){
-	/* config. pino botao em modo de entrada */
-	pmc_enable_periph_clk(BUT_PIO_ID);
-	pio_set_input(BUT_PIO, BUT_PIN_MASK, PIO_PULLUP | PIO_DEBOUNCE);
+//VOLTOU DE UMA QUEDA NO MEIO DO CICLO: CAI DIRETO NA TELA DA LAVAGEM,
+//BLOQUEADA, SEM PASSAR PELO MENU (O draw_display DO LOOP DESENHA SO ELA)
+void resume_washing(void){
+	wash_checkpoint cp;
 
-	/* config. interrupcao em borda de descida no botao do kit */
-	/* indica funcao (but_Handler) a ser chamada quando houver uma interrup??o */
-	pio_enable_interrupt(BUT_PIO, BUT_PIN_MASK);
-	pio_handler_set(BUT_PIO, BUT_PIO_ID, BUT_PIN_MASK, PIO_IT_FALL_EDGE, Button1_Handler);
-
-	/* habilita interrup?c?o do PIO que controla o botao */
-	/* e configura sua prioridade                        */
-	NVIC_EnableIRQ(BUT_PIO_ID);
-	NVIC_SetPriority(BUT_PIO_ID, 1);	
+	if (!wash_checkpoint_load(&cp) || cp.program >= CYCLE_COUNT){
+		return;
+	}
+	if (wash_flow_resume(cp.program, &cycle_table[cp.program].program, cp.phase, cp.deadline_ms)){
+		TLOG2(RETOMA, cp.program, cp.phase);
+		wash_mode = cp.program;
+		locked = 1;
+		button_state[BUT_LOCK] = CLICKED;
+		frame_request();
+	}
 }
 
+//###############################################################################################################
+//FUN��ES
+
 void RTC_init(){
 	/* Configura o PMC */
 	pmc_enable_periph_clk(ID_RTC);
 
+	/* Reset quente: o RTC esta no dominio de backup e continua com a hora certa */
+	if (backup_retained()){
+		return;
+	}
+
 	/* Default RTC configuration, 24-hour mode */
 	rtc_set_hour_mode(RTC, 0);
 
@@ -618,16 +655,19 @@ void RTC_init(){
 	rtc_set_date(RTC, YEAR, MOUNTH, DAY, WEEK);
 	rtc_set_time(RTC, HOUR, MINUTE, SECOND);
 
-	/* Configure RTC interrupts */
-	NVIC_DisableIRQ(RTC_IRQn);
-	NVIC_ClearPendingIRQ(RTC_IRQn);
-	NVIC_SetPriority(RTC_IRQn, 0);
-	NVIC_EnableIRQ(RTC_IRQn);
+	/* Sem interrupcoes: o tempo da lavagem vem da timebase (RTT) */
 
-	/* Ativa interrupcao via alarme */
-	rtc_enable_interrupt(RTC,  RTC_IER_ALREN);
-	rtc_enable_interrupt(RTC,  RTC_IER_SECEN);
+}
+
+void TOUCH_init(void){
+	/* CHG como entrada; borda de descida = mensagem nova no maXTouch */
+	pmc_enable_periph_clk(CHG_PIO_ID);
+	pio_set_input(CHG_PIO, CHG_PIN_MASK, PIO_PULLUP);
+	pio_handler_set(CHG_PIO, CHG_PIO_ID, CHG_PIN_MASK, PIO_IT_FALL_EDGE, Touch_Handler);
+	pio_enable_interrupt(CHG_PIO, CHG_PIN_MASK);
 
+	NVIC_EnableIRQ(CHG_PIO_ID);
+	NVIC_SetPriority(CHG_PIO_ID, 1);
 }
 
 void LED_init(int estado){
@@ -635,41 +675,147 @@ void LED_init(int estado){
 	pio_set_output(LED_PIO, LED_PIN_MASK, estado, 0, 0 );
 };
 
-//CALCULA O TEMPO DE LAVAGEM DO CICLO
-int wash_time(t_ciclo cicles[], uint8_t mode){
-	int t = cicles[mode].enxagueTempo * cicles[mode].enxagueQnt + cicles[mode].centrifugacaoTempo;
-	
-	if (cicles[mode].heavy){
-		t = t*1.2;
+
+//ESCOLHE O CICLO E MARCA O BOTAO DELE
+void select_wash_mode(uint8_t mode){
+	wash_mode = mode;
+	handler_wash_buttons(BUTTONS_SIZE);
+	//A TABELA PODE TER MAIS CICLOS QUE BOTOES; OS OUTROS SO PELO SWIPE
+	if (wash_mode < CICLE_BUTTONS){
+		button_state[BUT_FIRST_CICLE + wash_mode] = RELEASED;
 	}
-	
-	return 1;
 }
 
-int isPressed(button b, uint16_t x, uint16_t y){
-	tImage icon = b.state == 1 ? b.icon1 : b.icon2;
-	
-	if (x >= b.x0 && x <= (b.x0 + icon.width)){
-		if (y >= b.y0 && y <= (b.y0 + icon.height)){
-			return 1;
-		}
-	}
-	return 0;
+//PASSA PARA O CICLO SEGUINTE (step = 1) OU ANTERIOR (step = -1)
+void step_wash_mode(int step){
+	select_wash_mode((wash_mode + CYCLE_COUNT + step) % CYCLE_COUNT);
 }
 
-int touch_buttons(button b[],uint8_t size , uint16_t xTouch, uint16_t yTouch){
-	for(int i = 0; i < size; i++){
-		if(isPressed(b[i], xTouch, yTouch)){
-			printf("Botao pressionado");
-			if(locked && i !=0){
-				return size+1;
+//TRATA OS GESTOS DO TOUCH
+void gesture_callback(const gesture_event *ev){
+	switch (ev->type){
+		case GESTURE_PRESS:
+		case GESTURE_LONG_PRESS: {
+			uint8_t hold = ev->type == GESTURE_LONG_PRESS;
+			uint8_t index = touch_buttons(&buttons_grid, BUTTONS_SIZE, locked, ev->x, ev->y);
+			if (index == (BUTTONS_SIZE+1) || buttons[index].long_press != hold){
+				break;
 			}
-		return i;
+			if (!hold){
+				handler_wash_buttons(BUTTONS_SIZE);
+			}
+			buttons[index].callback(&buttons[index], index);
+			latency_mark(LAT_CALLBACK);
+			frame_request();
+			break;
 		}
+		case GESTURE_SWIPE_LEFT:
+			if (!locked && wash_flow_get_state() == WASH_FLOW_IDLE){
+				step_wash_mode(1);
+				frame_request();
+			}
+			break;
+		case GESTURE_SWIPE_RIGHT:
+			if (!locked && wash_flow_get_state() == WASH_FLOW_IDLE){
+				step_wash_mode(-1);
+				frame_request();
+			}
+			break;
+		default:
+			break;
 	}
-	return size + 1;
 }
 
+//###############################################################################################################
+//CONSOLE (console.h): AS ACOES DOS COMANDOS, TODAS NO CONTEXTO DO MAIN
+
+void on_console_release(timebase_timer *t){
+	touch_point *p = &console_touch;
+
+	gesture_feed(CONSOLE_TOUCH_ID, GESTURE_T9_RELEASE, p->x, p->y, ms_now());
+	telem_touch(CONSOLE_TOUCH_ID, GESTURE_T9_RELEASE, p->x, p->y);
+}
+
+//PRESS AGORA E RELEASE DEPOIS DE hold_ms, PELO MESMO CAMINHO DO mxt_handler()
+void console_touch_inject(uint16_t x, uint16_t y, uint32_t hold_ms){
+	if (timebase_armed(&console_touch_timer)){
+		return;
+	}
+	console_touch.x = x;
+	console_touch.y = y;
+	screen_activity();
+	gesture_feed(CONSOLE_TOUCH_ID, GESTURE_T9_DETECT | GESTURE_T9_PRESS, x, y, ms_now());
+	telem_touch(CONSOLE_TOUCH_ID, GESTURE_T9_DETECT | GESTURE_T9_PRESS, x, y);
+	timebase_start(&console_touch_timer, timebase_now() + hold_ms, on_console_release);
+}
+
+//COMO O SWIPE: SO NO MENU DESBLOQUEADO E SEM LAVAGEM
+bool console_cycle(uint8_t id){
+	if (id >= CYCLE_COUNT || locked || wash_flow_get_state() != WASH_FLOW_IDLE){
+		return false;
+	}
+	select_wash_mode(id);
+	frame_request();
+	return true;
+}
+
+//ADIANTA O RELOGIO: FASES, CONTAGEM E TIMEOUTS QUE PASSARAM VENCEM AGORA
+void console_advance(uint32_t ms){
+	clock_skew(ms);
+	timebase_process();
+}
+
+void console_redraw(void){
+	screens_repaint();
+	frame_request();
+}
+
+void console_stats(void){
+	telem_stats t;
+	tlog_stats l;
+	frame_stats f;
+
+	report_load("console");
+	latency_dump();
+	telem_get_stats(&t);
+	tlog_get_stats(&l);
+	printf("telemetria %lu registros, %lu quadros, %lu bytes, %lu descartados\n\r", (unsigned long)t.records,
+			(unsigned long)t.frames, (unsigned long)t.bytes, (unsigned long)t.dropped);
+	printf("tlog       %u palavras, %lu registros, %lu descartados\n\r", l.depth, (unsigned long)l.records,
+			(unsigned long)l.dropped);
+	frame_get_stats(&f);
+	printf("quadros    %lu, %lu estouros, %lu periodos pulados, %lu pedidos juntados, ultimo %lu us, max %lu us\n\r",
+			(unsigned long)f.frames, (unsigned long)f.overruns, (unsigned long)f.skipped,
+			(unsigned long)f.coalesced, (unsigned long)f.last_us, (unsigned long)f.max_us);
+	if (f.overruns){
+		printf("           ultimo estouro: %s, %lu us\n\r", frame_call_name(f.worst_call),
+				(unsigned long)f.worst_call_us);
+	}
+	for (uint8_t i = 0; i < DMA_POOLS; i++){
+		dma_pool_stats d;
+		dma_get_stats(i, &d);
+		printf("dma %-10s %u/%u de %u bytes (%s), max %u, %lu sem bloco, %lu free invalido\n\r",
+				dma_pool_name(i), d.used, d.count, d.block, d.cached ? "cache" : "sem cache", d.high_water,
+				(unsigned long)d.failures, (unsigned long)d.bad_frees);
+	}
+}
+
+const console_ops console_actions = {
+	.touch = console_touch_inject,
+	.cycle = console_cycle,
+	.advance = console_advance,
+	.redraw = console_redraw,
+	.stats = console_stats,
+#if CONF_TCM_BENCH
+	.bench = tcm_bench,
+#else
+	.bench = NULL,
+#endif
+	.features = render_feature_names,
+	.feature_count = RENDER_FEATURES,
+	.feature_flags = &render_features,
+};
+
 //###############################################################################################################
 
 int main(void){
@@ -677,31 +823,29 @@ int main(void){
   sysclk_init(); /* Initialize system clocks */
 	WDT->WDT_MR = WDT_MR_WDDIS; // WatchDog
 	board_init();  /* Initialize board */
+	dma_pool_init(); /* Regiao sem cache do MPU e pools de DMA (dma_pools.def) */
+	clock_init(on_clock_alarm); /* RTT: tempo em ms, antes de qualquer espera */
+	prof_init(sysclk_get_cpu_hz()); /* Liga o contador de ciclos DWT; zonas de profiling (prof_zones.def) */
+	latency_init(sysclk_get_cpu_hz()); /* Histogramas touch->lcd, no relogio do prof */
+	tlog_init();
+	frame_init(FRAME_PERIOD_MS, FRAME_BUDGET_US, sysclk_get_cpu_hz()); /* Periodo e orcamento dos quadros */
 	LED_init(0); // Inicializa LED ligado
-	BUT_init(); // Inicializando Botao
+	input_init(input_pins, INPUTS_SIZE, on_input_edge, on_input); // Botoes e sensores do PIO
   
-	button b_lock =	 {.x0 = LOCX, .y0 = LOCY, .state = 1, .icon1 = lock_white, .icon2 = unlock_white, .callback = callback_lock};
-	button b_centrifuga = {.x0 = CENTRIFX, .y0 = LINEBUT1, .state = 1, .icon1 = centrifuge, .icon2 = centrifuge_click, .callback = callback_wash_buttons};
-	button b_fast = {.x0 = FASTX, .y0 = LINEBUT1, .state = 1, .icon1 = fast, .icon2 = fast_click, .callback = callback_wash_buttons};
-	button b_slow = {.x0 = SLOWX, .y0 = LINEBUT1, .state = 1, .icon1 = heavy, .icon2 = heavy_click, .callback = callback_wash_buttons};
-	button b_daily = {.x0 = DAYX, .y0 = LINEBUT2, .state = 1, .icon1 = daily, .icon2 = daily_click, .callback = callback_wash_buttons};
-	button b_enxague = {.x0 = ENXX, .y0 = LINEBUT2, .state = 1, .icon1 = water, .icon2 = water_click, .callback = callback_wash_buttons};
-	button b_start = {.x0 = STARTX, .y0 = STARTY, .state = 1, .icon1 = clean, .icon2 = clean_click, .callback = callback_start};	
-  	
-	const uint8_t size = 7;
-
-	button buttons[] = {b_lock, b_start, b_fast, b_centrifuga, b_slow, b_enxague, b_daily};	
-	
-	for (int i = 0; i<size;i++)
-	{
-		buttons2[i]=&buttons[i];
-	}
+	const uint8_t size = BUTTONS_SIZE;
+
+	/* Monta o indice de toque uma vez, das posicoes e tamanhos dos icones */
+	screens_hit_boxes(button_boxes);
+	touch_grid_build(&buttons_grid, button_boxes, size);
 	
 	struct mxt_device device; /* Device data container */
 
-	t_ciclo cicles[] = {c_rapido, c_centrifuga,c_pesado, c_enxague,c_diario};
-	
-	uint8_t cicles_size = 5;
+	const gesture_config gestures = {
+		.long_press_ms = LOCK_LONG_PRESS_MS,
+		.drag_px       = DRAG_MIN_PX,
+		.swipe_px      = SWIPE_MIN_PX,
+		.swipe_ms      = SWIPE_MAX_MS
+	};
 
 	/* Initialize the USART configuration struct */
 	const usart_serial_options_t usart_serial_options = {
@@ -712,48 +856,67 @@ int main(void){
 	};
 
 	configure_lcd();
-	draw_screen();
+	draw_splash();
+	screens_init();
 	
 	/** Configura RTC */
 	RTC_init();
 	/* Initialize the mXT touch device */
 	mxt_init(&device);
+
+	/* Matriz nominal do painel, derivada para a orientacao atual do LCD */
+	touch_calib_nominal(&touch_panel, ILI9488_LCD_HEIGHT, ILI9488_LCD_WIDTH);
+	touch_calib_orient(&touch_panel, lcd_orientation, &touch_map);
+	touch_init(&touch_map, ms_now);
+
+	/* Botao da placa pressionado no boot abre a tela de calibracao */
+	if (input_pressed(IN_BUT1)){
+		calibrate_touch(&device);
+	}
 	
 	/* Initialize stdio on USART */
 	stdio_serial_init(USART_SERIAL_EXAMPLE, &usart_serial_options);
-
-	for (int i = 0; i<cicles_size;i++)
-	{
-		wash_times[i]=wash_time(cicles,i);
+	serial_tx_init(); /* printf vai para o anel, a interrupcao da USART transmite */
+	telem_init(ms_now, serial_tx_free, serial_tx_write); /* Quadros COBS no mesmo anel */
+	console_init(&console_actions);
+	serial_rx_init(on_console_line); /* Comandos de bancada pela mesma USART */
+
+	/* Programas do usuario: le o log da flash uma vez e monta o indice */
+	if (kv_mount() == KV_OK){
+		TLOG1(BOOT, user_program_count());
 	}
-	
-	isWashing = 0;
+
+	/* Base de tempo, reconhecedor de gestos e loop de eventos */
+	timebase_init();
+	wash_flow_init(on_wash_flow);
+	resume_washing();
+	gesture_init(&gestures, gesture_callback);
+	event_loop_init(sysclk_get_cpu_hz(), ms_now, event_sources, EVENT_SOURCES_SIZE);
+	TOUCH_init();
+	screen_activity();
+
 	flag_led = 0;
 
+	/* Mensagens que chegaram antes de ligar a interrupcao do CHG */
+	on_touch(&device, latency_now());
+
 	while (true) {
-		/* Check for any pending messages and run message handler if any
-		 * message is found in the queue */
-		uint16_t x,y;
-		draw_display(buttons, size, cicles, wash_mode);
-		if (mxt_is_message_pending(&device)) {
-			uint8_t found = mxt_handler(&device, &x, &y, &event_status);
-			if(found){
-				uint8_t index = touch_buttons(buttons, size, x, y);
-				if (index != (size+1)){
-					handler_wash_buttons(buttons,size);
-					buttons[index].callback(&buttons[index], index, cicles, buttons);
-
-				}
-				
-				if (isWashing==1){
-					//CALCULA O TEMPO EM MINUTOS DO CICLO ESCOLHIDO
-					minute = wash_time(cicles, wash_mode);	
-				}
-				
-			}
-		
+		event_wait();
+		dispatch_events(&device);
+
+		/* Long-press pendente: acorda no prazo pelo alarme do RTT */
+		arm_gesture_timer();
+		timebase_process();
+
+		/* Telemetria e log tokenizado para a serial, so o que cabe no anel da USART */
+		telemetry_flush();
+
+		/* So redesenha quando algum handler mudou o estado, no maximo uma vez por
+		   periodo: o que mudar antes do proximo quadro sai junto com ele */
+		if (!RENDER_ON(RENDER_ONLY_DIRTY) && !frame_pending()) {
+			frame_request();
 		}
-		
+		frame_service();
 	}
 
 	return 0;
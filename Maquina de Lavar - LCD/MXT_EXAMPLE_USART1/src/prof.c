@@ -0,0 +1,138 @@
+/*
+ * prof.c
+ *
+ * O PROF_BEGIN e inline e so empilha; o fechamento (aqui) le o relogio
+ * antes da chamada e grava. Um PROF_END que nao fecha a zona do topo
+ * descarta a pilha inteira e conta um erro, para um retorno no meio de uma
+ * zona nao deslocar todas as medidas seguintes.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "prof.h"
+
+static const char *const zone_names[PROF_ZONES] = {
+#define PROF_ZONE(id, name) name,
+#include "prof_zones.def"
+#undef PROF_ZONE
+};
+
+static uint32_t ticks_per_us = 1;
+
+#if PROF_ENABLE
+
+prof_state prof;
+
+static uint8_t bucket(uint32_t us){
+	uint8_t b = 0;
+
+	while (us > 1 && b < PROF_BUCKETS - 1){
+		us >>= 1;
+		b++;
+	}
+	return b;
+}
+
+void prof_end_at(uint8_t zone, uint32_t now){
+	if (prof.depth == 0){
+		prof.errors++;
+		return;
+	}
+	if (--prof.depth >= PROF_DEPTH){
+		return;
+	}
+
+	prof_frame *f = &prof.stack[prof.depth];
+	if (f->zone != zone){
+		prof.errors++;
+		prof.depth = 0;
+		return;
+	}
+
+	uint32_t elapsed = now - f->start;
+	prof_stats *s = &prof.zones[zone];
+
+	s->count++;
+	s->total += elapsed;
+	s->self += elapsed - f->child;
+	if (elapsed < s->min){
+		s->min = elapsed;
+	}
+	if (elapsed > s->max){
+		s->max = elapsed;
+	}
+	s->hist[bucket(elapsed / ticks_per_us)]++;
+	if (prof.depth > 0){
+		prof.stack[prof.depth - 1].child += elapsed;
+	}
+}
+
+void prof_reset(void){
+	memset(&prof, 0, sizeof(prof));
+	for (uint8_t z = 0; z < PROF_ZONES; z++){
+		prof.zones[z].min = UINT32_MAX;
+	}
+}
+
+void prof_get_stats(uint8_t zone, prof_stats *stats){
+	*stats = prof.zones[zone];
+}
+
+#else
+
+void prof_reset(void){
+}
+
+void prof_get_stats(uint8_t zone, prof_stats *stats){
+	memset(stats, 0, sizeof(*stats));
+}
+
+#endif /* PROF_ENABLE */
+
+//UNICO LUGAR QUE LIGA O CYCCNT; latency, tlog, event_loop E frame_sched LEEM
+//PELO prof_ticks(), ENTAO ESTE VEM ANTES DELES NO BOOT
+void prof_init(uint32_t cpu_hz){
+#ifdef HOST_BUILD
+	(void)cpu_hz;
+	ticks_per_us = 1000;
+#else
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->LAR = 0xC5ACCE55;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	ticks_per_us = cpu_hz / 1000000 ? cpu_hz / 1000000 : 1;
+#endif
+	prof_reset();
+}
+
+const char *prof_zone_name(uint8_t zone){
+	return zone < PROF_ZONES ? zone_names[zone] : "?";
+}
+
+//TEMPOS EM us; O HISTOGRAMA COMO O DO latency_dump()
+void prof_dump(void){
+	prof_stats s;
+
+	if (!PROF_ENABLE){
+		printf("\n\rprofiler desligado (PROF_ENABLE 0)\n\r");
+		return;
+	}
+	printf("\n\rzonas (us)             n      min      max    media  proprio |\n\r");
+	for (uint8_t z = 0; z < PROF_ZONES; z++){
+		prof_get_stats(z, &s);
+		if (s.count == 0){
+			continue;
+		}
+		printf("%-20s %6lu %8lu %8lu %8lu %8lu |", zone_names[z], (unsigned long)s.count,
+				(unsigned long)(s.min / ticks_per_us), (unsigned long)(s.max / ticks_per_us),
+				(unsigned long)(s.total / s.count / ticks_per_us), (unsigned long)(s.self / s.count / ticks_per_us));
+		for (uint8_t b = 0; b < PROF_BUCKETS; b++){
+			printf(" %lu", (unsigned long)s.hist[b]);
+		}
+		printf("\n\r");
+	}
+#if PROF_ENABLE
+	if (prof.errors){
+		printf("%lu PROF_END desencontrados\n\r", (unsigned long)prof.errors);
+	}
+#endif
+}
@@ -0,0 +1,101 @@
+/*
+ * prof.h
+ *
+ * Profiler por zonas: PROF_BEGIN(zona) e PROF_END(zona) em volta de um
+ * trecho (zonas em prof_zones.def) guardam, por zona, contagem, minimo,
+ * maximo, media e um histograma log2 em us. Zonas podem ser aninhadas (ate
+ * PROF_DEPTH): o tempo da filha entra no total da mae e sai do "proprio"
+ * dela. O relogio e o CYCCNT do DWT no alvo e o clock_gettime() no host.
+ * Com PROF_ENABLE 0 as macros somem e nao sobra nada no codigo. So o main
+ * usa: nao e seguro em interrupcao.
+ */
+
+
+#ifndef PROF_H_
+#define PROF_H_
+
+#include <stdint.h>
+
+#ifndef PROF_ENABLE
+#define PROF_ENABLE   1
+#endif
+
+#define PROF_DEPTH    8
+#define PROF_BUCKETS  16   // 1us .. 32ms, o ultimo acumula o resto
+
+typedef enum {
+#define PROF_ZONE(id, name) PROF_##id,
+#include "prof_zones.def"
+#undef PROF_ZONE
+	PROF_ZONES
+} prof_zone;
+
+typedef struct {
+	uint32_t count;
+	uint32_t min;        // ticks
+	uint32_t max;
+	uint64_t total;      // inclusive, com as zonas filhas
+	uint64_t self;       // sem as zonas filhas
+	uint32_t hist[PROF_BUCKETS];
+} prof_stats;
+
+typedef struct {
+	uint8_t zone;
+	uint32_t start;
+	uint32_t child;      // ticks das filhas ja fechadas
+} prof_frame;
+
+typedef struct {
+	prof_frame stack[PROF_DEPTH];
+	uint8_t depth;       // pode passar de PROF_DEPTH: as zonas de fora do limite nao contam
+	uint32_t errors;     // PROF_END sem o PROF_BEGIN correspondente
+	prof_stats zones[PROF_ZONES];
+} prof_state;
+
+//TAMBEM E O RELOGIO DO frame_sched.c, ENTAO EXISTE COM PROF_ENABLE 0
+#ifdef HOST_BUILD
+#include <time.h>
+static inline uint32_t prof_ticks(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+#else
+#include <compiler.h>
+static inline uint32_t prof_ticks(void){ return DWT->CYCCNT; }
+#endif
+
+#if PROF_ENABLE
+
+extern prof_state prof;
+
+static inline void prof_begin(uint8_t zone){
+	if (prof.depth < PROF_DEPTH){
+		prof_frame *f = &prof.stack[prof.depth];
+		f->zone = zone;
+		f->child = 0;
+		f->start = prof_ticks();
+	}
+	prof.depth++;
+}
+
+void prof_end_at(uint8_t zone, uint32_t now);
+
+#define PROF_BEGIN(zone)  prof_begin(PROF_##zone)
+#define PROF_END(zone)    prof_end_at(PROF_##zone, prof_ticks())
+
+#else
+
+#define PROF_BEGIN(zone)  ((void)0)
+#define PROF_END(zone)    ((void)0)
+
+#endif /* PROF_ENABLE */
+
+//NO HOST O TICK E 1 ns E cpu_hz NAO IMPORTA
+void prof_init(uint32_t cpu_hz);
+void prof_reset(void);
+void prof_get_stats(uint8_t zone, prof_stats *stats);
+const char *prof_zone_name(uint8_t zone);
+void prof_dump(void);
+
+#endif /* PROF_H_ */
@@ -0,0 +1,177 @@
+/*
+ * screens.c
+ *
+ * A arvore das telas e o desenho fora dela (logo do boot e a tela de
+ * calibracao). O ili9488_draw_pixmap() manda (w - 1) * (h - 1) pixels, e o
+ * logo foi exportado contando com isso; os widgets recortam os icones com o
+ * ili9488_draw_pixmap_rect(), que manda o retangulo inteiro.
+ *
+ * root (branco, opaco)
+ *   lock
+ *   menu: start e botoes de ciclo
+ *     info: textos do ciclo
+ *   wash: contagem, fase e barra de progresso
+ *   finished
+ *   door: aviso de fechar a porta, por cima de tudo
+ */
+
+#include "ili9488.h"
+#include "gui.h"
+#include "screens.h"
+#include "widget.h"
+#include "cycle_table.h"
+#include "wash_flow.h"
+#include "prof.h"
+#include "tcm.h"
+#include "calibri_24.h"
+#include "logo.h"
+#include "icones/water.h"
+#include "icones/water_click.h"
+#include "icones/lock_white.h"
+#include "icones/unlock_white.h"
+#include "icones/fast.h"
+#include "icones/fast_click.h"
+#include "icones/clean.h"
+#include "icones/clean_click.h"
+#include "icones/centrifuge.h"
+#include "icones/centrifuge_click.h"
+#include "icones/daily.h"
+#include "icones/daily_click.h"
+#include "icones/heavy.h"
+#include "icones/heavy_click.h"
+
+#define LOGO_WIDTH   320
+#define LOGO_HEIGHT  130
+
+//ICONES E POSICOES, MESMA ORDEM DA TABELA DE BOTOES DO main.c
+const button_icon button_icons[BUTTONS_SIZE] = {
+	[BUT_LOCK]       = {.x0 = LOCX,     .y0 = LOCY,     .icon1 = &lock_white, .icon2 = &unlock_white},
+	[BUT_START]      = {.x0 = STARTX,   .y0 = STARTY,   .icon1 = &clean,      .icon2 = &clean_click},
+	[BUT_FAST]       = {.x0 = FASTX,    .y0 = LINEBUT1, .icon1 = &fast,       .icon2 = &fast_click},
+	[BUT_CENTRIFUGA] = {.x0 = CENTRIFX, .y0 = LINEBUT1, .icon1 = &centrifuge, .icon2 = &centrifuge_click},
+	[BUT_SLOW]       = {.x0 = SLOWX,    .y0 = LINEBUT1, .icon1 = &heavy,      .icon2 = &heavy_click},
+	[BUT_ENXAGUE]    = {.x0 = ENXX,     .y0 = LINEBUT2, .icon1 = &water,      .icon2 = &water_click},
+	[BUT_DAILY]      = {.x0 = DAYX,     .y0 = LINEBUT2, .icon1 = &daily,      .icon2 = &daily_click},
+};
+
+#define TIMERX     (ILI9488_LCD_WIDTH/2 - 30)
+#define TIMERY     (ILI9488_LCD_HEIGHT - 210)
+#define PHASEX     (ILI9488_LCD_WIDTH/2 - 60)
+#define PHASEY     (ILI9488_LCD_HEIGHT - 170)
+#define PROGRESSX  20
+#define PROGRESSY  (ILI9488_LCD_HEIGHT - 130)
+#define PROGRESSW  (ILI9488_LCD_WIDTH - 2*PROGRESSX)
+#define PROGRESSH  12
+
+//LINHA DE CADA TEXTO DO CICLO
+static const uint16_t label_y[CYCLE_LABELS] = {NAMEY, TEMPY, EXAQY, RPMY, CTIMY};
+
+static widget root, menu, info, wash, finished, door;
+static widget buttons[BUTTONS_SIZE];
+static widget labels[CYCLE_LABELS];
+static widget timer, phase, progress;
+
+//DESENHA A FONTE EM TEXTO NA TELA
+ITCM_FUNC void font_draw_text(const tFont *font, const char *text, int x, int y, int spacing) {
+	PROF_BEGIN(FONT_TEXT);
+	const char *p = text;
+	while(*p != '\0') {
+		char letter = *p;
+		int letter_offset = letter - font->start_char;
+		if(letter <= font->end_char) {
+			const tChar *current_char = font->chars + letter_offset;
+			ili9488_draw_pixmap(x, y, current_char->image->width, current_char->image->height, current_char->image->data);
+			x += current_char->image->width + spacing;
+		}
+		p++;
+	}
+	PROF_END(FONT_TEXT);
+}
+
+//LOGO NO MEIO DA TELA BRANCA, ENQUANTO O BOOT INICIALIZA O RESTO
+void draw_splash(void) {
+	draw_screen();
+	ili9488_draw_pixmap(0, (ILI9488_LCD_HEIGHT - LOGO_HEIGHT) / 2, LOGO_WIDTH, LOGO_HEIGHT, logoImage);
+}
+
+//DESENHA A TELA BRANCA DE FUNDO
+void draw_screen(void) {
+	ili9488_set_foreground_color(COLOR_CONVERT(COLOR_WHITE));
+	ili9488_draw_filled_rectangle(0, 0, ILI9488_LCD_WIDTH-1, ILI9488_LCD_HEIGHT-1);
+}
+
+//CAIXAS DE TOQUE DOS BOTOES: MESMA POSICAO E TAMANHO DO ICONE DESENHADO
+void screens_hit_boxes(hit_box boxes[BUTTONS_SIZE]) {
+	for (uint8_t i = 0; i < BUTTONS_SIZE; i++){
+		const button_icon *b = &button_icons[i];
+		boxes[i] = (hit_box){b->x0, b->y0, b->x0 + b->icon1->width - 1, b->y0 + b->icon1->height - 1};
+	}
+}
+
+//MONTA A ARVORE; O PRIMEIRO draw_display() PINTA A TELA INTEIRA
+void screens_init(void) {
+	widget_container(&root, 0, 0, ILI9488_LCD_WIDTH, ILI9488_LCD_HEIGHT, true, COLOR_CONVERT(COLOR_WHITE));
+	widget_container(&menu, 0, 0, ILI9488_LCD_WIDTH, ILI9488_LCD_HEIGHT, false, 0);
+	widget_container(&info, 0, 0, ILI9488_LCD_WIDTH, ILI9488_LCD_HEIGHT, false, 0);
+	widget_container(&wash, 0, 0, ILI9488_LCD_WIDTH, ILI9488_LCD_HEIGHT, false, 0);
+
+	for (uint8_t i = 0; i < BUTTONS_SIZE; i++){
+		const button_icon *b = &button_icons[i];
+		widget_image_button(&buttons[i], b->x0, b->y0, b->icon1, b->icon2);
+		widget_add(i == BUT_LOCK ? &root : &menu, &buttons[i], 0);
+	}
+	for (uint8_t i = 0; i < CYCLE_LABELS; i++){
+		widget_label(&labels[i], TEXTX, label_y[i], &calibri_24, SPACE, "");
+		widget_add(&info, &labels[i], 0);
+	}
+	widget_number(&timer, TIMERX, TIMERY, &calibri_24, SPACE, NUMBER_MMSS);
+	widget_label(&phase, PHASEX, PHASEY, &calibri_24, SPACE, "");
+	widget_progress(&progress, PROGRESSX, PROGRESSY, PROGRESSW, PROGRESSH, COLOR_CONVERT(COLOR_BLUE),
+			COLOR_CONVERT(COLOR_LIGHTGREY));
+	widget_add(&wash, &timer, 0);
+	widget_add(&wash, &phase, 0);
+	widget_add(&wash, &progress, 0);
+	widget_label(&finished, TIMERX, TIMERY, &calibri_24, SPACE, "yah boi terminou");
+	widget_label(&door, CLOSEX, CLOSEY, &calibri_24, SPACE, "FECHAR PORTA!");
+
+	widget_add(&menu, &info, 1);
+	widget_add(&root, &menu, 1);
+	widget_add(&root, &wash, 1);
+	widget_add(&root, &finished, 1);
+	widget_add(&root, &door, 2);
+}
+
+//A TELA FOI DESENHADA POR FORA DA ARVORE: O PROXIMO QUADRO PINTA TUDO
+void screens_repaint(void) {
+	widget_damage(0, 0, ILI9488_LCD_WIDTH, ILI9488_LCD_HEIGHT);
+}
+
+//PASSA O ui_view PARA OS WIDGETS E REDESENHA SO O QUE MUDOU
+void draw_display(const ui_view *v) {
+	const cycle_entry *e = &cycle_table[v->mode];
+	uint8_t washing = v->locked && v->wash_state == WASH_FLOW_WASHING;
+
+	PROF_BEGIN(DRAW_DISPLAY);
+	for (uint8_t i = 0; i < BUTTONS_SIZE; i++){
+		widget_set_state(&buttons[i], v->button_state[i] == RELEASED);
+	}
+	widget_set_visible(&menu, !v->locked);
+	widget_set_visible(&info, !v->door_msg);
+	for (uint8_t i = 0; i < CYCLE_LABELS; i++){
+		widget_set_text_w(&labels[i], e->labels[i].text, e->labels[i].width);
+	}
+
+	widget_set_visible(&wash, washing);
+	if (washing){
+		uint32_t total = e->total_ms / 1000;
+		uint32_t left = v->seconds_left < total ? v->seconds_left : total;
+		widget_set_value(&timer, v->seconds_left);
+		widget_set_text(&phase, wash_phase_name(v->phase));
+		widget_set_range(&progress, total - left, total);
+	}
+	widget_set_visible(&finished, v->locked && v->wash_state == WASH_FLOW_FINISHED);
+	widget_set_visible(&door, v->door_msg);
+
+	widget_render(&root);
+	PROF_END(DRAW_DISPLAY);
+}
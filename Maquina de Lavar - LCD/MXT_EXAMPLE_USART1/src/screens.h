@@ -0,0 +1,68 @@
+/*
+ * screens.h
+ *
+ * As telas da maquina como uma arvore de widgets (widget.h), montada uma
+ * vez em screens_init(). O main monta um ui_view dos seus globais e
+ * draw_display() so passa o ui_view para os widgets: o que nao mudou nao
+ * vai para o LCD. O sim/render_bench.c monta cada tela real no host, com o
+ * mesmo driver sobre um SPI simulado. Fontes, icones e o logo ficam aqui
+ * (os .h deles definem os dados, entao so um .c os inclui).
+ */
+
+
+#ifndef SCREENS_H_
+#define SCREENS_H_
+
+#include <stdint.h>
+#include "tfont.h"
+#include "touch_grid.h"
+
+#define CLICKED 1
+#define RELEASED 2
+
+//INDICES DA TABELA DE BOTOES
+enum {
+	BUT_LOCK,
+	BUT_START,
+	BUT_FAST,
+	BUT_CENTRIFUGA,
+	BUT_SLOW,
+	BUT_ENXAGUE,
+	BUT_DAILY,
+	BUTTONS_SIZE
+};
+
+//PRIMEIRO BOTAO DE CICLO, O CICLO E index - BUT_FIRST_CICLE
+#define BUT_FIRST_CICLE BUT_FAST
+#define CICLE_BUTTONS   (BUTTONS_SIZE - BUT_FIRST_CICLE)
+
+typedef struct {
+	const tImage *icon1;    // CLICKED
+	const tImage *icon2;    // RELEASED
+	uint16_t x0;
+	uint16_t y0;
+} button_icon;
+
+//O QUE A TELA MOSTRA
+typedef struct {
+	uint8_t locked;
+	uint8_t door_msg;                // aviso de fechar a porta na tela
+	uint8_t wash_state;              // wash_flow_state
+	uint8_t mode;                    // ciclo escolhido (cycle_table)
+	uint8_t phase;                   // wash_phase_type da fase atual, lavando
+	uint32_t seconds_left;           // contagem, lavando
+	const uint8_t *button_state;     // CLICKED/RELEASED, BUTTONS_SIZE entradas
+} ui_view;
+
+extern const button_icon button_icons[BUTTONS_SIZE];
+extern const tFont calibri_24;
+
+void font_draw_text(const tFont *font, const char *text, int x, int y, int spacing);
+void draw_splash(void);
+void draw_screen(void);
+void screens_hit_boxes(hit_box boxes[BUTTONS_SIZE]);
+void screens_init(void);
+void screens_repaint(void);
+void draw_display(const ui_view *v);
+
+#endif /* SCREENS_H_ */
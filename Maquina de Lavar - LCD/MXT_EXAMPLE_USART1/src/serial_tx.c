@@ -0,0 +1,109 @@
+/*
+ * serial_tx.c
+ *
+ * A CONSOLE_UART da placa e a USART1. Escrever no anel liga a interrupcao
+ * TXRDY; o handler manda um byte por TXRDY e desliga a interrupcao quando
+ * o anel esvazia. No TX_DROP_OLDEST a escrita roda com a interrupcao da
+ * USART mascarada, porque o produtor tambem mexe no tail. A USART do SAME70
+ * nao tem PDC (o DMA seria o XDMAC), e a 115200 uma interrupcao por byte
+ * sao ~11500 por segundo no pior caso, entao fica na interrupcao.
+ */
+
+#include <asf.h>
+#include "serial_tx.h"
+
+#define SERIAL_TX_POLICY  TX_DROP_NEWEST
+
+TX_RING_DEFINE(serial_ring, SERIAL_TX_SIZE, SERIAL_TX_POLICY);
+
+//O MESMO ANEL DE UM PRODUTOR E UM CONSUMIDOR, AQUI COM A INTERRUPCAO ESCREVENDO
+TX_RING_DEFINE(serial_rx_ring, SERIAL_RX_SIZE, TX_DROP_NEWEST);
+static void (*rx_line)(void);
+
+static inline void kick(void){
+	usart_enable_interrupt(CONSOLE_UART, US_IER_TXRDY);
+}
+
+//TX_BLOCK: A INTERRUPCAO ESTA LIGADA; DORME ATE ELA ABRIR ESPACO
+static void wait_space(void){
+	kick();
+	__WFI();
+}
+
+void serial_tx_init(void){
+	ptr_put = serial_tx_putchar;
+
+	NVIC_DisableIRQ(CONSOLE_UART_ID);
+	NVIC_ClearPendingIRQ(CONSOLE_UART_ID);
+	NVIC_SetPriority(CONSOLE_UART_ID, 3);
+	NVIC_EnableIRQ(CONSOLE_UART_ID);
+}
+
+uint16_t serial_tx_write(const void *data, uint16_t len){
+	uint16_t n;
+
+	if (SERIAL_TX_POLICY == TX_DROP_OLDEST){
+		NVIC_DisableIRQ(CONSOLE_UART_ID);
+		n = tx_ring_write(&serial_ring, data, len, NULL);
+		NVIC_EnableIRQ(CONSOLE_UART_ID);
+	} else {
+		n = tx_ring_write(&serial_ring, data, len, wait_space);
+	}
+	kick();
+	return n;
+}
+
+//ptr_put DO STDIO: printf SEM BUFFER CHAMA UMA VEZ POR CARACTERE
+int serial_tx_putchar(volatile void *usart, char c){
+	serial_tx_write(&c, 1);
+	return 0;
+}
+
+//ESPACO LIVRE NO ANEL: QUEM NAO PODE PERDER BYTES ESCREVE ATE AQUI
+uint16_t serial_tx_free(void){
+	return tx_ring_free(&serial_ring);
+}
+
+//ESPERA O ANEL ESVAZIAR (ANTES DE RESETAR, POR EXEMPLO)
+void serial_tx_flush(void){
+	while (!tx_ring_empty(&serial_ring)){
+		kick();
+	}
+}
+
+void serial_tx_get_stats(tx_ring_stats *stats){
+	tx_ring_get_stats(&serial_ring, stats);
+}
+
+void serial_rx_init(void (*on_line)(void)){
+	rx_line = on_line;
+	usart_enable_interrupt(CONSOLE_UART, US_IER_RXRDY);
+}
+
+bool serial_rx_getc(char *c){
+	return tx_ring_pop(&serial_rx_ring, (uint8_t *)c);
+}
+
+void serial_rx_get_stats(tx_ring_stats *stats){
+	tx_ring_get_stats(&serial_rx_ring, stats);
+}
+
+void USART1_Handler(void){
+	uint8_t c;
+
+	if (usart_is_rx_ready(CONSOLE_UART)){
+		c = CONSOLE_UART->US_RHR & US_RHR_RXCHR_Msk;
+		tx_ring_write(&serial_rx_ring, &c, 1, NULL);
+		if ((c == '\r' || c == '\n') && rx_line){
+			rx_line();
+		}
+	}
+
+	while (usart_is_tx_ready(CONSOLE_UART)){
+		if (!tx_ring_pop(&serial_ring, &c)){
+			usart_disable_interrupt(CONSOLE_UART, US_IDR_TXRDY);
+			break;
+		}
+		CONSOLE_UART->US_THR = US_THR_TXCHR(c);
+	}
+}
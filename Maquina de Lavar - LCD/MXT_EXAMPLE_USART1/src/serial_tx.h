@@ -0,0 +1,35 @@
+/*
+ * serial_tx.h
+ *
+ * Transmissao da CONSOLE_UART sem bloquear: printf() (pelo ptr_put do
+ * stdio_serial) e serial_tx_write() so copiam para um tx_ring e a
+ * interrupcao TXRDY da USART esvazia o anel. Um printf no callback de um
+ * toque custa a copia, nao os ~87 us por byte da linha a 115200.
+ * A recepcao (console.h) usa a mesma interrupcao: RXRDY guarda o byte num
+ * anel pequeno e, no fim da linha, avisa o main pelo on_line.
+ */
+
+
+#ifndef SERIAL_TX_H_
+#define SERIAL_TX_H_
+
+#include <stdint.h>
+#include "tx_ring.h"
+
+#define SERIAL_TX_SIZE  1024
+#define SERIAL_RX_SIZE  128
+
+//DEPOIS DO stdio_serial_init(), QUE CONFIGURA A USART E TROCA O ptr_put
+void serial_tx_init(void);
+uint16_t serial_tx_write(const void *data, uint16_t len);
+int serial_tx_putchar(volatile void *usart, char c);
+uint16_t serial_tx_free(void);
+void serial_tx_flush(void);
+void serial_tx_get_stats(tx_ring_stats *stats);
+
+//on_line RODA NA INTERRUPCAO, A CADA '\r' OU '\n' RECEBIDO
+void serial_rx_init(void (*on_line)(void));
+bool serial_rx_getc(char *c);
+void serial_rx_get_stats(tx_ring_stats *stats);
+
+#endif /* SERIAL_TX_H_ */
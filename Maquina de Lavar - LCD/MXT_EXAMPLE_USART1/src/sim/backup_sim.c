@@ -0,0 +1,37 @@
+/*
+ * backup_sim.c
+ *
+ * Back end de host do backup_regs: um vetor em RAM que o processo inteiro
+ * enxerga como o dominio de backup. Comeca como numa primeira energizacao
+ * (zerado, nao retido); backup_sim_power_loss() simula a queda seguinte.
+ */
+
+#ifdef HOST_BUILD
+
+#include "backup_regs.h"
+
+static uint32_t regs[BACKUP_REGS];
+static bool retained;
+
+uint32_t backup_read(uint8_t index){
+	return regs[index];
+}
+
+void backup_write(uint8_t index, uint32_t value){
+	regs[index] = value;
+}
+
+bool backup_retained(void){
+	return retained;
+}
+
+void backup_sim_power_loss(bool keep_backup){
+	retained = keep_backup;
+	if (!keep_backup){
+		for (uint8_t i = 0; i < BACKUP_REGS; i++){
+			regs[i] = 0;
+		}
+	}
+}
+
+#endif /* HOST_BUILD */
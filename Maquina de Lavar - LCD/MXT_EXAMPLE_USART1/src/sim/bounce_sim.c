@@ -0,0 +1,145 @@
+/*
+ * bounce_sim.c
+ *
+ * Roda o input.c no host com o relogio virtual: um script de bordas com
+ * trepidacao (press e release com repiques, glitch mais curto que o
+ * debounce, toque rapido e um hold) em duas entradas ao mesmo tempo, pelo
+ * mesmo caminho do main.c (borda -> fila -> input_edge -> timebase). Confere
+ * cada evento entregue, com instante e duracao, contra o esperado.
+ *
+ *   gcc -DHOST_BUILD -I. sim/bounce_sim.c sim/input_sim.c sim/clock_sim.c input.c \
+ *       timebase.c timer_wheel.c event_loop.c event_queue.c -o bounce_sim
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include "clock_source.h"
+#include "timebase.h"
+#include "event_loop.h"
+#include "input.h"
+
+#define DEBOUNCE_MS  20
+#define HOLD_MS      2000
+#define END_MS       12000
+
+enum {IN_PORTA, IN_START, INPUTS_SIZE};
+
+static const input_pin pins[INPUTS_SIZE] = {
+	[IN_PORTA] = {.name = "porta", .debounce_ms = DEBOUNCE_MS, .hold_ms = HOLD_MS},
+	[IN_START] = {.name = "start", .debounce_ms = DEBOUNCE_MS},
+};
+
+typedef struct {
+	uint32_t t_ms;
+	uint8_t index;
+	uint8_t level;
+} sim_edge;
+
+//BORDAS CRUAS DO PINO, COM OS REPIQUES
+static const sim_edge script[] = {
+	{1000, IN_PORTA, 1}, {1002, IN_PORTA, 0}, {1003, IN_PORTA, 1}, {1007, IN_PORTA, 0}, {1008, IN_PORTA, 1},
+	{1500, IN_START, 1}, {1501, IN_START, 0}, {1504, IN_START, 1},
+	{1700, IN_START, 0},
+	{4000, IN_PORTA, 0}, {4001, IN_PORTA, 1}, {4004, IN_PORTA, 0},
+	{6000, IN_PORTA, 1}, {6005, IN_PORTA, 0},
+	{8000, IN_PORTA, 1},
+	{8100, IN_PORTA, 0},
+};
+#define SCRIPT_SIZE (sizeof(script) / sizeof(script[0]))
+
+typedef struct {
+	uint32_t t_ms;
+	uint8_t type;
+	uint8_t index;
+	uint32_t duration;
+} sim_expect;
+
+static const sim_expect expected[] = {
+	{1028, INPUT_PRESS,   IN_PORTA, 0},
+	{1524, INPUT_PRESS,   IN_START, 0},
+	{1720, INPUT_RELEASE, IN_START, 220},
+	{3000, INPUT_HOLD,    IN_PORTA, 2000},
+	{4024, INPUT_RELEASE, IN_PORTA, 3024},
+	{8020, INPUT_PRESS,   IN_PORTA, 0},
+	{8120, INPUT_RELEASE, IN_PORTA, 120},
+};
+#define EXPECTED_SIZE (sizeof(expected) / sizeof(expected[0]))
+
+static const char *type_names[] = {"press", "release", "hold"};
+
+EVENT_QUEUE_DEFINE(button_events, 8);
+EVENT_QUEUE_DEFINE(timer_events, 4);
+
+static event_queue *const sources[] = {&button_events, &timer_events};
+#define SOURCES_SIZE (sizeof(sources) / sizeof(sources[0]))
+
+static timebase_timer script_timer;
+static uint8_t step;
+static uint8_t received;
+static uint8_t done;
+static int errors;
+
+static uint32_t wall_ms(void){
+	return (uint32_t)clock_now_ms();
+}
+
+static void on_clock_alarm(void){
+	event_queue_post(&timer_events, EV_TIMER, 0, wall_ms());
+}
+
+//A "INTERRUPCAO" DO PINO: SO CARIMBA E POSTA, COMO NO main.c
+static void on_input_edge(uint8_t index){
+	event_queue_post(&button_events, EV_BUTTON, index, wall_ms());
+}
+
+static void on_input(const input_event *ev){
+	uint32_t now = wall_ms();
+	const sim_expect *e = received < EXPECTED_SIZE ? &expected[received] : NULL;
+
+	printf("  %5lu ms  %-5s %-7s %lu ms\n", (unsigned long)now, pins[ev->index].name,
+			type_names[ev->type], (unsigned long)ev->duration);
+	if (!e || e->t_ms != now || e->type != ev->type || e->index != ev->index || e->duration != ev->duration){
+		printf("  inesperado\n");
+		errors++;
+	}
+	received++;
+}
+
+static void on_script(timebase_timer *t){
+	if (step == SCRIPT_SIZE){
+		done = 1;
+		return;
+	}
+	input_sim_set(script[step].index, script[step].level);
+	step++;
+	timebase_start(&script_timer, step < SCRIPT_SIZE ? script[step].t_ms : END_MS, on_script);
+}
+
+int main(void){
+	event ev;
+
+	clock_init(on_clock_alarm);
+	timebase_init();
+	input_init(pins, INPUTS_SIZE, on_input_edge, on_input);
+	event_loop_init(1000000, wall_ms, sources, SOURCES_SIZE);
+	event_loop_sim_idle = clock_sim_idle;
+	timebase_start(&script_timer, script[0].t_ms, on_script);
+
+	while (!done){
+		event_wait();
+		while (event_queue_get(&button_events, &ev)){
+			input_edge(ev.arg, ev.stamp);
+		}
+		while (event_queue_get(&timer_events, &ev)){
+			timebase_process();
+		}
+	}
+	if (received != EXPECTED_SIZE){
+		errors++;
+	}
+	printf("%u eventos (esperado %u), %d erros\n", received, (unsigned)EXPECTED_SIZE, errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
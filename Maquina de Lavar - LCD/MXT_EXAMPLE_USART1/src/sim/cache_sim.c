@@ -0,0 +1,150 @@
+/*
+ * cache_sim.c
+ *
+ * Cada linha guarda o endereco que ocupa, valida, suja e a copia dos
+ * dados. Uma falta despeja a linha do mesmo indice (gravando se suja) e
+ * carrega a nova da memoria. Invalidar joga fora mesmo suja, como o
+ * DCIMVAC: por isso o dma_pool limpa as pontas divididas antes.
+ */
+
+#ifdef HOST_BUILD
+
+#include <string.h>
+#include "dma_pool.h"
+#include "cache_sim.h"
+
+#define LINES   128
+
+typedef struct {
+	uintptr_t addr;
+	uint8_t valid;
+	uint8_t dirty;
+	uint8_t data[DMA_LINE];
+} cache_line;
+
+static cache_line lines[LINES];
+static uintptr_t nc_start, nc_end;
+static cache_sim_stats stats;
+
+void cache_sim_reset(void){
+	memset(lines, 0, sizeof(lines));
+	memset(&stats, 0, sizeof(stats));
+}
+
+static void write_back(cache_line *l){
+	if (l->valid && l->dirty){
+		memcpy((void *)l->addr, l->data, DMA_LINE);
+		l->dirty = 0;
+		stats.writebacks++;
+	}
+}
+
+static cache_line *lookup(uintptr_t a){
+	uintptr_t addr = a & ~(uintptr_t)(DMA_LINE - 1);
+	cache_line *l = &lines[(addr / DMA_LINE) % LINES];
+
+	if (l->valid && l->addr == addr){
+		stats.hits++;
+		return l;
+	}
+	stats.misses++;
+	write_back(l);
+	l->addr = addr;
+	l->valid = 1;
+	memcpy(l->data, (void *)addr, DMA_LINE);
+	return l;
+}
+
+static int uncached(uintptr_t a){
+	return a >= nc_start && a < nc_end;
+}
+
+void cache_sim_cpu_write(void *addr, const void *src, uint32_t len){
+	uintptr_t a = (uintptr_t)addr;
+	const uint8_t *s = src;
+
+	for (uint32_t i = 0; i < len; i++, a++){
+		if (uncached(a)){
+			*(uint8_t *)a = s[i];
+			continue;
+		}
+		cache_line *l = lookup(a);
+		l->data[a - l->addr] = s[i];
+		l->dirty = 1;
+	}
+}
+
+void cache_sim_cpu_read(void *dst, const void *addr, uint32_t len){
+	uintptr_t a = (uintptr_t)addr;
+	uint8_t *d = dst;
+
+	for (uint32_t i = 0; i < len; i++, a++){
+		if (uncached(a)){
+			d[i] = *(const uint8_t *)a;
+			continue;
+		}
+		cache_line *l = lookup(a);
+		d[i] = l->data[a - l->addr];
+	}
+}
+
+void cache_sim_dma_write(void *addr, const void *src, uint32_t len){
+	memcpy(addr, src, len);
+}
+
+void cache_sim_dma_read(void *dst, const void *addr, uint32_t len){
+	memcpy(dst, addr, len);
+}
+
+void cache_sim_get_stats(cache_sim_stats *out){
+	*out = stats;
+}
+
+//BACK END DO dma_pool.h
+
+void dma_region_setup(uintptr_t start, uint32_t size){
+	if (start & (DMA_LINE - 1)){
+		stats.unaligned++;
+	}
+	nc_start = start;
+	nc_end = start + size;
+}
+
+//CHAMA op EM CADA LINHA DO INTERVALO QUE ESTA NO CACHE
+static void each_line(uintptr_t start, uintptr_t end, uint32_t *count, void (*op)(cache_line *l)){
+	if ((start | end) & (DMA_LINE - 1)){
+		stats.unaligned++;
+	}
+	for (uintptr_t a = start & ~(uintptr_t)(DMA_LINE - 1); a < end; a += DMA_LINE){
+		cache_line *l = &lines[(a / DMA_LINE) % LINES];
+
+		(*count)++;
+		if (l->valid && l->addr == a){
+			op(l);
+		}
+	}
+}
+
+static void drop(cache_line *l){
+	l->valid = 0;
+	l->dirty = 0;
+}
+
+static void write_back_drop(cache_line *l){
+	write_back(l);
+	drop(l);
+}
+
+void dma_cache_clean(uintptr_t start, uintptr_t end){
+	each_line(start, end, &stats.cleans, write_back);
+}
+
+void dma_cache_invalidate(uintptr_t start, uintptr_t end){
+	each_line(start, end, &stats.invalidates, drop);
+}
+
+void dma_cache_flush(uintptr_t start, uintptr_t end){
+	each_line(start, end, &stats.flushes, write_back_drop);
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,39 @@
+/*
+ * cache_sim.h
+ *
+ * D-cache de mentira para o host (HOST_BUILD), no lugar do dma_mpu.c:
+ * write-back com write-allocate em linhas de DMA_LINE, mapeamento direto
+ * (menor que os 16 KB de 4 vias do M7; o que importa e a regra). A CPU do
+ * teste acessa a memoria pelo cache_sim_cpu_*, o "DMA" pelo
+ * cache_sim_dma_*, direto na memoria. O intervalo do dma_region_setup()
+ * passa por fora do cache, como a regiao do MPU.
+ */
+
+
+#ifndef CACHE_SIM_H_
+#define CACHE_SIM_H_
+
+#ifdef HOST_BUILD
+
+#include <stdint.h>
+
+typedef struct {
+	uint32_t hits;
+	uint32_t misses;
+	uint32_t writebacks;    // linhas sujas gravadas na memoria
+	uint32_t cleans;        // linhas pedidas ao back end, por operacao
+	uint32_t invalidates;
+	uint32_t flushes;
+	uint32_t unaligned;     // intervalo fora de linha no back end
+} cache_sim_stats;
+
+void cache_sim_reset(void);
+void cache_sim_cpu_write(void *addr, const void *src, uint32_t len);
+void cache_sim_cpu_read(void *dst, const void *addr, uint32_t len);
+void cache_sim_dma_write(void *addr, const void *src, uint32_t len);
+void cache_sim_dma_read(void *dst, const void *addr, uint32_t len);
+void cache_sim_get_stats(cache_sim_stats *out);
+
+#endif /* HOST_BUILD */
+
+#endif /* CACHE_SIM_H_ */
@@ -0,0 +1,28 @@
+/*
+ * check.h
+ *
+ * Conferencia dos sims do host: check() imprime uma linha com ok/ERRO e
+ * conta os erros em "errors", que o main do sim devolve no fim. O contador
+ * e static, entao so o .c com o main inclui.
+ */
+
+
+#ifndef CHECK_H_
+#define CHECK_H_
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+
+#define CHECK_WIDTH  52   // coluna da descricao
+
+static int errors;
+
+static inline void check(int ok, const char *what){
+	printf("  %-*s %s\n", CHECK_WIDTH, what, ok ? "ok" : "ERRO");
+	errors += !ok;
+}
+
+#endif /* HOST_BUILD */
+
+#endif /* CHECK_H_ */
@@ -0,0 +1,96 @@
+/*
+ * clock_sim.c
+ *
+ * Back end de host do clock_source: o tempo e um contador virtual em ms que
+ * so anda quando alguem manda. clock_sim_idle() faz o papel do WFI (hook
+ * event_loop_sim_idle): pula o relogio direto para o alarme e chama o
+ * handler, como a interrupcao do RTT. Com escala N, antes de pular dorme o
+ * intervalo dividido por N em tempo real (N ms virtuais por ms real), para
+ * ver o fluxo andando; com escala 0 nao dorme e o resultado nao depende da
+ * maquina.
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "clock_source.h"
+
+static uint64_t virtual_ms;
+static uint64_t alarm_ms = CLOCK_NO_ALARM;
+static clock_alarm_handler on_alarm;
+static uint32_t scale;
+static uint32_t alarms;
+
+static void real_sleep(uint64_t ms){
+	if (scale == 0 || ms == 0){
+		return;
+	}
+	uint64_t ns = ms * 1000000 / scale;
+	struct timespec ts = {(time_t)(ns / 1000000000), (long)(ns % 1000000000)};
+	nanosleep(&ts, NULL);
+}
+
+//A "INTERRUPCAO": DISPARA SE O RELOGIO CHEGOU NO ALARME
+static void check_alarm(void){
+	if (alarm_ms != CLOCK_NO_ALARM && virtual_ms >= alarm_ms){
+		alarm_ms = CLOCK_NO_ALARM;
+		alarms++;
+		if (on_alarm){
+			on_alarm();
+		}
+	}
+}
+
+void clock_init(clock_alarm_handler handler){
+	on_alarm = handler;
+	virtual_ms = 0;
+	alarm_ms = CLOCK_NO_ALARM;
+	alarms = 0;
+}
+
+uint64_t clock_now_ms(void){
+	return virtual_ms;
+}
+
+//COMO NO RTT, ESCREVER UM ALARME NO PASSADO NAO DISPARA: QUEM ARMA CONFERE
+void clock_set_alarm(uint64_t at_ms){
+	alarm_ms = at_ms;
+}
+
+void clock_sleep_until(uint64_t at_ms){
+	if (at_ms > virtual_ms){
+		real_sleep(at_ms - virtual_ms);
+		virtual_ms = at_ms;
+	}
+	check_alarm();
+}
+
+//O TEMPO PULA SEM DORMIR E SEM DISPARAR O ALARME, COMO NO RTT
+void clock_skew(uint64_t ms){
+	virtual_ms += ms;
+}
+
+void clock_sim_set_scale(uint32_t s){
+	scale = s;
+}
+
+void clock_sim_advance(uint64_t ms){
+	clock_sleep_until(virtual_ms + ms);
+}
+
+//WFI SEM ALARME E SEM OUTRA FONTE: NO HARDWARE O MAIN DORMIRIA PARA SEMPRE
+void clock_sim_idle(void){
+	if (alarm_ms == CLOCK_NO_ALARM){
+		fprintf(stderr, "clock_sim: WFI sem alarme em %llu ms\n", (unsigned long long)virtual_ms);
+		exit(2);
+	}
+	clock_sleep_until(alarm_ms);
+}
+
+uint32_t clock_sim_alarms(void){
+	return alarms;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,166 @@
+/*
+ * console_sim.c
+ *
+ * O console.c no host, lido do stdin: cada linha vai para console_feed()
+ * como se viesse da USART. As acoes ligam no mesmo codigo do alvo
+ * (gesture.c, wash_flow.c, timebase com o relogio virtual); sem LCD, os
+ * gestos, as fases e os redesenhos saem como texto com o tempo virtual.
+ * Sem tela tambem nao ha botao de start: "cycle" escolhe e ja comeca.
+ *
+ *   gcc -DHOST_BUILD -I. sim/console_sim.c console.c gesture.c sim/clock_sim.c sim/backup_sim.c \
+ *       timebase.c timer_wheel.c wash_flow.c wash_checkpoint.c wash_program.c cycle_table.c \
+ *       crc32.c prof.c -o console_sim
+ *   printf 'cycle 0\nadvance 60000\nstats\n' | ./console_sim
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include "console.h"
+#include "clock_source.h"
+#include "timebase.h"
+#include "gesture.h"
+#include "wash_flow.h"
+#include "cycle_table.h"
+#include "prof.h"
+
+#define TOUCH_ID  (GESTURE_MAX_TOUCHES - 1)
+
+static const char *const feature_names[] = {"dirty", "telemetry", "latency"};
+static uint32_t features = 7;
+static timebase_timer release_timer;
+static timebase_timer gesture_timer;
+static uint16_t touch_x, touch_y;
+static uint32_t redraws;
+
+static uint32_t ms_now(void){
+	return (uint32_t)clock_now_ms();
+}
+
+static void trace(const char *what, const char *detail){
+	uint64_t t = clock_now_ms();
+	printf("  %3lu:%02lu.%03lu  %s %s\n", (unsigned long)(t / 60000), (unsigned long)(t / 1000 % 60),
+			(unsigned long)(t % 1000), what, detail);
+}
+
+//O ALARME SO IMPORTA DENTRO DO advance, QUE JA RODA A TIMEBASE
+static void on_clock_alarm(void){
+}
+
+static void on_gesture(const gesture_event *ev){
+	static const char *const names[] = {"press", "release", "tap", "long-press", "drag", "swipe <", "swipe >"};
+	char detail[48];
+
+	snprintf(detail, sizeof(detail), "(%u, %u) %lu ms", ev->x, ev->y, (unsigned long)ev->duration);
+	trace(names[ev->type], detail);
+}
+
+static void on_gesture_timer(timebase_timer *t){
+	gesture_poll(ms_now());
+}
+
+//COMO O arm_gesture_timer() DO main.c
+static void arm_gesture_timer(void){
+	uint32_t deadline;
+
+	if (gesture_next_deadline(&deadline)){
+		int32_t dt = (int32_t)(deadline - ms_now());
+		timebase_start(&gesture_timer, timebase_now() + (dt > 0 ? dt : 0), on_gesture_timer);
+	} else {
+		timebase_stop(&gesture_timer);
+	}
+}
+
+static void on_wash_flow(uint8_t ev, const wash_phase *ph){
+	if (ev == WASH_FLOW_EV_PHASE){
+		trace("fase", wash_phase_name(ph->type));
+	}
+	else if (ev == WASH_FLOW_EV_DONE){
+		trace("terminou", "");
+	}
+	redraws++;
+}
+
+static void on_release(timebase_timer *t){
+	gesture_feed(TOUCH_ID, GESTURE_T9_RELEASE, touch_x, touch_y, ms_now());
+	arm_gesture_timer();
+}
+
+static void sim_touch(uint16_t x, uint16_t y, uint32_t hold_ms){
+	if (timebase_armed(&release_timer)){
+		return;
+	}
+	touch_x = x;
+	touch_y = y;
+	gesture_feed(TOUCH_ID, GESTURE_T9_DETECT | GESTURE_T9_PRESS, x, y, ms_now());
+	arm_gesture_timer();
+	timebase_start(&release_timer, timebase_now() + hold_ms, on_release);
+}
+
+static bool sim_cycle(uint8_t id){
+	if (id >= CYCLE_COUNT || wash_flow_get_state() == WASH_FLOW_WASHING){
+		return false;
+	}
+	wash_flow_start(id, &cycle_table[id].program);
+	trace("start", cycle_table[id].ciclo.nome);
+	return true;
+}
+
+//COMO NO main.c, MAS DE 1 EM 1 ms PARA CADA trace SAIR NA HORA DO PRAZO
+static void sim_advance(uint32_t ms){
+	while (ms--){
+		clock_skew(1);
+		PROF_BEGIN(DISPATCH);
+		timebase_process();
+		PROF_END(DISPATCH);
+	}
+}
+
+static void sim_redraw(void){
+	redraws++;
+	trace("redesenho", "");
+}
+
+static void sim_stats(void){
+	char detail[64];
+
+	snprintf(detail, sizeof(detail), "estado %u, %lu s restantes, %lu redesenhos", wash_flow_get_state(),
+			(unsigned long)wash_flow_seconds_left(), (unsigned long)redraws);
+	trace("stats", detail);
+}
+
+static const console_ops ops = {
+	.touch = sim_touch,
+	.cycle = sim_cycle,
+	.advance = sim_advance,
+	.redraw = sim_redraw,
+	.stats = sim_stats,
+	.features = feature_names,
+	.feature_count = sizeof(feature_names) / sizeof(feature_names[0]),
+	.feature_flags = &features,
+};
+
+int main(void){
+	const gesture_config gestures = {.long_press_ms = 3000, .drag_px = 12, .swipe_px = 80, .swipe_ms = 600};
+	int c;
+
+	prof_init(0);
+	clock_init(on_clock_alarm);
+	timebase_init();
+	gesture_init(&gestures, on_gesture);
+	wash_flow_init(on_wash_flow);
+	console_init(&ops);
+
+	while ((c = getchar()) != EOF){
+		if (c != '\n'){
+			putchar(c);
+		} else {
+			printf("\n");
+		}
+		console_feed((char)c);
+	}
+	console_feed('\n');
+	return 0;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,215 @@
+/*
+ * dma_sim.c
+ *
+ * Confere o dma_pool.c no host sobre o modelo de cache do sim/cache_sim.c:
+ * alocacao O(1) sem fragmentar (contra um modelo de referencia), free
+ * invalido, e a coerencia CPU x DMA: buffer CACHED le lixo sem
+ * dma_clean()/dma_invalidate() e certo com eles, sem estragar o bloco
+ * vizinho; buffer NOCACHE nao precisa de nada.
+ *
+ *   gcc -DHOST_BUILD -DDMA_POOLS_DEF='"sim/dma_sim_pools.def"' -I. sim/dma_sim.c sim/cache_sim.c dma_pool.c -o dma_sim && ./dma_sim
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dma_pool.h"
+#include "sim/cache_sim.h"
+#include "check.h"
+
+#define RANDOM_OPS  20000
+
+static void fill(uint8_t *buf, uint32_t len, uint8_t seed){
+	for (uint32_t i = 0; i < len; i++){
+		buf[i] = (uint8_t)(seed + i * 7);
+	}
+}
+
+//BLOCOS, ALINHAMENTO, TIPO E ESGOTAMENTO DE CADA POOL
+static void pools(void){
+	int aligned = 1, kinds = 1, exhaust = 1;
+
+	for (uint8_t id = 0; id < DMA_POOLS; id++){
+		dma_pool_stats s;
+		void *blocks[32];
+
+		dma_get_stats(id, &s);
+		for (uint8_t i = 0; i < s.count; i++){
+			blocks[i] = dma_alloc(id);
+			aligned &= blocks[i] != NULL && ((uintptr_t)blocks[i] & (DMA_LINE - 1)) == 0;
+			kinds &= dma_is_cached(blocks[i]) == s.cached;
+			if (i > 0){
+				aligned &= (uint8_t *)blocks[i] - (uint8_t *)blocks[i - 1] == s.block;
+			}
+		}
+		exhaust &= dma_alloc(id) == NULL;
+		dma_get_stats(id, &s);
+		exhaust &= s.used == s.count && s.high_water == s.count && s.failures == 1;
+		for (uint8_t i = 0; i < s.count; i++){
+			dma_free(id, blocks[i]);
+		}
+		dma_get_stats(id, &s);
+		exhaust &= s.used == 0 && s.bad_frees == 0;
+		printf("  %-10s %4u x %2u %s\n", dma_pool_name(id), s.block, s.count, s.cached ? "cached" : "nocache");
+	}
+	check(aligned, "blocos alinhados a linha e contiguos");
+	check(kinds, "NOCACHE fora do cache, CACHED dentro");
+	check(exhaust, "pool vazio devolve NULL e conta a falha");
+}
+
+static void bad_frees(void){
+	dma_pool_stats s;
+	uint8_t *a = dma_alloc(DMA_TOUCH_MSG);
+	uint8_t other[4];
+
+	dma_free(DMA_TOUCH_MSG, a + 1);
+	dma_free(DMA_TOUCH_MSG, other);
+	dma_free(DMA_TOUCH_MSG, NULL);
+	dma_free(DMA_LCD_LINE, a);
+	dma_free(DMA_TOUCH_MSG, a);
+	dma_free(DMA_TOUCH_MSG, a);
+	dma_get_stats(DMA_TOUCH_MSG, &s);
+	check(s.bad_frees == 4 && s.used == 0, "meio de bloco, fora, NULL e free duplo");
+	dma_get_stats(DMA_LCD_LINE, &s);
+	check(s.bad_frees == 1, "bloco de outro pool");
+	check(dma_alloc(DMA_TOUCH_MSG) == a, "o bloco liberado volta primeiro");
+	dma_free(DMA_TOUCH_MSG, a);
+}
+
+//SEQUENCIA ALEATORIA CONTRA UM MODELO: ENQUANTO HA BLOCO LIVRE, ALOCA
+static void random_ops(void){
+	dma_pool_stats s;
+	uint8_t *held[32] = {0};
+	int ok = 1;
+
+	dma_get_stats(DMA_SERIAL_RX, &s);
+	uint32_t failures = s.failures;
+	srand(48);
+	for (uint32_t n = 0; n < RANDOM_OPS; n++){
+		uint8_t i = rand() % s.count;
+
+		if (held[i]){
+			dma_free(DMA_SERIAL_RX, held[i]);
+			held[i] = NULL;
+			continue;
+		}
+		held[i] = dma_alloc(DMA_SERIAL_RX);
+		ok &= held[i] != NULL;
+		for (uint8_t j = 0; j < s.count && held[i]; j++){
+			ok &= j == i || held[j] != held[i];
+		}
+	}
+	for (uint8_t i = 0; i < s.count; i++){
+		if (held[i]){
+			dma_free(DMA_SERIAL_RX, held[i]);
+		}
+	}
+	dma_get_stats(DMA_SERIAL_RX, &s);
+	check(ok && s.used == 0 && s.failures == failures && s.bad_frees == 0, "20000 operacoes sem falha nem bloco repetido");
+}
+
+//CPU ESCREVE, DMA LE (TX)
+static void tx_cached(void){
+	uint8_t *buf = dma_alloc(DMA_LCD_BLOCK);
+	uint8_t line[960], out[960];
+
+	fill(line, sizeof(line), 1);
+	cache_sim_cpu_write(buf, line, sizeof(line));
+	cache_sim_dma_read(out, buf, sizeof(out));
+	check(memcmp(out, line, sizeof(out)) != 0, "TX sem dma_clean: o DMA le a SRAM velha");
+	dma_clean(buf, sizeof(line));
+	cache_sim_dma_read(out, buf, sizeof(out));
+	check(memcmp(out, line, sizeof(out)) == 0, "TX com dma_clean: o DMA le o que a CPU escreveu");
+	dma_free(DMA_LCD_BLOCK, buf);
+}
+
+//DMA ESCREVE, CPU LE (RX); O BLOCO VIZINHO SUJO NAO PODE SE PERDER
+static void rx_cached(void){
+	uint8_t *b0 = dma_alloc(DMA_SERIAL_RX);
+	uint8_t *b1 = dma_alloc(DMA_SERIAL_RX);
+	uint8_t old[64], rx[64], mine[64], out[64];
+
+	fill(rx, sizeof(rx), 2);
+	fill(mine, sizeof(mine), 3);
+	cache_sim_cpu_read(old, b0, sizeof(old));
+	cache_sim_cpu_write(b1, mine, sizeof(mine));
+	cache_sim_dma_write(b0, rx, sizeof(rx));
+	cache_sim_cpu_read(out, b0, sizeof(out));
+	check(memcmp(out, old, sizeof(out)) == 0, "RX sem dma_invalidate: a CPU le o cache velho");
+	dma_invalidate(b0, sizeof(rx));
+	cache_sim_cpu_read(out, b0, sizeof(out));
+	check(memcmp(out, rx, sizeof(out)) == 0, "RX com dma_invalidate: a CPU le o DMA");
+	cache_sim_cpu_read(out, b1, sizeof(out));
+	check(memcmp(out, mine, sizeof(out)) == 0, "bloco vizinho intacto");
+	dma_free(DMA_SERIAL_RX, b0);
+	dma_free(DMA_SERIAL_RX, b1);
+}
+
+//BUFFER QUE NAO E DO POOL, DIVIDINDO LINHA COM OUTRO DADO
+static void rx_unaligned(void){
+	static uint8_t raw[3 * DMA_LINE] __attribute__((aligned(DMA_LINE)));
+	uint8_t head[8], rx[40], out[40];
+	cache_sim_stats before, after;
+
+	fill(head, sizeof(head), 4);
+	fill(rx, sizeof(rx), 5);
+	cache_sim_cpu_write(raw, head, sizeof(head));
+	dma_clean(raw + 8, sizeof(rx));
+	cache_sim_dma_write(raw + 8, rx, sizeof(rx));
+	cache_sim_get_stats(&before);
+	dma_invalidate(raw + 8, sizeof(rx));
+	cache_sim_get_stats(&after);
+	check(after.flushes - before.flushes == 2 && after.invalidates == before.invalidates,
+			"as duas pontas divididas sao limpas e invalidadas");
+	cache_sim_cpu_read(out, raw + 8, sizeof(rx));
+	check(memcmp(out, rx, sizeof(rx)) == 0, "RX fora de linha le o DMA");
+	cache_sim_cpu_read(out, raw, sizeof(head));
+	check(memcmp(out, head, sizeof(head)) == 0, "o dado antes do buffer sobrevive");
+}
+
+//NOCACHE: NENHUMA MANUTENCAO, NENHUMA CHAMADA AO BACK END
+static void nocache(void){
+	uint8_t *buf = dma_alloc(DMA_LCD_LINE);
+	uint8_t line[960], out[960];
+	cache_sim_stats before, after;
+
+	cache_sim_get_stats(&before);
+	fill(line, sizeof(line), 6);
+	cache_sim_cpu_write(buf, line, sizeof(line));
+	dma_clean(buf, sizeof(line));
+	cache_sim_dma_read(out, buf, sizeof(out));
+	check(memcmp(out, line, sizeof(out)) == 0, "NOCACHE: DMA le a CPU direto");
+	fill(line, sizeof(line), 7);
+	cache_sim_dma_write(buf, line, sizeof(line));
+	dma_invalidate(buf, sizeof(line));
+	cache_sim_cpu_read(out, buf, sizeof(out));
+	check(memcmp(out, line, sizeof(out)) == 0, "NOCACHE: CPU le o DMA direto");
+	cache_sim_get_stats(&after);
+	check(after.cleans == before.cleans && after.invalidates == before.invalidates
+			&& after.flushes == before.flushes && after.hits == before.hits, "NOCACHE nao passa pelo cache");
+	dma_free(DMA_LCD_LINE, buf);
+}
+
+int main(void){
+	cache_sim_stats s;
+
+	cache_sim_reset();
+	dma_pool_init();
+	pools();
+	bad_frees();
+	random_ops();
+	tx_cached();
+	rx_cached();
+	rx_unaligned();
+	nocache();
+
+	cache_sim_get_stats(&s);
+	check(s.unaligned == 0, "back end so recebe linhas inteiras");
+	printf("cache: %u acertos, %u faltas, %u gravacoes\n", s.hits, s.misses, s.writebacks);
+	printf("%s: %d erro(s)\n", errors ? "FALHOU" : "OK", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
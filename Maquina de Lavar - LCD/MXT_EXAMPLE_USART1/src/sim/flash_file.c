@@ -0,0 +1,135 @@
+/*
+ * flash_file.c
+ *
+ * Back end de host do flash_dev: a regiao e um arquivo (criado apagado, em
+ * 0xFF) com as regras da NOR do SAME70 conferidas a cada gravacao: bit so
+ * vai de 1 a 0 e cada bloco de FLASH_DEV_WRITE_ALIGN bytes so e gravado uma
+ * vez por apagamento; quebrar a regra conta em violations. Conta os bytes
+ * gravados e os apagamentos de cada setor (amplificacao e desgaste) e pode
+ * simular uma queda de energia: depois de N bytes a gravacao para no meio
+ * e todo acesso seguinte falha, ate o proximo flash_dev_init().
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include "flash_dev.h"
+
+#define BLOCKS  (FLASH_DEV_SIZE / FLASH_DEV_WRITE_ALIGN)
+#define NO_CUT  UINT32_MAX
+
+static const char *path = "flash_sim.bin";
+static FILE *file;
+static uint8_t image[FLASH_DEV_SIZE];
+static uint8_t programmed[BLOCKS];
+static uint32_t cut_after = NO_CUT;
+static bool dead;
+static flash_sim_stats stats;
+
+static bool sync_range(uint32_t offset, uint32_t len){
+	return fseek(file, offset, SEEK_SET) == 0
+			&& fwrite(image + offset, 1, len, file) == len
+			&& fflush(file) == 0;
+}
+
+void flash_sim_set_file(const char *p){
+	path = p;
+}
+
+//"LIGA" O CHIP: ABRE A IMAGEM (OU CRIA APAGADA) E ESQUECE A QUEDA ANTERIOR
+bool flash_dev_init(void){
+	if (file){
+		fclose(file);
+	}
+	dead = false;
+	file = fopen(path, "r+b");
+	if (file && fread(image, 1, FLASH_DEV_SIZE, file) == FLASH_DEV_SIZE){
+		//O QUE NAO ESTA EM 0xFF JA FOI GRAVADO
+		for (uint32_t b = 0; b < BLOCKS; b++){
+			programmed[b] = 0;
+			for (uint32_t i = 0; i < FLASH_DEV_WRITE_ALIGN; i++){
+				programmed[b] |= image[b * FLASH_DEV_WRITE_ALIGN + i] != 0xFF;
+			}
+		}
+		return true;
+	}
+	if (file){
+		fclose(file);
+	}
+	file = fopen(path, "w+b");
+	if (!file){
+		return false;
+	}
+	memset(image, 0xFF, sizeof(image));
+	memset(programmed, 0, sizeof(programmed));
+	return sync_range(0, FLASH_DEV_SIZE);
+}
+
+bool flash_dev_read(uint32_t offset, void *buf, uint32_t len){
+	if (dead || offset + len > FLASH_DEV_SIZE){
+		return false;
+	}
+	memcpy(buf, image + offset, len);
+	return true;
+}
+
+bool flash_dev_write(uint32_t offset, const void *data, uint32_t len){
+	const uint8_t *src = data;
+
+	if (dead || offset + len > FLASH_DEV_SIZE || (offset | len) % FLASH_DEV_WRITE_ALIGN){
+		return false;
+	}
+	for (uint32_t b = offset / FLASH_DEV_WRITE_ALIGN; b < (offset + len) / FLASH_DEV_WRITE_ALIGN; b++){
+		stats.violations += programmed[b];
+		programmed[b] = 1;
+	}
+	for (uint32_t i = 0; i < len; i++){
+		if (cut_after != NO_CUT && cut_after-- == 0){
+			dead = true;
+			sync_range(offset, i);
+			return false;
+		}
+		stats.violations += (src[i] & ~image[offset + i]) != 0;
+		image[offset + i] &= src[i];
+	}
+	stats.bytes_written += len;
+	return sync_range(offset, len);
+}
+
+bool flash_dev_erase(uint8_t sector){
+	uint32_t offset = (uint32_t)sector * FLASH_DEV_SECTOR_SIZE;
+
+	if (dead || sector >= FLASH_DEV_SECTORS){
+		return false;
+	}
+	//A QUEDA NO MEIO DE UM APAGAMENTO DEIXA O SETOR PELA METADE
+	if (cut_after != NO_CUT && cut_after < FLASH_DEV_SECTOR_SIZE){
+		memset(image + offset, 0xFF, FLASH_DEV_SECTOR_SIZE / 2);
+		dead = true;
+		cut_after = NO_CUT;
+		sync_range(offset, FLASH_DEV_SECTOR_SIZE);
+		return false;
+	}
+	if (cut_after != NO_CUT){
+		cut_after -= FLASH_DEV_SECTOR_SIZE;
+	}
+	memset(image + offset, 0xFF, FLASH_DEV_SECTOR_SIZE);
+	memset(programmed + offset / FLASH_DEV_WRITE_ALIGN, 0, FLASH_DEV_SECTOR_SIZE / FLASH_DEV_WRITE_ALIGN);
+	stats.erases[sector]++;
+	return sync_range(offset, FLASH_DEV_SECTOR_SIZE);
+}
+
+void flash_sim_power_cut_after(uint32_t bytes){
+	cut_after = bytes;
+}
+
+void flash_sim_get_stats(flash_sim_stats *out){
+	*out = stats;
+}
+
+void flash_sim_reset_stats(void){
+	memset(&stats, 0, sizeof(stats));
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,78 @@
+/*
+ * frame_sim.c
+ *
+ * Confere o frame_sched.c no host com tempos escritos (ms do relogio e
+ * ticks de 1 ns, como o prof_ticks() do host): periodo, pedidos juntados,
+ * quadro longo pulando periodos, estouro com a chamada mais cara e
+ * chamadas fora de um quadro.
+ *
+ *   gcc -DHOST_BUILD -I. sim/frame_sim.c frame_sched.c -o frame_sim && ./frame_sim
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include "frame_sched.h"
+#include "check.h"
+
+#define PERIOD_MS  50
+#define BUDGET_US  40000
+#define US         1000u   // ticks por us no host
+
+int main(void){
+	frame_stats s;
+
+	frame_init(PERIOD_MS, BUDGET_US, 0);
+	check(frame_ready(0), "primeiro quadro pendente no boot");
+
+	//QUADRO CURTO: DENTRO DO ORCAMENTO
+	frame_begin(0, 0);
+	frame_call(DRAW_BUTTONS, 0, 10 * US);
+	frame_call(DRAW_WASH_MODE, 10 * US, 40 * US);
+	check(!frame_end(0, 45 * US, 30), "quadro de 45 us sem estouro");
+	frame_get_stats(&s);
+	check(s.frames == 1 && s.overruns == 0 && s.last_us == 45 && s.flush_us == 30, "contagem e tempos");
+	check(!frame_pending() && !frame_ready(100), "sem pedido, sem quadro");
+
+	//TRES PEDIDOS ANTES DO PROXIMO PERIODO VIRAM UM QUADRO
+	frame_request();
+	frame_request();
+	frame_request();
+	frame_get_stats(&s);
+	check(s.coalesced == 2, "pedidos juntados");
+	check(!frame_ready(49) && frame_next_ms() == PERIOD_MS, "espera o periodo");
+	check(frame_ready(PERIOD_MS), "sai no periodo");
+
+	//QUADRO DE 125 ms: ESTOURA, OCUPA 3 PERIODOS E PULA 2
+	frame_begin(PERIOD_MS, 1000000 * US);
+	frame_call(DRAW_LOCK_ICON, 1000000 * US, 1001000 * US);
+	frame_call(DRAW_BUTTONS, 1001000 * US, 1031000 * US);
+	frame_call(DRAW_WASH_MODE, 1031000 * US, 1120000 * US);
+	frame_call(DRAW_TIMER, 1120000 * US, 1125000 * US);
+	check(frame_end(PERIOD_MS + 125, 1125000 * US, 110000), "quadro de 125 ms estoura");
+	frame_get_stats(&s);
+	check(s.overruns == 1 && s.worst_call == DRAW_WASH_MODE && s.worst_call_us == 89000,
+			"chamada mais cara: draw_wash_mode, 89 ms");
+	check(s.skipped == 2 && s.max_us == 125000, "2 periodos pulados");
+	frame_request();
+	check(!frame_ready(4 * PERIOD_MS - 1) && frame_ready(4 * PERIOD_MS), "proximo quadro no 4o periodo");
+
+	//CHAMADAS FORA DE UM QUADRO NAO CONTAM
+	frame_call(DRAW_LOCKSCREEN, 0, 500000 * US);
+	frame_begin(4 * PERIOD_MS, 0);
+	frame_call(DRAW_TIMER, 0, 60000 * US);
+	check(frame_end(4 * PERIOD_MS + 60, 60000 * US, 0), "estouro de 60 ms");
+	frame_get_stats(&s);
+	check(s.worst_call == DRAW_TIMER && s.overruns == 2 && s.skipped == 3, "chamada de fora ignorada");
+	check(frame_next_ms() == 6 * PERIOD_MS, "alinhado ao periodo");
+
+	//CONTADORES ZERAM, O AGENDAMENTO CONTINUA
+	frame_reset();
+	frame_get_stats(&s);
+	check(s.frames == 0 && s.worst_call == DRAW_NONE && frame_next_ms() == 6 * PERIOD_MS, "frame_reset");
+
+	printf("%s: %d erro(s)\n", errors ? "FALHOU" : "OK", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
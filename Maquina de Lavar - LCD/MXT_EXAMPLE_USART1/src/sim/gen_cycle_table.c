@@ -0,0 +1,165 @@
+/*
+ * gen_cycle_table.c
+ *
+ * Gera cycle_table.c a partir de ciclos.def. Roda no host com o mesmo
+ * wash_program.c e a mesma calibri_24.h do alvo, entao as duracoes e as
+ * larguras dos textos nao tem como divergir do que o firmware desenharia.
+ *
+ * Com --check so compara: sai com 1 se o cycle_table.c versionado nao bate
+ * com o que seria gerado (alguem mexeu no ciclos.def, no wash_program.c ou
+ * na fonte sem regerar). O pre-build do .cproj roda o --check e regera so
+ * quando precisa; o gate dos sims roda o --check sozinho.
+ *
+ *   gcc -DHOST_BUILD -I. sim/gen_cycle_table.c wash_program.c -o gen_cycle_table
+ *   ./gen_cycle_table > cycle_table.c
+ *   ./gen_cycle_table --check cycle_table.c
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "tfont.h"
+#include "calibri_24.h"
+#include "gui.h"
+#include "cycle_table.h"
+
+static const t_ciclo ciclos[CYCLE_COUNT] = {
+#define CICLO(id, n, enxT, enxQ, rpm, centT, h, b) \
+	[CYCLE_##id] = {.nome = n, .enxagueTempo = enxT, .enxagueQnt = enxQ, .centrifugacaoRPM = rpm, \
+			.centrifugacaoTempo = centT, .heavy = h, .bubblesOn = b},
+#include "ciclos.def"
+#undef CICLO
+};
+
+static const char *const ids[CYCLE_COUNT] = {
+#define CICLO(id, n, enxT, enxQ, rpm, centT, h, b) [CYCLE_##id] = #id,
+#include "ciclos.def"
+#undef CICLO
+};
+
+static const char *const phase_ids[] = {
+	[WASH_PHASE_FILL]      = "WASH_PHASE_FILL",
+	[WASH_PHASE_WASH]      = "WASH_PHASE_WASH",
+	[WASH_PHASE_RINSE]     = "WASH_PHASE_RINSE",
+	[WASH_PHASE_SPIN_RAMP] = "WASH_PHASE_SPIN_RAMP",
+	[WASH_PHASE_SPIN]      = "WASH_PHASE_SPIN",
+	[WASH_PHASE_DONE]      = "WASH_PHASE_DONE",
+};
+
+static FILE *out;
+
+//MESMA CONTA DO font_draw_text() DO main.c, SEM O ESPACO DEPOIS DA ULTIMA LETRA
+static unsigned text_width(const tFont *font, const char *text){
+	unsigned w = 0;
+
+	for (const char *p = text; *p; p++){
+		if (*p >= font->start_char && *p <= font->end_char){
+			w += font->chars[*p - font->start_char].image->width + SPACE;
+		}
+	}
+	return w ? w - SPACE : 0;
+}
+
+static void print_label(const char *text){
+	fprintf(out, "\t\t\t{\"%s\", %u},\n", text, text_width(&calibri_24, text));
+}
+
+static void print_entry(uint8_t i){
+	const t_ciclo *c = &ciclos[i];
+	t_ciclo heavy = *c;
+	wash_program p, ph;
+	char s[CYCLE_LABELS][32];
+
+	heavy.heavy = 1;
+	wash_program_compile(c, &p);
+	wash_program_compile(&heavy, &ph);
+
+	//OS MESMOS FORMATOS QUE O draw_wash_mode() USAVA
+	snprintf(s[CYCLE_LABEL_NAME], 32, "%s", c->nome);
+	snprintf(s[CYCLE_LABEL_RINSE_TIME], 32, "%d minutos", c->enxagueTempo);
+	snprintf(s[CYCLE_LABEL_RINSES], 32, "%d enxagues", c->enxagueQnt);
+	snprintf(s[CYCLE_LABEL_RPM], 32, "%d RPM", c->centrifugacaoRPM);
+	snprintf(s[CYCLE_LABEL_SPIN_TIME], 32, "%d minutos", c->centrifugacaoTempo);
+
+	fprintf(out, "\t[CYCLE_%s] = {\n", ids[i]);
+	fprintf(out, "\t\t.ciclo = {.nome = \"%s\", .enxagueTempo = %d, .enxagueQnt = %d, .centrifugacaoRPM = %d,\n"
+			"\t\t\t\t.centrifugacaoTempo = %d, .heavy = %d, .bubblesOn = %d},\n",
+			c->nome, c->enxagueTempo, c->enxagueQnt, c->centrifugacaoRPM,
+			c->centrifugacaoTempo, c->heavy, c->bubblesOn);
+	fprintf(out, "\t\t.program = {\n\t\t\t.phases = {\n");
+	for (uint8_t k = 0; k < p.count; k++){
+		const wash_phase *f = &p.phases[k];
+		fprintf(out, "\t\t\t\t{%s, %u, %u, %lu, %lu},\n", phase_ids[f->type], f->index, f->rpm,
+				(unsigned long)f->start_ms, (unsigned long)f->duration_ms);
+	}
+	fprintf(out, "\t\t\t},\n\t\t\t.count = %u,\n\t\t\t.total_ms = %lu\n\t\t},\n", p.count, (unsigned long)p.total_ms);
+	fprintf(out, "\t\t.total_ms = %lu,\n", (unsigned long)p.total_ms);
+	fprintf(out, "\t\t.heavy_ms = %lu,\n", (unsigned long)ph.total_ms);
+	fprintf(out, "\t\t.labels = {\n");
+	for (uint8_t k = 0; k < CYCLE_LABELS; k++){
+		print_label(s[k]);
+	}
+	fprintf(out, "\t\t}\n\t},\n");
+}
+
+static void generate(void){
+	fprintf(out, "/*\n * cycle_table.c\n *\n"
+			" * GERADO por sim/gen_cycle_table.c a partir de ciclos.def; nao editar.\n"
+			" * Fases: {tipo, enxague, rpm, inicio_ms, duracao_ms}.\n */\n\n"
+			"#include \"cycle_table.h\"\n\n"
+			"const cycle_entry cycle_table[CYCLE_COUNT] = {\n");
+	for (uint8_t i = 0; i < CYCLE_COUNT; i++){
+		print_entry(i);
+	}
+	fprintf(out, "};\n");
+}
+
+//PROXIMO BYTE SEM OS \r, PARA UM CHECKOUT COM CRLF NAO CONTAR COMO DIFERENCA
+static int next_byte(FILE *f){
+	int c;
+
+	while ((c = fgetc(f)) == '\r'){
+	}
+	return c;
+}
+
+//0 SE path E EXATAMENTE O QUE generate() ESCREVE
+static int check(const char *path){
+	FILE *f = fopen(path, "rb");
+	int a, b;
+	unsigned line = 1;
+
+	out = tmpfile();
+	if (!f || !out){
+		printf("nao abriu %s\n", path);
+		return 1;
+	}
+	generate();
+	rewind(out);
+	do {
+		a = next_byte(out);
+		b = next_byte(f);
+		line += a == '\n';
+	} while (a == b && a != EOF);
+	fclose(f);
+	fclose(out);
+	if (a != b){
+		printf("FALHOU: %s difere do gerado na linha %u; rode ./gen_cycle_table > cycle_table.c\n", path, line);
+		return 1;
+	}
+	printf("OK: %s igual ao gerado\n", path);
+	return 0;
+}
+
+int main(int argc, char *argv[]){
+	if (argc == 3 && strcmp(argv[1], "--check") == 0){
+		return check(argv[2]);
+	}
+	out = stdout;
+	generate();
+	return 0;
+}
+
+#endif /* HOST_BUILD */
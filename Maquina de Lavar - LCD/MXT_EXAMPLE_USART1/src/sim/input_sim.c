@@ -0,0 +1,33 @@
+/*
+ * input_sim.c
+ *
+ * Back end de host do input: o nivel de cada entrada fica num vetor e
+ * input_sim_set() muda o nivel e chama on_edge na hora, como faria a
+ * interrupcao do PIO.
+ */
+
+#ifdef HOST_BUILD
+
+#include "input.h"
+
+static bool levels[INPUT_MAX];
+static input_edge_handler edge;
+
+void input_hw_init(const input_pin pins[], uint8_t n, input_edge_handler on_edge){
+	edge = on_edge;
+}
+
+bool input_hw_read(uint8_t index){
+	return levels[index];
+}
+
+void input_sim_set(uint8_t index, bool pressed){
+	if (levels[index] != pressed){
+		levels[index] = pressed;
+		if (edge){
+			edge(index);
+		}
+	}
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,207 @@
+/*
+ * kv_bench.c
+ *
+ * Testa e mede o kv_store no host, sobre a flash em arquivo
+ * (sim/flash_file.c):
+ *  - operacoes basicas e persistencia entre kv_mount();
+ *  - queda de energia em cada ponto de uma sequencia de gravacoes: depois
+ *    de remontar, toda chave tem o valor anterior ou o novo da operacao
+ *    cortada e as outras estao intactas;
+ *  - amplificacao de escrita e desgaste salvando programas de usuario
+ *    (user_programs.c) em slots aleatorios.
+ *
+ *   gcc -DHOST_BUILD -I. sim/kv_bench.c sim/flash_file.c kv_store.c crc32.c user_programs.c -o kv_bench
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "flash_dev.h"
+#include "kv_store.h"
+#include "user_programs.h"
+
+#define FILE_NAME   "kv_bench.bin"
+#define TEST_KEYS   12
+#define VALUE_MAX   64
+
+static int errors;
+static uint32_t violations;
+
+#define CHECK(cond) do { if (!(cond)){ printf("  falhou: %s (linha %d)\n", #cond, __LINE__); errors++; } } while (0)
+
+//VALOR DETERMINISTICO DA VERSAO v DA CHAVE k
+static uint16_t make_value(uint16_t k, uint32_t v, uint8_t *out){
+	uint16_t len = 1 + (k * 7 + v * 13) % VALUE_MAX;
+
+	for (uint16_t i = 0; i < len; i++){
+		out[i] = (uint8_t)(k * 31 + v * 17 + i);
+	}
+	return len;
+}
+
+static bool has_version(uint16_t k, uint32_t v){
+	uint8_t want[VALUE_MAX], got[VALUE_MAX];
+	uint16_t len, n = make_value(k, v, want);
+
+	return kv_get(k, got, sizeof(got), &len) == KV_OK && len == n && memcmp(want, got, n) == 0;
+}
+
+static void fresh(void){
+	remove(FILE_NAME);
+	flash_sim_power_cut_after(UINT32_MAX);
+	flash_sim_reset_stats();
+}
+
+static void test_basic(void){
+	uint8_t v[VALUE_MAX];
+	uint16_t len;
+
+	printf("basico\n");
+	fresh();
+	CHECK(kv_mount() == KV_OK);
+	CHECK(kv_count() == 0);
+	CHECK(kv_get(1, v, sizeof(v), &len) == KV_ERR_NOT_FOUND);
+
+	for (uint16_t k = 0; k < TEST_KEYS; k++){
+		CHECK(kv_put(k, v, make_value(k, 0, v)) == KV_OK);
+	}
+	CHECK(kv_put(3, v, make_value(3, 1, v)) == KV_OK);
+	CHECK(kv_delete(5) == KV_OK);
+	CHECK(kv_delete(5) == KV_ERR_NOT_FOUND);
+	CHECK(kv_put(1, v, KV_MAX_VALUE + 1) == KV_ERR_TOO_BIG);
+	CHECK(kv_get(3, v, 1, &len) == KV_ERR_TOO_BIG || make_value(3, 1, v) <= 1);
+
+	//REMONTA: O INDICE VEM SO DO LOG
+	CHECK(kv_mount() == KV_OK);
+	CHECK(kv_count() == TEST_KEYS - 1);
+	CHECK(has_version(3, 1));
+	CHECK(has_version(0, 0) && has_version(TEST_KEYS - 1, 0));
+	CHECK(!kv_exists(5));
+
+	//MUITAS VOLTAS NO ANEL: A COMPACTACAO TEM QUE PRESERVAR TUDO
+	for (uint32_t i = 1; i <= 5000; i++){
+		uint16_t k = i % TEST_KEYS;
+		CHECK(kv_put(k, v, make_value(k, i, v)) == KV_OK);
+	}
+	CHECK(kv_mount() == KV_OK);
+	for (uint32_t i = 5000 - TEST_KEYS + 1; i <= 5000; i++){
+		CHECK(has_version(i % TEST_KEYS, i));
+	}
+
+	//O INDICE CHEIO COM VALORES MAXIMOS AINDA CABE; SO FALTA CHAVE
+	fresh();
+	CHECK(kv_mount() == KV_OK);
+	uint16_t k = 0;
+	while (kv_put(k, v, KV_MAX_VALUE) == KV_OK){
+		k++;
+	}
+	CHECK(k == KV_MAX_KEYS);
+	CHECK(kv_put(k, v, 1) == KV_ERR_FULL);
+	for (uint32_t i = 0; i < 1000; i++){
+		CHECK(kv_put(i % KV_MAX_KEYS, v, KV_MAX_VALUE) == KV_OK);
+	}
+	CHECK(kv_mount() == KV_OK && kv_count() == KV_MAX_KEYS);
+}
+
+//CORTA A ENERGIA DEPOIS DE cut BYTES DA SEQUENCIA E CONFERE O QUE SOBROU
+static bool power_cut_run(uint32_t cut, uint32_t ops){
+	uint32_t version[TEST_KEYS];
+	uint8_t v[VALUE_MAX];
+	uint32_t i;
+	bool cut_hit = false;
+
+	fresh();
+	kv_mount();
+	for (uint16_t k = 0; k < TEST_KEYS; k++){
+		kv_put(k, v, make_value(k, 0, v));
+		version[k] = 0;
+	}
+	flash_sim_power_cut_after(cut);
+	for (i = 1; i <= ops; i++){
+		uint16_t k = (i * 5) % TEST_KEYS;
+		if (kv_put(k, v, make_value(k, i, v)) != KV_OK){
+			cut_hit = true;
+			break;
+		}
+		version[k] = i;
+	}
+	flash_sim_power_cut_after(UINT32_MAX);
+
+	//REBOOT
+	CHECK(kv_mount() == KV_OK);
+	for (uint16_t k = 0; k < TEST_KEYS; k++){
+		bool in_flight = cut_hit && k == (i * 5) % TEST_KEYS;
+		CHECK(has_version(k, version[k]) || (in_flight && has_version(k, i)));
+	}
+	//E CONTINUA FUNCIONANDO
+	CHECK(kv_put(0, v, make_value(0, 99999, v)) == KV_OK && has_version(0, 99999));
+	CHECK(kv_mount() == KV_OK && has_version(0, 99999));
+
+	flash_sim_stats fs;
+	flash_sim_get_stats(&fs);
+	violations += fs.violations;
+	return cut_hit;
+}
+
+static void test_power_cut(void){
+	uint32_t runs = 0;
+	int before = errors;
+
+	printf("queda de energia\n");
+	for (uint32_t cut = 0; power_cut_run(cut, 1500); cut += 97){
+		runs++;
+	}
+	CHECK(violations == 0);
+	printf("  %lu pontos de corte%s\n", (unsigned long)runs, errors != before ? ", ERRO" : "");
+}
+
+static void bench(uint32_t saves){
+	t_ciclo c = {.nome = "Meu ciclo", .enxagueTempo = 10, .enxagueQnt = 2,
+			.centrifugacaoRPM = 1000, .centrifugacaoTempo = 6};
+	flash_sim_stats fs;
+	kv_stats ks;
+	clock_t t0;
+	double mount_ms;
+
+	printf("amplificacao: %lu programas salvos em %u slots\n", (unsigned long)saves, USER_PROGRAM_SLOTS);
+	fresh();
+	kv_mount();
+	srand(1);
+	for (uint32_t i = 0; i < saves; i++){
+		c.enxagueTempo = 5 + i % 20;
+		CHECK(user_program_save(rand() % USER_PROGRAM_SLOTS, &c) == KV_OK);
+	}
+	kv_get_stats(&ks);
+	flash_sim_get_stats(&fs);
+
+	t0 = clock();
+	CHECK(kv_mount() == KV_OK);
+	mount_ms = (clock() - t0) * 1000.0 / CLOCKS_PER_SEC;
+	CHECK(user_program_count() == USER_PROGRAM_SLOTS);
+
+	uint32_t emin = UINT32_MAX, emax = 0;
+	for (uint8_t s = 0; s < FLASH_DEV_SECTORS; s++){
+		emin = fs.erases[s] < emin ? fs.erases[s] : emin;
+		emax = fs.erases[s] > emax ? fs.erases[s] : emax;
+	}
+	printf("  %lu B de valor, %lu B gravados: amplificacao %.2f\n", (unsigned long)ks.user_bytes,
+			(unsigned long)fs.bytes_written, (double)fs.bytes_written / ks.user_bytes);
+	printf("  %lu compactacoes, apagamentos por setor %lu..%lu\n", (unsigned long)ks.compactions,
+			(unsigned long)emin, (unsigned long)emax);
+	printf("  mount: %u chaves, %.3f ms\n", kv_count(), mount_ms);
+}
+
+int main(int argc, char **argv){
+	flash_sim_set_file(FILE_NAME);
+	test_basic();
+	test_power_cut();
+	bench(argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 20000);
+	remove(FILE_NAME);
+	printf("%d erros\n", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
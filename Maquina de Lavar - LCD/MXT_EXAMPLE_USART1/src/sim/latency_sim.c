@@ -0,0 +1,134 @@
+/*
+ * latency_sim.c
+ *
+ * Regressao do latency.c no host: o relogio e o simulado
+ * (latency_sim_advance()) e cada cenario marca as etapas com tempos
+ * escritos, como o main faria, e confere min, max e o balde do histograma
+ * de cada etapa. Cobre a espera na fila entre a borda do CHG e o main,
+ * etapa pulada, marca repetida, quadro sem toque e a volta do contador.
+ *
+ *   gcc -DHOST_BUILD -I. sim/latency_sim.c latency.c -o latency_sim && ./latency_sim
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include "latency.h"
+#include "check.h"
+
+#define CPU_MHZ  300
+
+static void advance_us(uint32_t us){
+	latency_sim_advance(us * CPU_MHZ);
+}
+
+static uint8_t bucket_of(uint32_t us){
+	uint8_t b = 0;
+
+	while (us > 1 && b < LATENCY_BUCKETS - 1){
+		us >>= 1;
+		b++;
+	}
+	return b;
+}
+
+//UMA AMOSTRA COMPLETA: FILA, TWI, HIT, CALLBACK, ICONE (us)
+static void touch(const uint32_t us[LAT_STAGES]){
+	uint32_t chg = latency_now();    // Touch_Handler
+
+	advance_us(us[LAT_CHG]);          // evento esperando na fila
+	latency_mark_at(LAT_CHG, chg);
+	for (uint8_t s = LAT_TWI; s < LAT_STAGES; s++){
+		advance_us(us[s]);
+		latency_mark(s);
+	}
+}
+
+static int stage_is(uint8_t stage, uint32_t min, uint32_t max, uint32_t count){
+	latency_stats s;
+	uint32_t total = 0;
+
+	latency_get_stats(stage, &s);
+	for (uint8_t b = 0; b < LATENCY_BUCKETS; b++){
+		total += s.hist[b];
+	}
+	if (count == 0){
+		return total == 0 && s.min_us == UINT32_MAX && s.max_us == 0;
+	}
+	return s.min_us == min && s.max_us == max && total == count && s.hist[bucket_of(min)] >= 1
+			&& s.hist[bucket_of(max)] >= 1;
+}
+
+int main(void){
+	const uint32_t fast[LAT_STAGES] = {200, 120, 8, 40, 2500};
+	const uint32_t slow[LAT_STAGES] = {9000, 300, 12, 60, 40000};
+
+	latency_init(CPU_MHZ * 1000000u);
+
+	//UMA AMOSTRA: A ESPERA NA FILA ENTRA NA PRIMEIRA ETAPA E NO TOTAL
+	touch(fast);
+	check(latency_count() == 1, "uma amostra");
+	check(stage_is(LAT_TWI, 320, 320, 1), "twi conta da borda, com a fila");
+	check(stage_is(LAT_HIT, 8, 8, 1) && stage_is(LAT_CALLBACK, 40, 40, 1), "hit e callback");
+	check(stage_is(LAT_DISPLAY, 2500, 2500, 1), "display");
+	check(stage_is(LAT_CHG, 2868, 2868, 1), "total desde a borda do CHG");
+
+	//SEGUNDA AMOSTRA: MIN E MAX, E O TOTAL ACIMA DE 32 ms NO ULTIMO BALDE
+	touch(slow);
+	check(latency_count() == 2 && stage_is(LAT_TWI, 320, 9300, 2), "min e max da etapa");
+	latency_stats s;
+	latency_get_stats(LAT_CHG, &s);
+	check(s.hist[LATENCY_BUCKETS - 1] == 1 && s.max_us == 49372, "total longo no ultimo balde");
+
+	//QUADRO SEM TOQUE: O ICONE SEM AMOSTRA ABERTA NAO CONTA
+	advance_us(1000);
+	latency_mark(LAT_DISPLAY);
+	check(latency_count() == 2, "icone sem toque ignorado");
+
+	//LEITURA SEM PRESS: NAO HA HIT-TEST, A AMOSTRA E DESCARTADA
+	latency_mark(LAT_CHG);
+	advance_us(100);
+	latency_mark(LAT_TWI);
+	advance_us(50);
+	latency_mark(LAT_CALLBACK);
+	advance_us(50);
+	latency_mark(LAT_DISPLAY);
+	check(latency_count() == 2, "etapa pulada descarta");
+
+	//MARCA REPETIDA (VARIAS MENSAGENS NUMA LEITURA) FICA COM A PRIMEIRA
+	latency_mark(LAT_CHG);
+	advance_us(100);
+	latency_mark(LAT_TWI);
+	advance_us(100);
+	latency_mark(LAT_TWI);
+	advance_us(10);
+	latency_mark(LAT_HIT);
+	advance_us(10);
+	latency_mark(LAT_CALLBACK);
+	advance_us(10);
+	latency_mark(LAT_DISPLAY);
+	check(latency_count() == 3 && stage_is(LAT_TWI, 100, 9300, 3), "marca repetida ignorada");
+	check(stage_is(LAT_HIT, 8, 110, 3), "hit conta do primeiro twi");
+
+	//NOVO CHG NO MEIO RECOMECA A AMOSTRA
+	latency_reset();
+	latency_mark(LAT_CHG);
+	advance_us(5000);
+	latency_mark(LAT_CHG);
+	touch(fast);
+	check(latency_count() == 1 && stage_is(LAT_CHG, 2868, 2868, 1), "CHG novo recomeca");
+
+	//CONTADOR DE 32 BITS DANDO A VOLTA NO MEIO DA AMOSTRA
+	latency_reset();
+	latency_sim_advance(UINT32_MAX - latency_now() - 100 * CPU_MHZ);
+	touch(fast);
+	check(latency_count() == 1 && stage_is(LAT_CHG, 2868, 2868, 1), "volta do CYCCNT");
+
+	latency_reset();
+	check(latency_count() == 0 && stage_is(LAT_TWI, 0, 0, 0), "reset limpa");
+
+	printf("%s: %d erro(s)\n", errors ? "FALHOU" : "OK", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,210 @@
+/*
+ * lcd_spi_sim.c
+ *
+ * O ili9488_init() liga o SPI0 por registrador (spi_enable() e
+ * spi_enable_interrupt() sao inline), entao a pagina do SPI0 e mapeada no
+ * endereco real, como os PIOs no mxt_sim.c. O resto e funcao: o D/C diz se
+ * o byte e comando ou dado, e o comando anterior diz o que o dado e.
+ * Os dados do RAMWR andam pela janela como no controlador: ate o fim da
+ * coluna, proxima linha, e do fim da janela de volta ao inicio.
+ */
+
+#ifdef HOST_BUILD
+
+#include <asf.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "lcd_spi_sim.h"
+
+#define SPI_PAGE_BASE     0x40008000u
+#define SPI_PAGE_SIZE     0x1000u
+
+#define CMD_CASET         0x2A
+#define CMD_PASET         0x2B
+#define CMD_RAMWR         0x2C
+#define CMD_READ_ID4      0xD3
+#define CMD_READ_SETTINGS 0xFB
+
+#define RGB_BYTES         3
+
+static uint8_t dc;               // nivel do pino D/C: 0 comando, 1 dado
+static uint8_t last_cmd;
+static uint8_t read_index;       // parametro do 0xFB: qual byte o 0xD3 devolve
+static uint32_t ram_bytes;       // dados desde o ultimo RAMWR
+static lcd_sim_stats stats;
+
+static uint8_t params[4];        // CASET/PASET: inicio e fim, 16 bits big-endian
+static uint8_t param_count;
+static uint16_t col_start, col_end = LCD_SIM_WIDTH - 1;
+static uint16_t row_start, row_end = LCD_SIM_HEIGHT - 1;
+static uint16_t cur_x, cur_y;
+static uint8_t pixel[RGB_BYTES];
+static uint8_t pixel_bytes;
+static uint8_t gram[LCD_SIM_HEIGHT][LCD_SIM_WIDTH][RGB_BYTES];
+static uint8_t touched[LCD_SIM_HEIGHT][LCD_SIM_WIDTH];
+
+//ID4 DO ILI9488: 0x81 -> 0x00, 0x82 -> 0x94, 0x83 -> 0x88
+static uint8_t id4_byte(void){
+	switch (read_index){
+	case 0x82: return (ILI9488_DEVICE_CODE >> 8) & 0xFF;
+	case 0x83: return ILI9488_DEVICE_CODE & 0xFF;
+	default:   return 0;
+	}
+}
+
+static void flush_ram(void){
+	stats.pixels += ram_bytes / RGB_BYTES;
+	ram_bytes = 0;
+}
+
+static void window_param(uint8_t b){
+	if (param_count >= sizeof(params)){
+		return;
+	}
+	params[param_count++] = b;
+	if (param_count < sizeof(params)){
+		return;
+	}
+	uint16_t start = (params[0] << 8) | params[1];
+	uint16_t end = (params[2] << 8) | params[3];
+	if (last_cmd == CMD_CASET){
+		col_start = start;
+		col_end = end;
+	} else {
+		row_start = start;
+		row_end = end;
+	}
+}
+
+static void gram_byte(uint8_t b){
+	pixel[pixel_bytes++] = b;
+	if (pixel_bytes < RGB_BYTES){
+		return;
+	}
+	pixel_bytes = 0;
+	if (cur_x < LCD_SIM_WIDTH && cur_y < LCD_SIM_HEIGHT){
+		memcpy(gram[cur_y][cur_x], pixel, RGB_BYTES);
+		touched[cur_y][cur_x] = 1;
+	}
+	if (cur_x++ >= col_end){
+		cur_x = col_start;
+		if (cur_y++ >= row_end){
+			cur_y = row_start;
+		}
+	}
+}
+
+static void on_byte(uint8_t b){
+	stats.bytes++;
+	if (!dc){
+		flush_ram();
+		stats.commands++;
+		last_cmd = b;
+		param_count = 0;
+		if (b == CMD_CASET){
+			stats.windows++;
+		} else if (b == CMD_RAMWR){
+			stats.draws++;
+			cur_x = col_start;
+			cur_y = row_start;
+			pixel_bytes = 0;
+		}
+		return;
+	}
+	if (last_cmd == CMD_RAMWR){
+		ram_bytes++;
+		gram_byte(b);
+	} else if (last_cmd == CMD_CASET || last_cmd == CMD_PASET){
+		window_param(b);
+	} else if (last_cmd == CMD_READ_SETTINGS){
+		read_index = b;
+	}
+}
+
+int lcd_sim_init(void){
+	static int mapped = 0;
+
+	if (!mapped){
+		void *p = mmap((void *)SPI_PAGE_BASE, SPI_PAGE_SIZE, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+		if (p != (void *)SPI_PAGE_BASE){
+			return 0;
+		}
+		mapped = 1;
+	}
+	lcd_sim_reset();
+	return 1;
+}
+
+void lcd_sim_reset(void){
+	flush_ram();
+	memset(&stats, 0, sizeof(stats));
+	memset(touched, 0, sizeof(touched));
+}
+
+void lcd_sim_get_stats(lcd_sim_stats *out){
+	flush_ram();
+	*out = stats;
+}
+
+const uint8_t *lcd_sim_gram(void){
+	return &gram[0][0][0];
+}
+
+const uint8_t *lcd_sim_touched(void){
+	return &touched[0][0];
+}
+
+//TEMPO NO FIO A baud, 8 BITS POR BYTE, SEM AS PAUSAS ENTRE TRANSFERENCIAS
+uint32_t lcd_sim_wire_us(uint32_t bytes, uint32_t baud){
+	return (uint32_t)((uint64_t)bytes * 8 * 1000000 / baud);
+}
+
+//####################################################################
+//TRANSPORTE QUE O ili9488.c CHAMA
+
+void pio_set_pin_high(uint32_t pin){
+	if (pin == LCD_SPI_CDS_PIO){
+		dc = 1;
+	}
+}
+
+void pio_set_pin_low(uint32_t pin){
+	if (pin == LCD_SPI_CDS_PIO){
+		dc = 0;
+	}
+}
+
+spi_status_t spi_write(Spi *p_spi, uint16_t us_data, uint8_t uc_pcs, uint8_t uc_last){
+	on_byte(us_data & 0xFF);
+	return SPI_OK;
+}
+
+status_code_t spi_write_packet(Spi *p_spi, const uint8_t *data, size_t len){
+	for (size_t i = 0; i < len; i++){
+		on_byte(data[i]);
+	}
+	return STATUS_OK;
+}
+
+status_code_t spi_read_packet(Spi *p_spi, uint8_t *data, size_t len){
+	for (size_t i = 0; i < len; i++){
+		data[i] = last_cmd == CMD_READ_ID4 ? id4_byte() : 0;
+	}
+	return STATUS_OK;
+}
+
+void spi_master_init(Spi *p_spi){
+}
+
+void spi_master_setup_device(Spi *p_spi, struct spi_device *device, spi_flags_t flags, uint32_t baud_rate,
+		board_spi_select_id_t sel_id){
+}
+
+void spi_select_device(Spi *p_spi, struct spi_device *device){
+}
+
+void spi_configure_cs_behavior(Spi *p_spi, uint32_t ul_pcs_ch, uint32_t ul_cs_behavior){
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,40 @@
+/*
+ * lcd_spi_sim.h
+ *
+ * ILI9488 de mentira para o host (HOST_BUILD), no transporte: implementa
+ * spi_write(), spi_write_packet(), spi_read_packet() e o pino D/C
+ * (pio_set_pin_high/low) que o driver do ASF usa no modo SPI. O driver e
+ * as telas rodam sem mudanca e o modelo conta o que iria pelo fio. A GRAM
+ * tambem e modelada (CASET/PASET e RAMWR, sem o MADCTL), com um mapa de
+ * quais pixels foram escritos desde o lcd_sim_reset().
+ */
+
+
+#ifndef LCD_SPI_SIM_H_
+#define LCD_SPI_SIM_H_
+
+#ifdef HOST_BUILD
+
+#include <stdint.h>
+
+#define LCD_SIM_WIDTH   320
+#define LCD_SIM_HEIGHT  480
+
+typedef struct {
+	uint32_t bytes;      // tudo que passou pelo SPI, comandos e dados
+	uint32_t commands;   // bytes com D/C baixo
+	uint32_t windows;    // CASET (0x2A): janelas abertas
+	uint32_t draws;      // RAMWR (0x2C): escritas na GRAM
+	uint32_t pixels;     // bytes de dados depois do RAMWR / 3 (RGB666)
+} lcd_sim_stats;
+
+int lcd_sim_init(void);
+void lcd_sim_reset(void);
+void lcd_sim_get_stats(lcd_sim_stats *out);
+uint32_t lcd_sim_wire_us(uint32_t bytes, uint32_t baud);
+const uint8_t *lcd_sim_gram(void);       // RGB, LCD_SIM_WIDTH * 3 bytes por linha
+const uint8_t *lcd_sim_touched(void);    // 1 byte por pixel, 1 = escrito
+
+#endif /* HOST_BUILD */
+
+#endif /* LCD_SPI_SIM_H_ */
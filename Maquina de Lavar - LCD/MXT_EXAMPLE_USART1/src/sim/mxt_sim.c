@@ -0,0 +1,334 @@
+/*
+ * mxt_sim.c
+ *
+ * O driver le PIO_PDSR direto (ioport_get_pin_level() e inline), entao a
+ * pagina dos PIOs e mapeada no endereco real do SAME70 e o simulador
+ * escreve o nivel do CHG nela.
+ */
+
+#ifdef HOST_BUILD
+
+#include <asf.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "mxt_sim.h"
+
+#define ID_BLOCK_SIZE     7
+#define OBJECT_ENTRY_SIZE 6
+#define T5_READ_SIZE      9
+#define TRACE_MAX         4096
+
+#define PIO_PAGE_BASE     0x400E0000u
+#define PIO_PAGE_SIZE     0x2000u
+
+const mxt_sim_config mxt_sim_default_config = {
+	.family_id  = 0x81,
+	.variant_id = 0x07,
+	.version    = 0x10,
+	.build      = 0xAA,
+	.matrix_x   = 14,
+	.matrix_y   = 8,
+	.obj_count  = 9,
+	.objects = {
+		{MXT_GEN_MESSAGEPROCESSOR_T5,   T5_READ_SIZE, 0},
+		{MXT_GEN_COMMANDPROCESSOR_T6,   6,  1},
+		{MXT_GEN_POWERCONFIG_T7,        4,  0},
+		{MXT_GEN_ACQUISITIONCONFIG_T8,  10, 0},
+		{MXT_TOUCH_MULTITOUCHSCREEN_T9, 36, 10},
+		{MXT_SPT_COMMSCONFIG_T18,       2,  0},
+		{MXT_SPT_MESSAGECOUNT_T44,      1,  0},
+		{MXT_SPT_CTE_CONFIGURATION_T46, 9,  0},
+		{MXT_PROCI_SHIELDLESS_T56,      33, 0},
+	}
+};
+
+typedef struct {
+	uint8_t data[T5_READ_SIZE];
+} sim_message;
+
+static uint8_t mem[MXT_SIM_MEM_SIZE];
+static uint16_t t5_addr, t6_addr, t44_addr;
+static uint8_t t6_report_id, t9_report_id;
+
+static sim_message queue[MXT_SIM_QUEUE_SIZE];
+static uint8_t q_head, q_tail, q_count;
+
+static volatile uint32_t *chg_pdsr;
+static uint32_t chg_mask;
+
+static const mxt_sim_touch *script;
+static uint32_t script_size, script_pos;
+static mxt_sim_touch trace[TRACE_MAX];
+static uint64_t now_us;
+
+static mxt_sim_stats stats;
+
+//MESMO CRC24 DO DRIVER (mxt_device_1.c)
+static uint32_t crc_24(uint32_t crc, uint8_t byte1, uint8_t byte2){
+	uint32_t result = (crc << 1u) ^ (uint32_t)((uint16_t)(byte2 << 8u) | byte1);
+
+	if (result & 0x1000000){
+		result ^= 0x80001B;
+	}
+	return result;
+}
+
+static uint32_t info_crc(uint16_t size){
+	uint32_t crc = 0;
+	uint16_t i;
+
+	for (i = 0; i + 1 < size; i += 2){
+		crc = crc_24(crc, mem[i], mem[i + 1]);
+	}
+	if (size & 1){
+		crc = crc_24(crc, mem[size - 1], 0);
+	}
+	return crc & 0x00FFFFFF;
+}
+
+//CHG E ATIVO EM NIVEL BAIXO: BAIXO ENQUANTO HOUVER MENSAGEM NA FILA
+static void update_chg(void){
+	if (q_count){
+		*chg_pdsr &= ~chg_mask;
+	} else {
+		*chg_pdsr |= chg_mask;
+	}
+	mem[t44_addr] = q_count;
+}
+
+static void push_message(uint8_t report_id, const uint8_t *msg, uint8_t len){
+	if (q_count == MXT_SIM_QUEUE_SIZE){
+		stats.messages_dropped++;
+		return;
+	}
+	sim_message *m = &queue[q_tail];
+	memset(m->data, 0, sizeof(m->data));
+	m->data[0] = report_id;
+	memcpy(&m->data[1], msg, len);
+	q_tail = (q_tail + 1) % MXT_SIM_QUEUE_SIZE;
+	q_count++;
+	update_chg();
+}
+
+static void pop_message(uint8_t *out){
+	if (q_count == 0){
+		memset(out, 0, T5_READ_SIZE);
+		out[0] = 0xFF; // fila vazia, como no chip real
+		return;
+	}
+	memcpy(out, queue[q_head].data, T5_READ_SIZE);
+	q_head = (q_head + 1) % MXT_SIM_QUEUE_SIZE;
+	q_count--;
+	stats.messages_sent++;
+	update_chg();
+}
+
+//MAPEIA OS REGISTRADORES DE PIO NO ENDERECO REAL PARA O ioport_get_pin_level()
+static int map_pio(uint32_t chgpin){
+	static int mapped = 0;
+
+	if (!mapped){
+		void *p = mmap((void *)PIO_PAGE_BASE, PIO_PAGE_SIZE, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+		if (p != (void *)PIO_PAGE_BASE){
+			return 0;
+		}
+		mapped = 1;
+	}
+	Pio *pio = arch_ioport_pin_to_base(chgpin);
+	chg_pdsr = (volatile uint32_t *)&pio->PIO_PDSR;
+	chg_mask = arch_ioport_pin_to_mask(chgpin);
+	return 1;
+}
+
+int mxt_sim_init(const mxt_sim_config *config, uint32_t chgpin){
+	if (config == NULL){
+		config = &mxt_sim_default_config;
+	}
+	if (!map_pio(chgpin)){
+		return 0;
+	}
+
+	memset(mem, 0, sizeof(mem));
+	memset(&stats, 0, sizeof(stats));
+	q_head = q_tail = q_count = 0;
+	script = NULL;
+	script_size = script_pos = 0;
+	now_us = 0;
+
+	mem[0] = config->family_id;
+	mem[1] = config->variant_id;
+	mem[2] = config->version;
+	mem[3] = config->build;
+	mem[4] = config->matrix_x;
+	mem[5] = config->matrix_y;
+	mem[6] = config->obj_count;
+
+	//TABELA DE OBJETOS, CRC E DEPOIS OS OBJETOS EM SEQUENCIA
+	uint16_t table_end = ID_BLOCK_SIZE + config->obj_count * OBJECT_ENTRY_SIZE;
+	uint16_t addr = table_end + 3;
+	uint8_t report_id = 1;
+
+	for (uint8_t i = 0; i < config->obj_count; i++){
+		const mxt_sim_object *o = &config->objects[i];
+		uint8_t *e = &mem[ID_BLOCK_SIZE + i * OBJECT_ENTRY_SIZE];
+
+		e[0] = o->type;
+		e[1] = addr & 0xff;
+		e[2] = addr >> 8;
+		e[3] = o->size - 1;
+		e[4] = 0;
+		e[5] = o->report_ids;
+
+		if (o->type == MXT_GEN_MESSAGEPROCESSOR_T5){
+			t5_addr = addr;
+		} else if (o->type == MXT_GEN_COMMANDPROCESSOR_T6){
+			t6_addr = addr;
+			t6_report_id = report_id;
+		} else if (o->type == MXT_TOUCH_MULTITOUCHSCREEN_T9){
+			t9_report_id = report_id;
+		} else if (o->type == MXT_SPT_MESSAGECOUNT_T44){
+			t44_addr = addr;
+		}
+		report_id += o->report_ids;
+		addr += o->size;
+	}
+
+	uint32_t crc = info_crc(table_end);
+	mem[table_end] = crc & 0xff;
+	mem[table_end + 1] = (crc >> 8) & 0xff;
+	mem[table_end + 2] = (crc >> 16) & 0xff;
+
+	update_chg();
+	return 1;
+}
+
+//###############################################################################################################
+//TWIHS
+
+uint32_t twihs_master_read(Twihs *p_twihs, twihs_packet_t *p_packet){
+	uint16_t addr = p_packet->addr[0] | ((p_packet->addr[1] & 0x7f) << 8);
+	uint8_t *buf = p_packet->buffer;
+
+	stats.twi_reads++;
+	stats.bytes_read += p_packet->length;
+
+	if (addr == t5_addr && t5_addr != 0){
+		uint8_t msg[T5_READ_SIZE];
+		pop_message(msg);
+		memcpy(buf, msg, p_packet->length < T5_READ_SIZE ? p_packet->length : T5_READ_SIZE);
+		return TWIHS_SUCCESS;
+	}
+	if (addr + p_packet->length > MXT_SIM_MEM_SIZE){
+		return TWIHS_ERROR_TIMEOUT;
+	}
+	memcpy(buf, &mem[addr], p_packet->length);
+	return TWIHS_SUCCESS;
+}
+
+uint32_t twihs_master_write(Twihs *p_twihs, twihs_packet_t *p_packet){
+	uint16_t addr = p_packet->addr[0] | (p_packet->addr[1] << 8);
+	const uint8_t *buf = p_packet->buffer;
+
+	stats.twi_writes++;
+	if (addr + p_packet->length > MXT_SIM_MEM_SIZE){
+		return TWIHS_ERROR_TIMEOUT;
+	}
+	memcpy(&mem[addr], buf, p_packet->length);
+
+	//COMANDOS DO T6: RESET LIMPA A FILA, AMBOS RESPONDEM COM MENSAGEM DE STATUS
+	if (t6_addr && addr <= t6_addr + MXT_GEN_COMMANDPROCESSOR_CALIBRATE
+			&& addr + p_packet->length > t6_addr){
+		uint8_t status = 0;
+
+		if (mem[t6_addr + MXT_GEN_COMMANDPROCESSOR_RESET]){
+			q_head = q_tail = q_count = 0;
+			mem[t6_addr + MXT_GEN_COMMANDPROCESSOR_RESET] = 0;
+			status = 0x80;
+		}
+		if (mem[t6_addr + MXT_GEN_COMMANDPROCESSOR_CALIBRATE]){
+			mem[t6_addr + MXT_GEN_COMMANDPROCESSOR_CALIBRATE] = 0;
+			status |= 0x10;
+		}
+		if (status){
+			push_message(t6_report_id, &status, 1);
+		}
+	}
+	return TWIHS_SUCCESS;
+}
+
+//###############################################################################################################
+//REPRODUCAO
+
+void mxt_sim_push_touch(uint8_t id, uint8_t status, uint16_t x, uint16_t y){
+	uint8_t msg[MXT_MAX_MSG_SIZE] = {
+		status,
+		x >> 4,
+		y >> 4,
+		((x & 0x0f) << 4) | (y & 0x0f),
+		1,
+		0x20,
+		0
+	};
+	push_message(t9_report_id + id, msg, sizeof(msg));
+}
+
+void mxt_sim_play(const mxt_sim_touch *s, uint32_t size){
+	script = s;
+	script_size = size;
+	script_pos = 0;
+}
+
+//TRACE EM TEXTO: "t_us id status x y" POR LINHA, '#' COMENTA
+int mxt_sim_load_trace(const char *path){
+	FILE *f = fopen(path, "r");
+	char line[80];
+	uint32_t n = 0;
+
+	if (f == NULL){
+		return -1;
+	}
+	while (n < TRACE_MAX && fgets(line, sizeof(line), f)){
+		unsigned long long t;
+		unsigned id, status, x, y;
+
+		if (line[0] == '#'){
+			continue;
+		}
+		if (sscanf(line, "%llu %u %u %u %u", &t, &id, &status, &x, &y) == 5){
+			trace[n].t_us = now_us + t;
+			trace[n].id = id;
+			trace[n].status = status;
+			trace[n].x = x;
+			trace[n].y = y;
+			n++;
+		}
+	}
+	fclose(f);
+	mxt_sim_play(trace, n);
+	return n;
+}
+
+//AVANCA O TEMPO VIRTUAL E ENTREGA OS EVENTOS COM t_us <= AGORA
+void mxt_sim_advance(uint64_t us){
+	now_us += us;
+	while (script && script_pos < script_size && script[script_pos].t_us <= now_us){
+		const mxt_sim_touch *t = &script[script_pos++];
+		mxt_sim_push_touch(t->id, t->status, t->x, t->y);
+	}
+}
+
+uint64_t mxt_sim_now(void){
+	return now_us;
+}
+
+int mxt_sim_done(void){
+	return script_pos >= script_size && q_count == 0;
+}
+
+const mxt_sim_stats *mxt_sim_get_stats(void){
+	return &stats;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,72 @@
+/*
+ * mxt_sim.h
+ *
+ * Modelo do maXTouch para o host (HOST_BUILD). Implementa
+ * twihs_master_read()/twihs_master_write() sobre um mapa de memoria com
+ * info block, tabela de objetos (T5, T6, T7, T8, T9, T44, ...) e CRC, e
+ * controla uma linha CHG virtual. Assim mxt_init_device(),
+ * mxt_read_touch_event() e o caminho de toque (touch.c) rodam sem mudanca
+ * no Linux, alimentados por sequencias T9 gravadas ou scriptadas
+ * (sim/touch_sim.c).
+ */
+
+
+#ifndef MXT_SIM_H_
+#define MXT_SIM_H_
+
+#ifdef HOST_BUILD
+
+#include <stdint.h>
+
+#define MXT_SIM_MAX_OBJECTS  16
+#define MXT_SIM_MEM_SIZE     1024
+#define MXT_SIM_QUEUE_SIZE   64
+
+typedef struct {
+	uint8_t type;
+	uint8_t size;        // bytes do objeto
+	uint8_t report_ids;  // report IDs por instancia
+} mxt_sim_object;
+
+typedef struct {
+	uint8_t family_id;
+	uint8_t variant_id;
+	uint8_t version;
+	uint8_t build;
+	uint8_t matrix_x;
+	uint8_t matrix_y;
+	uint8_t obj_count;
+	mxt_sim_object objects[MXT_SIM_MAX_OBJECTS];
+} mxt_sim_config;
+
+//UM EVENTO T9 NO TEMPO (us desde o inicio da reproducao)
+typedef struct {
+	uint64_t t_us;
+	uint8_t id;
+	uint8_t status;
+	uint16_t x;   // coordenadas cruas, 12 bits
+	uint16_t y;
+} mxt_sim_touch;
+
+typedef struct {
+	uint32_t twi_reads;
+	uint32_t twi_writes;
+	uint32_t bytes_read;
+	uint32_t messages_sent;
+	uint32_t messages_dropped;
+} mxt_sim_stats;
+
+extern const mxt_sim_config mxt_sim_default_config;
+
+int mxt_sim_init(const mxt_sim_config *config, uint32_t chgpin);
+void mxt_sim_play(const mxt_sim_touch *script, uint32_t size);
+int mxt_sim_load_trace(const char *path);
+void mxt_sim_advance(uint64_t us);
+uint64_t mxt_sim_now(void);
+int mxt_sim_done(void);
+void mxt_sim_push_touch(uint8_t id, uint8_t status, uint16_t x, uint16_t y);
+const mxt_sim_stats *mxt_sim_get_stats(void);
+
+#endif /* HOST_BUILD */
+
+#endif /* MXT_SIM_H_ */
@@ -0,0 +1,113 @@
+/*
+ * prof_sim.c
+ *
+ * Confere o prof.c no host (relogio do clock_gettime): zonas aninhadas em
+ * tres niveis com tempos conhecidos, o "proprio" de cada uma contra o total
+ * das filhas, PROF_END trocado, pilha mais funda que PROF_DEPTH, e mede o
+ * custo de um par PROF_BEGIN/PROF_END. Compilado com -DPROF_ENABLE=0 so
+ * confere que as macros somem.
+ *
+ *   gcc -O2 -DHOST_BUILD -I. sim/prof_sim.c prof.c -o prof_sim && ./prof_sim
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <time.h>
+#include "prof.h"
+#include "check.h"
+
+static uint64_t now_ns(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+//ESPERA OCUPADA, COMO UM TRECHO DE DESENHO
+static void spin_us(uint32_t us){
+	uint64_t end = now_ns() + us * 1000ull;
+	while (now_ns() < end){
+	}
+}
+
+//UMA "TELA": 4 TEXTOS DE 5 LETRAS, CADA LETRA UM PIXMAP DE 20 us
+static void draw(void){
+	PROF_BEGIN(DRAW_DISPLAY);
+	spin_us(50);
+	for (int t = 0; t < 4; t++){
+		PROF_BEGIN(FONT_TEXT);
+		for (int c = 0; c < 5; c++){
+			PROF_BEGIN(PIXMAP);
+			spin_us(20);
+			PROF_END(PIXMAP);
+		}
+		PROF_END(FONT_TEXT);
+	}
+	PROF_END(DRAW_DISPLAY);
+}
+
+int main(void){
+	prof_stats d;
+
+	prof_init(0);
+#if PROF_ENABLE
+	prof_stats f, p;
+
+	for (int i = 0; i < 100; i++){
+		draw();
+	}
+	prof_get_stats(PROF_DRAW_DISPLAY, &d);
+	prof_get_stats(PROF_FONT_TEXT, &f);
+	prof_get_stats(PROF_PIXMAP, &p);
+	prof_dump();
+
+	check(d.count == 100 && f.count == 400 && p.count == 2000, "contagens");
+	check(p.min >= 20000 && p.min <= p.total / p.count && p.total / p.count <= p.max, "min <= media <= max");
+	check(p.self == p.total, "folha: proprio == total");
+	check(f.self == f.total - p.total, "texto: proprio = total - pixmaps");
+	check(d.self == d.total - f.total, "tela: proprio = total - textos");
+	check(d.self / d.count >= 50000, "tela: proprio >= 50 us");
+	//O HOST PODE TIRAR A CPU NO MEIO DE UMA MEDIDA: SO A MAIORIA NO BALDE CERTO
+	check(p.hist[4] + p.hist[5] >= p.count * 95 / 100, "pixmap de 20 us no balde 16..63 us");
+
+	//PROF_END TROCADO: DESCARTA A PILHA, CONTA O ERRO E SEGUE MEDINDO
+	prof_reset();
+	PROF_BEGIN(DRAW_DISPLAY);
+	PROF_BEGIN(FONT_TEXT);
+	PROF_END(DRAW_DISPLAY);
+	PROF_END(FONT_TEXT);
+	draw();
+	prof_get_stats(PROF_DRAW_DISPLAY, &d);
+	check(prof.errors == 2 && prof.depth == 0 && d.count == 1, "PROF_END trocado");
+
+	//MAIS FUNDO QUE PROF_DEPTH: SO OS NIVEIS DE DENTRO DO LIMITE CONTAM
+	prof_reset();
+	for (int i = 0; i < PROF_DEPTH + 3; i++){
+		PROF_BEGIN(PIXMAP);
+	}
+	for (int i = 0; i < PROF_DEPTH + 3; i++){
+		PROF_END(PIXMAP);
+	}
+	prof_get_stats(PROF_PIXMAP, &p);
+	check(p.count == PROF_DEPTH && prof.errors == 0 && prof.depth == 0, "pilha alem de PROF_DEPTH");
+
+	//CUSTO DE UM PAR VAZIO (NO HOST E O clock_gettime QUE DOMINA)
+	prof_reset();
+	uint64_t t0 = now_ns();
+	for (int i = 0; i < 1000000; i++){
+		PROF_BEGIN(DISPATCH);
+		PROF_END(DISPATCH);
+	}
+	printf("  par BEGIN/END: %.1f ns\n", (now_ns() - t0) / 1e6);
+#else
+	draw();
+	prof_get_stats(PROF_DRAW_DISPLAY, &d);
+	prof_dump();
+	check(d.count == 0, "PROF_ENABLE 0: nada medido");
+#endif
+
+	printf("%s: %d erro(s)\n", errors ? "FALHOU" : "OK", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
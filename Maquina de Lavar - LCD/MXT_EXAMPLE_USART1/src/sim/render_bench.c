@@ -0,0 +1,257 @@
+/*
+ * render_bench.c
+ *
+ * Mede cada tela real no host: screens.c, widget.c e o driver do ILI9488
+ * do ASF, sem mudanca, sobre o SPI simulado (sim/lcd_spi_sim.c). As cenas
+ * seguem em sequencia, como no firmware: cada uma custa so o que a arvore
+ * redesenha naquela transicao. A tabela sai com pixels,
+ * bytes no SPI, janelas (CASET), escritas na GRAM (RAMWR) e o tempo que
+ * os bytes levam no fio a ILI9488_SPI_BAUDRATE.
+ *
+ * Com um baseline (sim/render_baseline.txt), falha se alguma metrica de
+ * alguma cena crescer mais que a tolerancia (% , padrao 5). --write grava
+ * a tabela atual como o novo baseline.
+ *
+ *   ASF=$(sed -n 's|.*<Value>\.\./src/\(ASF[^<]*\)</Value>|-I./\1|p' ../MXT_EXAMPLE_USART1.cproj)
+ *   gcc -DHOST_BUILD -D__SAME70Q21B__ -DBOARD=SAME70_XPLAINED -DILI9488_SPIMODE -I. -I./config $ASF \
+ *       sim/render_bench.c sim/lcd_spi_sim.c screens.c widget.c frame_sched.c cycle_table.c wash_program.c prof.c \
+ *       latency.c ASF/sam/components/display/ili9488/ili9488.c -o render_bench
+ *   ./render_bench sim/render_baseline.txt 5
+ */
+
+#ifdef HOST_BUILD
+
+#include <asf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "screens.h"
+#include "cycle_table.h"
+#include "wash_flow.h"
+#include "lcd_spi_sim.h"
+
+#define SCENES_MAX       16
+#define NAME_MAX         32
+#define TOLERANCE_PCT    5
+
+enum {
+	M_PIXELS,
+	M_BYTES,
+	M_WINDOWS,
+	M_DRAWS,
+	M_WIRE_US,
+	METRICS
+};
+static const char *const metric_names[METRICS] = {"pixels", "bytes", "janelas", "desenhos", "fio_us"};
+
+typedef struct {
+	char name[NAME_MAX];
+	uint32_t m[METRICS];
+} scene_result;
+
+struct ili9488_opt_t g_ili9488_display_opt;
+
+static scene_result results[SCENES_MAX];
+static int result_count;
+
+static uint8_t button_state[BUTTONS_SIZE];
+static ui_view view = {.button_state = button_state};
+
+static void scene_begin(void){
+	lcd_sim_reset();
+}
+
+static void scene_end(const char *name){
+	lcd_sim_stats s;
+	scene_result *r = &results[result_count++];
+
+	lcd_sim_get_stats(&s);
+	snprintf(r->name, sizeof(r->name), "%s", name);
+	r->m[M_PIXELS] = s.pixels;
+	r->m[M_BYTES] = s.bytes;
+	r->m[M_WINDOWS] = s.windows;
+	r->m[M_DRAWS] = s.draws;
+	r->m[M_WIRE_US] = lcd_sim_wire_us(s.bytes, ILI9488_SPI_BAUDRATE);
+}
+
+//MESMO QUE O select_wash_mode() DO main.c
+static void select_mode(uint8_t mode){
+	for (int i = BUT_FIRST_CICLE; i < BUTTONS_SIZE; i++){
+		button_state[i] = CLICKED;
+	}
+	if (mode < CICLE_BUTTONS){
+		button_state[BUT_FIRST_CICLE + mode] = RELEASED;
+	}
+	view.mode = mode;
+}
+
+//AS TELAS, NA ORDEM EM QUE APARECEM NUM USO NORMAL
+static void run_scenes(void){
+	char name[NAME_MAX];
+
+	for (int i = 0; i < BUTTONS_SIZE; i++){
+		button_state[i] = CLICKED;
+	}
+
+	//BOOT: LOGO LOGO DEPOIS DO configure_lcd()
+	scene_begin();
+	draw_splash();
+	scene_end("boot");
+
+	//PRIMEIRO QUADRO: BLOQUEADA, PARADA, A ARVORE INTEIRA
+	screens_init();
+	view.locked = 1;
+	view.wash_state = WASH_FLOW_IDLE;
+	scene_begin();
+	draw_display(&view);
+	scene_end("bloqueada");
+
+	//DESBLOQUEIA (callback_lock) E PASSA POR CADA CICLO
+	view.locked = 0;
+	button_state[BUT_LOCK] = RELEASED;
+	for (uint8_t k = 0; k < CYCLE_COUNT; k++){
+		select_mode(k);
+		scene_begin();
+		draw_display(&view);
+		snprintf(name, sizeof(name), "menu_%.24s", cycle_table[k].ciclo.nome);
+		scene_end(name);
+	}
+
+	//START COM A PORTA ABERTA: AVISO NO LUGAR DOS TEXTOS DO CICLO
+	select_mode(0);
+	button_state[BUT_START] = RELEASED;
+	view.door_msg = 1;
+	scene_begin();
+	draw_display(&view);
+	scene_end("fechar_porta");
+	button_state[BUT_START] = CLICKED;
+	view.door_msg = 0;
+
+	//START COM A PORTA FECHADA (callback_start) E O PRIMEIRO QUADRO LAVANDO
+	const cycle_entry *e = &cycle_table[view.mode];
+	view.locked = 1;
+	view.wash_state = WASH_FLOW_WASHING;
+	view.phase = e->program.phases[0].type;
+	view.seconds_left = e->total_ms / 1000;
+	button_state[BUT_LOCK] = CLICKED;
+	scene_begin();
+	draw_display(&view);
+	scene_end("lavando");
+
+	//UM SEGUNDO DA CONTAGEM
+	view.seconds_left--;
+	scene_begin();
+	draw_display(&view);
+	scene_end("contagem");
+
+	view.wash_state = WASH_FLOW_FINISHED;
+	scene_begin();
+	draw_display(&view);
+	scene_end("terminou");
+}
+
+static void print_results(FILE *f){
+	fprintf(f, "# cena");
+	for (int m = 0; m < METRICS; m++){
+		fprintf(f, " %s", metric_names[m]);
+	}
+	fprintf(f, "\n");
+	for (int i = 0; i < result_count; i++){
+		fprintf(f, "%-16s", results[i].name);
+		for (int m = 0; m < METRICS; m++){
+			fprintf(f, " %8u", results[i].m[m]);
+		}
+		fprintf(f, "\n");
+	}
+}
+
+static const scene_result *find_result(const char *name){
+	for (int i = 0; i < result_count; i++){
+		if (strcmp(results[i].name, name) == 0){
+			return &results[i];
+		}
+	}
+	return NULL;
+}
+
+//COMPARA COM O BASELINE; CENA NOVA OU QUE SUMIU SO AVISA
+static int compare(const char *path, uint32_t tolerance){
+	FILE *f = fopen(path, "r");
+	char line[160];
+	int regressions = 0, seen = 0;
+
+	if (f == NULL){
+		printf("baseline %s nao abriu\n", path);
+		return 1;
+	}
+	while (fgets(line, sizeof(line), f)){
+		scene_result b;
+		if (line[0] == '#' || sscanf(line, "%31s %u %u %u %u %u", b.name, &b.m[0], &b.m[1], &b.m[2],
+				&b.m[3], &b.m[4]) != 1 + METRICS){
+			continue;
+		}
+		const scene_result *r = find_result(b.name);
+		if (r == NULL){
+			printf("  %s: nao existe mais\n", b.name);
+			continue;
+		}
+		seen++;
+		for (int m = 0; m < METRICS; m++){
+			uint64_t limit = (uint64_t)b.m[m] * (100 + tolerance) / 100;
+			if (r->m[m] > limit){
+				printf("  REGRESSAO %s %s: %u -> %u (+%.1f%%)\n", b.name, metric_names[m], b.m[m], r->m[m],
+						b.m[m] ? 100.0 * (r->m[m] - b.m[m]) / b.m[m] : 100.0);
+				regressions++;
+			} else if (r->m[m] < b.m[m]){
+				printf("  melhorou %s %s: %u -> %u\n", b.name, metric_names[m], b.m[m], r->m[m]);
+			}
+		}
+	}
+	fclose(f);
+	if (seen < result_count){
+		printf("  %d cena(s) sem baseline\n", result_count - seen);
+	}
+	return regressions;
+}
+
+int main(int argc, char **argv){
+	const char *baseline = argc > 1 ? argv[1] : NULL;
+	uint32_t tolerance = argc > 2 ? (uint32_t)atoi(argv[2]) : TOLERANCE_PCT;
+	int write = argc > 3 && strcmp(argv[3], "--write") == 0;
+
+	if (!lcd_sim_init()){
+		printf("nao mapeou o SPI0\n");
+		return 1;
+	}
+	g_ili9488_display_opt.ul_width = ILI9488_LCD_WIDTH;
+	g_ili9488_display_opt.ul_height = ILI9488_LCD_HEIGHT;
+	g_ili9488_display_opt.foreground_color = COLOR_CONVERT(COLOR_WHITE);
+	g_ili9488_display_opt.background_color = COLOR_CONVERT(COLOR_WHITE);
+	if (ili9488_init(&g_ili9488_display_opt) != 0){
+		printf("ili9488_init falhou\n");
+		return 1;
+	}
+
+	run_scenes();
+	print_results(stdout);
+
+	if (baseline == NULL){
+		return 0;
+	}
+	if (write){
+		FILE *f = fopen(baseline, "w");
+		if (f == NULL){
+			printf("baseline %s nao abriu\n", baseline);
+			return 1;
+		}
+		print_results(f);
+		fclose(f);
+		printf("baseline gravado em %s\n", baseline);
+		return 0;
+	}
+	int regressions = compare(baseline, tolerance);
+	printf("%s: %d regressao(oes) acima de %u%%\n", regressions ? "FALHOU" : "OK", regressions, tolerance);
+	return regressions != 0;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,223 @@
+/*
+ * telem_decode.c
+ *
+ * Decodificador da telemetria (telemetry.h), no host: separa a captura da
+ * serial nos 0x00, desfaz o COBS, confere o CRC-32 e a sequencia dos
+ * quadros e imprime um registro por linha em CSV:
+ *
+ *   t_ms,tipo,a,b,c,d
+ *
+ * O t_ms e a base do quadro mais o dt do registro. Os registros de log
+ * (TELEM_LOG) saem com o texto do tlog_msgs.def na coluna a, entre aspas.
+ * Pedacos que nao fecham um quadro valido e sao texto (printf) vao para o
+ * stderr com "> " na frente; o resumo tambem. Os estouros de quadro
+ * (TELEM_OVERRUN) trazem o nome da chamada do draw_calls.def na coluna c.
+ *
+ *   gcc -DHOST_BUILD -I. sim/telem_decode.c cobs.c crc32.c -o telem_decode
+ *   ./telem_decode captura.bin > telemetria.csv
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "telemetry.h"
+#include "cobs.h"
+#include "crc32.h"
+#include "tlog.h"
+
+static const char *const type_names[TELEM_TYPES] = {
+	[TELEM_TOUCH] = "toque",
+	[TELEM_FRAME] = "render_us",
+	[TELEM_BUS]   = "spi_bytes",
+	[TELEM_PHASE] = "fase",
+	[TELEM_QUEUE] = "fila",
+	[TELEM_LOG]   = "log",
+	[TELEM_OVERRUN] = "estouro",
+};
+
+static const char *formats[TLOG_COUNT] = {
+#define TLOG_MSG(id, fmt) fmt,
+#include "tlog_msgs.def"
+#undef TLOG_MSG
+};
+
+static const char *const call_names[] = {
+#define DRAW_CALL(id, name) name,
+#include "draw_calls.def"
+#undef DRAW_CALL
+};
+#define CALL_NAMES (sizeof(call_names) / sizeof(call_names[0]))
+
+static unsigned long frames, records, bad, lost;
+
+static uint16_t le16(const uint8_t *p){
+	return p[0] | (p[1] << 8);
+}
+
+static uint32_t le32(const uint8_t *p){
+	return le16(p) | ((uint32_t)le16(p + 2) << 16);
+}
+
+//TAMANHO DOS CAMPOS DO REGISTRO, SEM O CABECALHO; -1 SE O TIPO E DESCONHECIDO
+static int body_len(const uint8_t *rec, uint16_t left){
+	switch (rec[0]){
+		case TELEM_TOUCH: return 6;
+		case TELEM_FRAME: return 4;
+		case TELEM_BUS:   return 4;
+		case TELEM_PHASE: return 5;
+		case TELEM_QUEUE: return 7;
+		case TELEM_OVERRUN: return 13;
+		case TELEM_LOG:   return left > TELEM_REC_HEADER ? 1 + rec[TELEM_REC_HEADER] : -1;
+		default:          return -1;
+	}
+}
+
+//UM OU MAIS REGISTROS DO tlog, FORMATADOS COMO O sim/tlog_decode.c
+static void print_log(uint32_t t, const uint8_t *p, uint8_t len){
+	while (len >= 8){
+		uint32_t hdr = le32(p);
+		uint16_t id = hdr & 0xFFFF;
+		uint8_t n = (hdr >> 16) & 0xFF;
+		uint32_t a[TLOG_MAX_ARGS] = {0};
+		char text[160];
+
+		if ((hdr >> 24) != TLOG_MAGIC || id >= TLOG_COUNT || n > TLOG_MAX_ARGS || len < (2 + n) * 4u){
+			break;
+		}
+		for (uint8_t k = 0; k < n; k++){
+			a[k] = le32(p + 8 + 4 * k);
+		}
+		snprintf(text, sizeof(text), formats[id], a[0], a[1], a[2], a[3]);
+		for (char *c = text; *c; c++){
+			if (*c == '"' || !isprint((unsigned char)*c)){
+				*c = ' ';
+			}
+		}
+		printf("%lu,log,\"%s\",%lu,,\n", (unsigned long)t, text, (unsigned long)le32(p + 4));
+		records++;
+		p += (2 + n) * 4u;
+		len -= (2 + n) * 4u;
+	}
+}
+
+static void print_record(uint32_t t, const uint8_t *r){
+	const uint8_t *p = r + TELEM_REC_HEADER;
+
+	switch (r[0]){
+		case TELEM_TOUCH:
+			printf("%lu,%s,%u,%u,%u,%u\n", (unsigned long)t, type_names[r[0]], p[0], p[1], le16(p + 2), le16(p + 4));
+			break;
+		case TELEM_FRAME:
+		case TELEM_BUS:
+			printf("%lu,%s,%lu,,,\n", (unsigned long)t, type_names[r[0]], (unsigned long)le32(p));
+			break;
+		case TELEM_PHASE:
+			printf("%lu,%s,%u,%u,%u,%u\n", (unsigned long)t, type_names[r[0]], p[0], p[1], p[2], le16(p + 3));
+			break;
+		case TELEM_QUEUE:
+			printf("%lu,%s,%u,%u,%u,%lu\n", (unsigned long)t, type_names[r[0]], p[0], p[1], p[2],
+					(unsigned long)le32(p + 3));
+			break;
+		case TELEM_OVERRUN:
+			printf("%lu,%s,%lu,%lu,\"%s\",%lu\n", (unsigned long)t, type_names[r[0]], (unsigned long)le32(p),
+					(unsigned long)le32(p + 4), p[8] < CALL_NAMES ? call_names[p[8]] : "-", (unsigned long)le32(p + 9));
+			break;
+		case TELEM_LOG:
+			print_log(t, p + 1, p[0]);
+			return;
+	}
+	records++;
+}
+
+//UM QUADRO JA SEM COBS; false SE O CRC OU A ESTRUTURA NAO FECHAM
+static bool frame(const uint8_t *f, int32_t len){
+	static int last_seq = -1;
+	uint16_t i;
+
+	if (len < 9 || len > 5 + TELEM_PAYLOAD_MAX + 4 || le32(f + len - 4) != crc32(f, len - 4)){
+		return false;
+	}
+	len -= 4;
+	for (i = 5; i < len; ){
+		int body = body_len(f + i, len - i);
+		if (body < 0 || i + TELEM_REC_HEADER + body > len){
+			return false;
+		}
+		i += TELEM_REC_HEADER + body;
+	}
+
+	if (last_seq >= 0){
+		lost += (uint8_t)(f[0] - last_seq - 1);
+	}
+	last_seq = f[0];
+	frames++;
+	for (i = 5; i < len; ){
+		print_record(le32(f + 1) + le16(f + i + 1), f + i);
+		i += TELEM_REC_HEADER + body_len(f + i, len - i);
+	}
+	return true;
+}
+
+//PEDACO INVALIDO: SE PARECE TEXTO, MOSTRA
+static void junk(const uint8_t *p, size_t len){
+	size_t printable = 0;
+
+	for (size_t k = 0; k < len; k++){
+		printable += isprint(p[k]) || p[k] == '\n' || p[k] == '\r';
+	}
+	if (len && printable == len){
+		bool open = false;
+
+		for (size_t k = 0; k < len; k++){
+			if (isprint(p[k])){
+				fputs(open ? "" : "> ", stderr);
+				fputc(p[k], stderr);
+				open = true;
+			}
+			else if (open){
+				fputc('\n', stderr);
+				open = false;
+			}
+		}
+		if (open){
+			fputc('\n', stderr);
+		}
+	}
+	else if (len){
+		bad++;
+	}
+}
+
+int main(int argc, char **argv){
+	FILE *f = argc > 1 && strcmp(argv[1], "-") != 0 ? fopen(argv[1], "rb") : stdin;
+	static uint8_t data[1 << 22];
+	static uint8_t raw[COBS_MAX(sizeof(data))];
+	size_t len, start = 0;
+
+	if (!f){
+		perror(argv[1]);
+		return 1;
+	}
+	len = fread(data, 1, sizeof(data), f);
+
+	printf("t_ms,tipo,a,b,c,d\n");
+	for (size_t i = 0; i <= len; i++){
+		if (i < len && data[i] != 0){
+			continue;
+		}
+		if (i > start){
+			int32_t n = i - start <= 0xFFFF ? cobs_decode(data + start, i - start, raw) : -1;
+			if (n < 0 || !frame(raw, n)){
+				junk(data + start, i - start);
+			}
+		}
+		start = i + 1;
+	}
+	fprintf(stderr, "%lu quadros, %lu registros, %lu quadros invalidos, %lu perdidos (seq)\n",
+			frames, records, bad, lost);
+	return 0;
+}
+
+#endif /* HOST_BUILD */
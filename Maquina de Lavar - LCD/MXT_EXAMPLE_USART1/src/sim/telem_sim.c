@@ -0,0 +1,179 @@
+/*
+ * telem_sim.c
+ *
+ * Vazao da telemetria no host: o anel da serial (tx_ring, SERIAL_TX_SIZE)
+ * e esvaziado no ritmo de 115200 baud e o "main" gera registros de todos
+ * os tipos, com telem_flush() a cada ms. Mede quantos registros/s chegam
+ * na linha com a taxa de entrada subindo, confere que a captura decodifica
+ * (COBS, CRC, sequencia) com os mesmos registros e grava telem_sim.bin
+ * para o sim/telem_decode.c, com um pouco de texto de printf no meio.
+ *
+ *   gcc -DHOST_BUILD -I. sim/telem_sim.c telemetry.c cobs.c crc32.c tx_ring.c -o telem_sim
+ *   ./telem_sim && ./telem_decode telem_sim.bin > telem_sim.csv
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include "telemetry.h"
+#include "cobs.h"
+#include "crc32.h"
+#include "tx_ring.h"
+#include "serial_tx.h"
+#include "check.h"
+
+#define BAUD_BYTES_S  11520u   // 115200 baud, 10 bits por byte
+#define RUN_MS        10000u
+
+TX_RING_DEFINE(line, SERIAL_TX_SIZE, TX_DROP_NEWEST);
+
+static uint32_t now;
+static uint8_t capture[RUN_MS * BAUD_BYTES_S / 1000 + 4096];
+static uint32_t captured;
+
+static uint32_t sim_now(void){ return now; }
+static uint16_t sim_room(void){ return tx_ring_free(&line); }
+static uint16_t sim_write(const void *data, uint16_t len){ return tx_ring_write(&line, data, len, NULL); }
+
+//A USART: BAUD_BYTES_S POR SEGUNDO, COM A FRACAO ACUMULADA
+static void line_run_ms(void){
+	static uint32_t credit;
+	uint8_t c;
+
+	credit += BAUD_BYTES_S;
+	while (credit >= 1000 && tx_ring_pop(&line, &c)){
+		credit -= 1000;
+		capture[captured++] = c;
+	}
+	if (tx_ring_empty(&line)){
+		credit = 0;
+	}
+}
+
+//MISTURA DO FIRMWARE: MAIS TOQUES, UM QUADRO DE TELA E SEUS BYTES, FILA,
+//FASE, UM REGISTRO CURTO DO tlog E DE VEZ EM QUANDO UM ESTOURO DE QUADRO
+static void emit(uint32_t k){
+	static const uint8_t log[8] = {0x00, 0, 0x00, 0xA5, 0x10, 0x20, 0x30, 0x40};
+
+	switch (k % 8){
+		case 0: case 1: case 2:
+			telem_touch(k & 0xF, 0x90, k % 480, k % 320); break;
+		case 3: telem_frame(2000 + k % 5000); break;
+		case 4:
+			if (k % 64 == 4){
+				telem_overrun(180000 + k % 5000, 150000, k % 7, 90000);
+			} else {
+				telem_bus(460800);
+			}
+			break;
+		case 5: telem_queue(k % 3, 1, 4, 0); break;
+		case 6: telem_phase(k % 7, k % 5, 0, k % 3600); break;
+		case 7: telem_log(log, sizeof(log)); break;
+	}
+}
+
+//rate REGISTROS/s POR RUN_MS; DEVOLVE OS REGISTROS/s QUE CHEGARAM (O ANEL
+//COMECA VAZIO: A RODADA ANTERIOR TERMINA ESVAZIANDO)
+static uint32_t run(uint32_t rate, telem_stats *st){
+	uint32_t k = 0;
+
+	telem_init(sim_now, sim_room, sim_write);
+	captured = 0;
+	for (now = 0; now < RUN_MS; now++){
+		while (k < (uint64_t)rate * (now + 1) / 1000){
+			emit(k++);
+		}
+		telem_flush();
+		line_run_ms();
+	}
+	//ESVAZIA O QUE SOBROU, SEM GERAR MAIS
+	for (uint32_t end = now + 1000; now < end; now++){
+		telem_flush();
+		line_run_ms();
+	}
+	telem_get_stats(st);
+	return (uint64_t)st->records * 1000 / RUN_MS;
+}
+
+//CONFERE A CAPTURA: QUADROS VALIDOS, SEQUENCIA SEM BURACO, REGISTROS
+static uint32_t verify(uint32_t *frames){
+	static uint8_t raw[COBS_MAX(TELEM_PAYLOAD_MAX + 16)];
+	uint32_t start = 0, records = 0;
+	int seq = -1;
+
+	*frames = 0;
+	for (uint32_t i = 0; i < captured; i++){
+		if (capture[i] != 0){
+			continue;
+		}
+		if (i > start){
+			int32_t n = i - start <= sizeof(raw) ? cobs_decode(capture + start, i - start, raw) : -1;
+			uint32_t crc = n >= 9 ? raw[n - 4] | raw[n - 3] << 8 | raw[n - 2] << 16 | (uint32_t)raw[n - 1] << 24 : 0;
+
+			if (n < 9 || crc != crc32(raw, n - 4) || (seq >= 0 && raw[0] != (uint8_t)(seq + 1))){
+				return 0;
+			}
+			seq = raw[0];
+			(*frames)++;
+			for (int32_t p = 5; p < n - 4; records++){
+				switch (raw[p]){
+					case TELEM_TOUCH: p += 3 + 6; break;
+					case TELEM_FRAME: case TELEM_BUS: p += 3 + 4; break;
+					case TELEM_PHASE: p += 3 + 5; break;
+					case TELEM_QUEUE: p += 3 + 7; break;
+					case TELEM_LOG:   p += 3 + 1 + raw[p + 3]; break;
+					case TELEM_OVERRUN: p += 3 + 13; break;
+					default: return 0;
+				}
+			}
+		}
+		start = i + 1;
+	}
+	return records;
+}
+
+int main(void){
+	static const uint32_t rates[] = {250, 500, 1000, 1500, 2000, 4000};
+	telem_stats st;
+	uint32_t frames;
+	char what[64];
+
+	printf("vazao a 115200 baud, %u ms, flush a cada ms:\n", RUN_MS);
+	printf("  entrada/s  na linha/s  descartados  quadros  bytes/registro\n");
+	for (uint8_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++){
+		uint32_t out = run(rates[i], &st);
+		printf("  %9lu  %10lu  %11lu  %7lu  %14.1f\n", (unsigned long)rates[i], (unsigned long)out,
+				(unsigned long)st.dropped, (unsigned long)st.frames, (double)st.bytes / st.records);
+		snprintf(what, sizeof(what), "%lu/s: captura decodifica", (unsigned long)rates[i]);
+		check(verify(&frames) == st.records && frames == st.frames, what);
+		if (rates[i] <= 1000){
+			snprintf(what, sizeof(what), "%lu/s: nada descartado", (unsigned long)rates[i]);
+			check(st.dropped == 0, what);
+		}
+	}
+	run(4000, &st);
+	check((uint64_t)st.records * 1000 / RUN_MS > 1000, "mais de 1000 registros/s sustentados");
+
+	//CAPTURA PARA O DECODIFICADOR, COM TEXTO DE printf ENTRE OS QUADROS
+	run(1000, &st);
+	FILE *out = fopen("telem_sim.bin", "wb");
+	if (out){
+		const char *text = "\n\rdesbloqueado: carga 12/1000, 40 wakeups em 2000 ms\n\r";
+		uint32_t half = captured / 2;
+
+		//O printf ENTRA NO ANEL ENTRE UM QUADRO E OUTRO, NUNCA NO MEIO
+		while (half < captured && capture[half] != 0){
+			half++;
+		}
+		fwrite(capture, 1, half + 1, out);
+		fwrite(text, 1, strlen(text), out);
+		fwrite(capture + half + 1, 1, captured - half - 1, out);
+		fclose(out);
+	}
+
+	printf("%s: %d erro(s)\n", errors ? "FALHOU" : "OK", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,126 @@
+/*
+ * tlog_decode.c
+ *
+ * Decodificador do log tokenizado (tlog.h), no host. A tabela de textos sai
+ * do mesmo tlog_msgs.def que o firmware compilou, entao e so recompilar
+ * junto. Le a captura da serial (arquivo ou stdin), acha cada registro pelo
+ * cabecalho (marca, id conhecido, numero de argumentos igual ao do
+ * formato) e imprime com o tempo em segundos; bytes fora de registro (o
+ * texto dos printf) saem como estao, com "> " na frente. O contador de
+ * ciclos tem 32 bits e da a volta em ~14 s a 300 MHz: a volta e contada
+ * quando ele diminui, entao um silencio maior que isso desloca o tempo.
+ *
+ *   gcc -DHOST_BUILD -I. sim/tlog_decode.c -o tlog_decode
+ *   ./tlog_decode captura.bin [MHz]    (padrao 300)
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "tlog.h"
+
+static const char *formats[TLOG_COUNT] = {
+#define TLOG_MSG(id, fmt) fmt,
+#include "tlog_msgs.def"
+#undef TLOG_MSG
+};
+
+static uint8_t nargs[TLOG_COUNT];
+
+//CONTA AS CONVERSOES DO FORMATO ("%%" NAO CONTA)
+static uint8_t count_args(const char *f){
+	uint8_t n = 0;
+
+	for (; *f; f++){
+		if (*f == '%'){
+			if (f[1] == '%'){
+				f++;
+			} else {
+				n++;
+			}
+		}
+	}
+	return n;
+}
+
+static uint32_t le32(const uint8_t *p){
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+//TEXTO SOLTO ENTRE REGISTROS, UMA LINHA POR VEZ
+static char text[256];
+static size_t text_len;
+
+static void text_flush(void){
+	if (text_len){
+		text[text_len] = '\0';
+		printf("> %s\n", text);
+		text_len = 0;
+	}
+}
+
+static void text_byte(uint8_t c){
+	if (c == '\n' || c == '\r'){
+		text_flush();
+	}
+	else if (isprint(c) && text_len < sizeof(text) - 1){
+		text[text_len++] = (char)c;
+	}
+}
+
+int main(int argc, char **argv){
+	FILE *f = argc > 1 && strcmp(argv[1], "-") != 0 ? fopen(argv[1], "rb") : stdin;
+	double mhz = argc > 2 ? atof(argv[2]) : 300.0;
+	static uint8_t data[1 << 22];
+	size_t len, i = 0;
+	uint64_t epoch = 0;
+	uint32_t last = 0;
+	unsigned long records = 0, skipped = 0;
+
+	if (!f){
+		perror(argv[1]);
+		return 1;
+	}
+	len = fread(data, 1, sizeof(data), f);
+	for (uint16_t id = 0; id < TLOG_COUNT; id++){
+		nargs[id] = count_args(formats[id]);
+	}
+
+	while (i < len){
+		uint32_t hdr = i + 8 <= len ? le32(data + i) : 0;
+		uint16_t id = hdr & 0xFFFF;
+		uint8_t n = (hdr >> 16) & 0xFF;
+
+		if ((hdr >> 24) != TLOG_MAGIC || id >= TLOG_COUNT || n != nargs[id] || i + (2 + n) * 4u > len){
+			text_byte(data[i]);
+			skipped++;
+			i++;
+			continue;
+		}
+		uint32_t cycles = le32(data + i + 4);
+		uint32_t a[TLOG_MAX_ARGS] = {0};
+
+		for (uint8_t k = 0; k < n; k++){
+			a[k] = le32(data + i + 8 + 4 * k);
+		}
+		if (records && cycles < last){
+			epoch += 1ull << 32;
+		}
+		last = cycles;
+
+		text_flush();
+		printf("%12.6f  ", (double)(epoch + cycles) / (mhz * 1e6));
+		printf(formats[id], a[0], a[1], a[2], a[3]);
+		printf("\n");
+		records++;
+		i += (2 + n) * 4u;
+	}
+	text_flush();
+	fprintf(stderr, "%lu registros, %lu bytes fora de registro\n", records, skipped);
+	return 0;
+}
+
+#endif /* HOST_BUILD */
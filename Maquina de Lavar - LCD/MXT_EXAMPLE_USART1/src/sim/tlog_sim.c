@@ -0,0 +1,92 @@
+/*
+ * tlog_sim.c
+ *
+ * Exercita o tlog.c no host: grava registros de 0 a 4 argumentos com o
+ * contador de ciclos simulado, esvazia em pedacos pequenos (como o main
+ * faz quando o anel da serial tem pouco espaco), mistura texto de printf
+ * na saida e confere registro a registro. Enche o anel para ver o descarte
+ * e grava tlog_sim.bin, para o sim/tlog_decode.c.
+ *
+ *   gcc -DHOST_BUILD -I. sim/tlog_sim.c tlog.c -o tlog_sim && ./tlog_sim
+ *   ./tlog_decode tlog_sim.bin
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include "tlog.h"
+#include "check.h"
+
+#define CPU_MHZ  300u
+
+static uint32_t le32(const uint8_t *p){
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+int main(void){
+	FILE *out = fopen("tlog_sim.bin", "wb");
+	uint8_t buf[40];
+	uint8_t all[16384];
+	size_t all_len = 0;
+	uint16_t n;
+
+	tlog_init();
+
+	//UM CICLO CURTO: BOOT, TOQUES, START, FASES, FIM
+	tlog_sim_cycles = 1000;
+	TLOG1(BOOT, 3);
+	for (uint32_t t = 0; t < 20; t++){
+		tlog_sim_cycles += 3 * CPU_MHZ * 1000;   // 3 ms
+		TLOG4(TOQUE, t & 3, 100 + t, 200 + 2 * t, t == 19 ? 0x20 : 0xC0);
+	}
+	TLOG1(TOQUE_BOTAO, 1);
+	TLOG2(START, 2, 1);
+	for (uint32_t f = 0; f < 5; f++){
+		tlog_sim_cycles += 100u * CPU_MHZ * 1000;   // 100 ms
+		TLOG2(FASE, f, f == 2);
+	}
+	TLOG3(ENTRADA, 0, 2, 3000);
+	TLOG(FIM);
+
+	uint32_t expected = tlog.records;
+	fprintf(out, "texto de printf no meio\r\n");
+	while ((n = tlog_drain(buf, sizeof(buf))) > 0){
+		fwrite(buf, 1, n, out);
+		memcpy(all + all_len, buf, n);
+		all_len += n;
+	}
+	fprintf(out, "outro printf\r\n");
+
+	//CONFERE CADA REGISTRO DO QUE SAIU
+	uint32_t records = 0;
+	int bad = 0;
+	for (size_t i = 0; i < all_len; records++){
+		uint32_t hdr = le32(all + i);
+		uint8_t nargs = (hdr >> 16) & 0xFF;
+
+		bad += (hdr >> 24) != TLOG_MAGIC || (hdr & 0xFFFF) >= TLOG_COUNT || nargs > TLOG_MAX_ARGS;
+		if ((hdr & 0xFFFF) == TLOG_TOQUE){
+			bad += le32(all + i + 12) != 100 + (records - 1);
+		}
+		i += (2 + nargs) * 4u;
+	}
+	check(records == expected && bad == 0, "registros inteiros e na ordem");
+	check(tlog_empty(), "anel vazio depois de esvaziar");
+
+	//ANEL CHEIO: DESCARTA O NOVO, NAO CORROMPE O QUE JA ESTA
+	uint32_t fits = (TLOG_WORDS - 1) / 6;
+	for (uint32_t k = 0; k < fits + 10; k++){
+		TLOG4(TOQUE, 0, k, 0, 0);
+	}
+	check(tlog.dropped == 10, "anel cheio descarta os novos");
+	n = tlog_drain(buf, sizeof(buf));
+	check(n == 24 && le32(buf + 12) == 0, "o mais antigo continua la");
+	while (tlog_drain(buf, sizeof(buf)) > 0){
+	}
+	fclose(out);
+	printf("%d erros\n", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
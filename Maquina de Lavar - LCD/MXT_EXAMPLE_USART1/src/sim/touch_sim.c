@@ -0,0 +1,241 @@
+/*
+ * touch_sim.c
+ *
+ * Caminho do toque inteiro no host: o mxt_device_1.c do ASF conversa com o
+ * modelo do chip (sim/mxt_sim.c), touch.c le a fila, calibra e chama o
+ * gesture.c, e o hit-test e o touch_buttons() sobre a grade montada dos
+ * icones de screens.c. O laco anda 1 ms de tempo virtual por vez: o chip
+ * entrega o que venceu, CHG baixo vira um touch_read() (o EV_TOUCH do main)
+ * e os gestos veem o relogio. Primeiro o trace gravado (destrava e escolhe
+ * o Rapido), depois rajadas de tres dedos em taxas cada vez maiores; cada
+ * uma confere que nenhuma mensagem se perdeu e mede eventos/s na CPU do
+ * host dentro do touch_read().
+ *
+ *   TOUCH_SRCS: sim/touch_sim.c sim/mxt_sim.c sim/clock_sim.c sim/lcd_spi_sim.c touch.c gesture.c touch_calib.c touch_grid.c latency.c prof.c tlog.c telemetry.c cobs.c crc32.c screens.c widget.c frame_sched.c cycle_table.c wash_program.c ASF/common/components/touch/mxt/mxt_device_1.c ASF/sam/components/display/ili9488/ili9488.c
+ *
+ *   ASF=$(sed -n 's|.*<Value>\.\./src/\(ASF[^<]*\)</Value>|-I./\1|p' ../MXT_EXAMPLE_USART1.cproj)
+ *   gcc -DHOST_BUILD -D__SAME70Q21B__ -DBOARD=SAME70_XPLAINED -DILI9488_SPIMODE -I. -I./config $ASF \
+ *       $(sed -n 's/^ \*  *TOUCH_SRCS: //p' sim/touch_sim.c) -o touch_sim
+ *   ./touch_sim sim/traces/destrava_e_rapido.txt
+ */
+
+#ifdef HOST_BUILD
+
+#include <asf.h>
+#include <stdio.h>
+#include <time.h>
+#include "touch.h"
+#include "screens.h"
+#include "cycle_table.h"
+#include "gesture.h"
+#include "latency.h"
+#include "telemetry.h"
+#include "tlog.h"
+#include "prof.h"
+#include "clock_source.h"
+#include "conf_example.h"
+#include "mxt_sim.h"
+#include "check.h"
+
+#define CPU_HZ       300000000u
+#define STEP_US      1000        // um passo do laco, a resolucao do relogio dos gestos
+#define FINGERS      3           // o quarto ID do gesture.c e o do console
+#define BURST_US     1000000
+#define BURST_MAX    50000
+#define HITS_MAX     16
+#define TRACE_PATH   "sim/traces/destrava_e_rapido.txt"
+
+//OS MESMOS DO main.c
+#define LOCK_LONG_PRESS_MS  3000
+#define DRAG_MIN_PX         12
+#define SWIPE_MIN_PX        80
+#define SWIPE_MAX_MS        600
+
+typedef struct {
+	uint8_t type;    // GESTURE_PRESS ou GESTURE_LONG_PRESS
+	int index;       // touch_buttons(), BUTTONS_SIZE + 1 fora de botao
+} button_hit;
+
+struct ili9488_opt_t g_ili9488_display_opt;
+
+static struct mxt_device device;
+static touch_calib panel, map;
+static touch_grid grid;
+static uint8_t locked;
+
+static button_hit hits[HITS_MAX];
+static uint32_t hit_count;
+
+static mxt_sim_touch burst[BURST_MAX];
+static clock_t drain_cpu;        // CPU do host dentro do touch_read()
+
+static uint32_t ms_now(void){
+	return (uint32_t)clock_now_ms();
+}
+
+//TELEMETRIA SEM SERIAL: OS QUADROS SOMEM, OS CONTADORES FICAM
+static uint16_t telem_room(void){
+	return UINT16_MAX;
+}
+
+static uint16_t telem_write(const void *data, uint16_t len){
+	(void)data;
+	return len;
+}
+
+static uint32_t touch_records(void){
+	telem_stats s;
+
+	telem_get_stats(&s);
+	return s.records;
+}
+
+//O gesture_callback DO main SEM AS TELAS: O CADEADO SO NO LONG-PRESS
+static void on_gesture(const gesture_event *ev){
+	if (ev->type != GESTURE_PRESS && ev->type != GESTURE_LONG_PRESS){
+		return;
+	}
+	int index = touch_buttons(&grid, BUTTONS_SIZE, locked, ev->x, ev->y);
+
+	if (hit_count < HITS_MAX){
+		hits[hit_count].type = ev->type;
+		hits[hit_count].index = index;
+	}
+	hit_count++;
+	if (index == BUT_LOCK && ev->type == GESTURE_LONG_PRESS){
+		locked = !locked;
+	}
+}
+
+static void step(void){
+	mxt_sim_advance(STEP_US);
+	clock_sim_advance(STEP_US / 1000);
+	if (mxt_is_message_pending(&device)){
+		clock_t t0 = clock();
+		touch_read(&device, latency_now());
+		drain_cpu += clock() - t0;
+	}
+	gesture_poll(ms_now());
+	telem_flush();
+}
+
+//ATE O CHIP ENTREGAR TUDO, MAIS extra_ms PARA OS GESTOS PENDENTES
+static void run(uint32_t extra_ms){
+	while (!mxt_sim_done()){
+		step();
+	}
+	for (uint32_t i = 0; i < extra_ms; i++){
+		step();
+	}
+}
+
+static int hit_is(uint32_t i, uint8_t type, int index){
+	return i < hit_count && hits[i].type == type && hits[i].index == index;
+}
+
+static void test_boot(void){
+	printf("boot\n");
+	touch_device_init(&device);
+	check(device.info_object != NULL && mxt_get_object_address(&device, MXT_TOUCH_MULTITOUCHSCREEN_T9, 0) != 0,
+			"info block e tabela de objetos lidos");
+	check(mxt_is_message_pending(&device), "reset e calibracao deixam o CHG baixo");
+	touch_read(&device, latency_now());
+	check(!mxt_is_message_pending(&device) && touch_records() == 0, "mensagens do T6 lidas e descartadas");
+}
+
+static void test_trace(const char *path){
+	uint32_t records = touch_records();
+	int n = mxt_sim_load_trace(path);
+
+	printf("trace %s\n", path);
+	if (n <= 0){
+		check(0, "trace carregado");
+		return;
+	}
+	locked = 1;
+	hit_count = 0;
+	run(100);
+	check(touch_records() - records == (uint32_t)n, "toda mensagem T9 chega ao gesture_feed()");
+	check(hit_count == 3, "tres acertos: press e long-press no cadeado, press no ciclo");
+	check(hit_is(0, GESTURE_PRESS, BUT_LOCK), "press no cadeado (travado)");
+	check(hit_is(1, GESTURE_LONG_PRESS, BUT_LOCK) && !locked, "long-press destrava");
+	check(hit_is(2, GESTURE_PRESS, BUT_FIRST_CICLE + CYCLE_RAPIDO), "press no Rapido");
+}
+
+//FINGERS DEDOS TREMENDO NO LUGAR: PRESS, rate MOVES POR SEGUNDO NO TOTAL E RELEASE
+static uint32_t make_burst(uint32_t rate){
+	uint32_t n = (uint64_t)rate * BURST_US / 1000000;
+	uint64_t t0 = mxt_sim_now() + STEP_US;
+
+	for (uint32_t k = 0; k < n; k++){
+		mxt_sim_touch *t = &burst[k];
+		uint8_t id = k % FINGERS;
+
+		t->t_us = t0 + (uint64_t)k * 1000000 / rate;
+		t->id = id;
+		t->status = k < FINGERS ? MXT_DETECT_EVENT | MXT_PRESS_EVENT
+				: k >= n - FINGERS ? MXT_RELEASE_EVENT : MXT_DETECT_EVENT | MXT_MOVE_EVENT;
+		t->x = 1000 + id * 1000 + (k & 7);
+		t->y = 2000 + (k & 7);
+	}
+	mxt_sim_play(burst, n);
+	return n;
+}
+
+static void test_burst(uint32_t rate){
+	char what[64];
+	uint32_t records = touch_records();
+	uint32_t dropped = mxt_sim_get_stats()->messages_dropped;
+	uint32_t n = make_burst(rate);
+
+	hit_count = 0;
+	drain_cpu = 0;
+	run(10);
+
+	double cpu_s = (double)drain_cpu / CLOCKS_PER_SEC;
+	printf("rajada %5lu/s: %lu mensagens, %.3f ms de CPU, %.0f eventos/s\n", (unsigned long)rate,
+			(unsigned long)n, cpu_s * 1000, cpu_s > 0 ? n / cpu_s : 0);
+	snprintf(what, sizeof(what), "%lu/s: nada perdido no chip nem no caminho", (unsigned long)rate);
+	check(mxt_sim_get_stats()->messages_dropped == dropped && touch_records() - records == n, what);
+	snprintf(what, sizeof(what), "%lu/s: um press por dedo", (unsigned long)rate);
+	check(hit_count == FINGERS, what);
+}
+
+int main(int argc, char *argv[]){
+	const gesture_config gestures = {
+		.long_press_ms = LOCK_LONG_PRESS_MS,
+		.drag_px       = DRAG_MIN_PX,
+		.swipe_px      = SWIPE_MIN_PX,
+		.swipe_ms      = SWIPE_MAX_MS
+	};
+	hit_box boxes[BUTTONS_SIZE];
+
+	clock_init(NULL);
+	if (!mxt_sim_init(NULL, MAXTOUCH_XPRO_CHG_PIO)){
+		printf("nao mapeou os PIOs\n");
+		return 1;
+	}
+	prof_init(CPU_HZ);
+	latency_init(CPU_HZ);
+	tlog_init();
+	telem_init(ms_now, telem_room, telem_write);
+	gesture_init(&gestures, on_gesture);
+
+	//COMO NO main: MATRIZ NOMINAL NA ORIENTACAO DO ili9488_init(), GRADE DOS ICONES
+	touch_calib_nominal(&panel, ILI9488_LCD_HEIGHT, ILI9488_LCD_WIDTH);
+	touch_calib_orient(&panel, ILI9488_SWITCH_XY, &map);
+	touch_init(&map, ms_now);
+	screens_hit_boxes(boxes);
+	touch_grid_build(&grid, boxes, BUTTONS_SIZE);
+
+	test_boot();
+	test_trace(argc > 1 ? argv[1] : TRACE_PATH);
+	test_burst(1000);
+	test_burst(10000);
+	test_burst(50000);
+
+	printf("%s: %d erro(s)\n", errors ? "FALHOU" : "OK", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,133 @@
+/*
+ * tx_ring_sim.c
+ *
+ * Confere o tx_ring no host: as tres politicas com o anel cheio, a volta do
+ * indice com escritas e leituras de tamanhos variados contra um fluxo de
+ * referencia, e uma rajada de log drenada no ritmo de 115200 baud (um byte
+ * a cada ~87 us) para ver a ocupacao maxima do anel de SERIAL_TX_SIZE.
+ *
+ *   gcc -DHOST_BUILD -I. sim/tx_ring_sim.c tx_ring.c -o tx_ring_sim
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "tx_ring.h"
+#include "serial_tx.h"
+#include "check.h"
+
+#define BAUD_BYTES_S  11520u   // 115200 baud, 10 bits por byte
+
+static uint16_t drain(tx_ring *r, char *out, uint16_t max){
+	uint8_t c;
+	uint16_t n = 0;
+
+	while (n < max && tx_ring_pop(r, &c)){
+		out[n++] = (char)c;
+	}
+	out[n] = '\0';
+	return n;
+}
+
+//O "CONSUMIDOR" DO TX_BLOCK: A INTERRUPCAO MANDA UM BYTE
+static tx_ring *blocking;
+static char sent[64];
+static uint16_t sent_n;
+
+static void wait_one(void){
+	uint8_t c;
+
+	if (tx_ring_pop(blocking, &c)){
+		sent[sent_n++] = (char)c;
+	}
+}
+
+static void policies(void){
+	const char *msg = "ABCDEFGHIJKLMNOPQRST";
+	char out[64];
+
+	TX_RING_DEFINE(newest, 16, TX_DROP_NEWEST);
+	tx_ring_write(&newest, msg, 20, NULL);
+	drain(&newest, out, sizeof(out) - 1);
+	check(strcmp(out, "ABCDEFGHIJKLMNO") == 0 && newest.dropped == 5 && newest.written == 15,
+			"TX_DROP_NEWEST guarda o inicio");
+
+	TX_RING_DEFINE(oldest, 16, TX_DROP_OLDEST);
+	tx_ring_write(&oldest, msg, 8, NULL);
+	tx_ring_write(&oldest, msg + 8, 12, NULL);
+	drain(&oldest, out, sizeof(out) - 1);
+	check(strcmp(out, "FGHIJKLMNOPQRST") == 0 && oldest.dropped == 5 && oldest.written == 20,
+			"TX_DROP_OLDEST guarda o fim");
+
+	TX_RING_DEFINE(block, 16, TX_BLOCK);
+	blocking = &block;
+	sent_n = 0;
+	tx_ring_write(&block, msg, 20, wait_one);
+	sent_n += drain(&block, sent + sent_n, sizeof(sent) - 1 - sent_n);
+	sent[sent_n] = '\0';
+	check(strcmp(sent, msg) == 0 && block.dropped == 0 && block.blocked > 0, "TX_BLOCK entrega tudo");
+}
+
+//ESCRITAS E LEITURAS ALEATORIAS PASSANDO PELA VOLTA DO BUFFER
+static void wraparound(void){
+	TX_RING_DEFINE(ring, 64, TX_DROP_NEWEST);
+	uint8_t in = 0, expect = 0;
+	int bad = 0;
+
+	srand(1);
+	for (int i = 0; i < 100000; i++){
+		uint8_t chunk[40];
+		uint16_t n = (uint16_t)(rand() % 40);
+
+		for (uint16_t k = 0; k < n; k++){
+			chunk[k] = (uint8_t)(in + k);
+		}
+		in += tx_ring_write(&ring, chunk, n, NULL);
+
+		uint8_t c;
+		for (int k = rand() % 40; k > 0 && tx_ring_pop(&ring, &c); k--){
+			bad += c != expect++;
+		}
+	}
+	check(bad == 0, "fluxo intacto na volta do indice");
+}
+
+//UMA LINHA DE ~60 BYTES POR TOQUE, 10 TOQUES/s, E O report_load (~300 B) A CADA 5 s
+static void burst(void){
+	TX_RING_DEFINE(ring, SERIAL_TX_SIZE, TX_DROP_NEWEST);
+	char line[300];
+	uint32_t credit = 0;   // bytes que a linha ja poderia ter mandado
+	uint8_t c;
+
+	memset(line, 'x', sizeof(line));
+	for (uint32_t ms = 0; ms < 60000; ms++){
+		if (ms % 100 == 0){
+			tx_ring_write(&ring, line, 60, NULL);
+		}
+		if (ms % 5000 == 0){
+			tx_ring_write(&ring, line, 300, NULL);
+		}
+		credit += BAUD_BYTES_S;
+		while (credit >= 1000 && tx_ring_pop(&ring, &c)){
+			credit -= 1000;
+		}
+		if (tx_ring_empty(&ring)){
+			credit = 0;
+		}
+	}
+	printf("  rajada: %lu bytes, max %u/%u no anel, %lu descartados\n", (unsigned long)ring.written,
+			ring.high_water, ring.mask, (unsigned long)ring.dropped);
+	check(ring.dropped == 0, "log tipico cabe no anel");
+}
+
+int main(void){
+	policies();
+	wraparound();
+	burst();
+	printf("%d erros\n", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
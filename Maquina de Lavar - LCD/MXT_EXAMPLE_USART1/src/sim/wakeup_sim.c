@@ -0,0 +1,205 @@
+/*
+ * wakeup_sim.c
+ *
+ * Conta os wakeups por minuto do loop de eventos no host. As fontes do
+ * main.c sao modeladas em tempo virtual (ms): durante a lavagem o timer da
+ * contagem vence a cada segundo e o do fim termina a lavagem, toques chegam
+ * pelo CHG e o long-press usa outro timer; todos pelo alarme do RTT. O WFI e o hook event_loop_sim_idle,
+ * que pula o relogio direto para a proxima fonte. No fim, uma janela de
+ * estatisticas com mais de 2^32 ciclos acordados confere a carga medida.
+ *
+ *   gcc -DHOST_BUILD -I. sim/wakeup_sim.c event_loop.c event_queue.c gesture.c -o wakeup_sim
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "event_loop.h"
+#include "gesture.h"
+#include "check.h"
+
+#define EV_SIM_END      0xFF
+#define NEVER           UINT32_MAX
+
+#define WASH_MS         (10u * 60u * 1000u)
+#define END_MS          (30u * 60u * 1000u)
+
+#define CPU_HZ          300000000u
+#define LOAD_STEP_MS    5000u        // 1,5e9 ciclos acordado e outro tanto dormindo
+#define LOAD_STEPS      20           // 3e10 ciclos acordado: o CYCCNT volta 7 vezes
+
+enum {IDLE_LOCKED, IDLE_UNLOCKED, WASHING, STATES};
+static const char *state_names[STATES] = {"parado bloqueado", "parado desbloqueado", "lavando"};
+
+//TOQUE DO SCRIPT; action E APLICADA NO RELEASE
+enum {ACT_NONE, ACT_START};
+
+typedef struct {
+	uint32_t t_ms;
+	uint8_t status;
+	uint16_t x, y;
+	uint8_t action;
+} sim_touch;
+
+static const sim_touch script[] = {
+	{300000, GESTURE_T9_PRESS,   40,  40,  ACT_NONE},  // segura o lock
+	{303200, GESTURE_T9_RELEASE, 40,  40,  ACT_NONE},
+	{305000, GESTURE_T9_PRESS,   200, 150, ACT_NONE},  // escolhe o ciclo
+	{305100, GESTURE_T9_RELEASE, 200, 150, ACT_NONE},
+	{306000, GESTURE_T9_PRESS,   400, 250, ACT_NONE},  // start
+	{306100, GESTURE_T9_RELEASE, 400, 250, ACT_START},
+};
+#define SCRIPT_SIZE (sizeof(script) / sizeof(script[0]))
+
+EVENT_QUEUE_DEFINE(touch_events, 8);
+EVENT_QUEUE_DEFINE(timer_events, 8);
+EVENT_QUEUE_DEFINE(sim_events, 2);
+
+static event_queue *const sources[] = {&touch_events, &timer_events, &sim_events};
+#define SOURCES_SIZE (sizeof(sources) / sizeof(sources[0]))
+
+static uint32_t now_ms;
+static uint32_t next_touch;
+static uint32_t ui_deadline = NEVER;
+static uint32_t alarm_ms = NEVER;
+static uint8_t state = IDLE_LOCKED;
+
+static uint32_t state_wakeups[STATES];
+static uint32_t state_ms[STATES];
+static uint32_t wakeups_seen;
+
+static uint32_t wall_ms(void){
+	return now_ms;
+}
+
+//CONTAGEM NA TELA: UM PRAZO POR SEGUNDO ATE O FIM DA LAVAGEM
+static uint32_t next_second(void){
+	return state == WASHING ? (now_ms / 1000 + 1) * 1000 : NEVER;
+}
+
+static uint32_t min3(uint32_t a, uint32_t b, uint32_t c){
+	uint32_t m = a < b ? a : b;
+	return m < c ? m : c;
+}
+
+//O "WFI": AVANCA ATE A PROXIMA FONTE E POSTA O EVENTO DELA
+static void idle_hook(void){
+	uint32_t touch = next_touch < SCRIPT_SIZE ? script[next_touch].t_ms : NEVER;
+	uint32_t t = min3(touch, next_second(), min3(ui_deadline, alarm_ms, END_MS));
+
+	state_ms[state] += t - now_ms;
+	now_ms = t;
+
+	if (t == END_MS){
+		event_queue_post(&sim_events, EV_SIM_END, 0, t);
+	}
+	if (t == touch){
+		event_queue_post(&touch_events, EV_TOUCH, 0, t);
+	}
+	//UM SO ALARME DO RTT, MESMO COM VARIOS PRAZOS NO MESMO INSTANTE
+	if ((state == WASHING && t % 1000 == 0) || t == alarm_ms || t == ui_deadline){
+		event_queue_post(&timer_events, EV_TIMER, 0, t);
+	}
+}
+
+static void on_gesture(const gesture_event *ev){
+	if (ev->type == GESTURE_LONG_PRESS && state != WASHING){
+		state = state == IDLE_LOCKED ? IDLE_UNLOCKED : IDLE_LOCKED;
+	}
+}
+
+//O WFI DA JANELA LONGA: DORME LOAD_STEP_MS, O CYCCNT ANDA JUNTO, E ACORDA COM UM TOQUE
+static void load_idle_hook(void){
+	now_ms += LOAD_STEP_MS;
+	event_loop_sim_cycles += LOAD_STEP_MS * (CPU_HZ / 1000);
+	event_queue_post(&touch_events, EV_TOUCH, 0, now_ms);
+}
+
+//METADE DO TEMPO ACORDADO NUMA JANELA BEM MAIOR QUE OS ~14 s DE 32 BITS
+static void test_long_window(void){
+	event_loop_stats st;
+	event ev;
+
+	printf("janela longa\n");
+	//O EV_SIM_END DO CENARIO ANTERIOR AINDA ESTA NA FILA
+	for (uint8_t i = 0; i < SOURCES_SIZE; i++){
+		while (event_queue_get(sources[i], &ev)){
+		}
+	}
+	event_loop_sim_idle = load_idle_hook;
+	event_loop_sim_cycles = UINT32_MAX - 1000;
+	event_loop_reset_stats();
+	for (int i = 0; i < LOAD_STEPS; i++){
+		now_ms += LOAD_STEP_MS;
+		event_loop_sim_cycles += LOAD_STEP_MS * (CPU_HZ / 1000);
+		event_wait();
+		event_queue_get(&touch_events, &ev);
+	}
+
+	event_loop_get_stats(&st);
+	check(st.busy_cycles == (uint64_t)LOAD_STEPS * LOAD_STEP_MS * (CPU_HZ / 1000), "ciclos acordado passam de 2^32");
+	check(event_loop_load_permille() == 500, "carga de 50% na janela inteira");
+}
+
+int main(void){
+	const gesture_config cfg = {3000, 12, 80, 600};
+	event_loop_stats st;
+
+	gesture_init(&cfg, on_gesture);
+	event_loop_sim_idle = idle_hook;
+	event_loop_init(300000000, wall_ms, sources, SOURCES_SIZE);
+
+	while (true){
+		event ev;
+
+		event_wait();
+		event_loop_get_stats(&st);
+		if (!event_queue_empty(&sim_events)){
+			break;
+		}
+		state_wakeups[state] += st.wakeups - wakeups_seen;
+		wakeups_seen = st.wakeups;
+
+		for (uint8_t i = 0; i < SOURCES_SIZE; i++){
+			while (event_queue_get(sources[i], &ev)){
+				if (ev.type == EV_TOUCH){
+					const sim_touch *t = &script[next_touch++];
+					gesture_feed(0, t->status, t->x, t->y, now_ms);
+					if (t->action == ACT_START && state == IDLE_UNLOCKED){
+						state = WASHING;
+						alarm_ms = now_ms + WASH_MS;
+					}
+				} else if (ev.type == EV_TIMER){
+					if (now_ms == alarm_ms){
+						state = IDLE_LOCKED;
+						alarm_ms = NEVER;
+					}
+					if (now_ms == ui_deadline){
+						ui_deadline = NEVER;
+						gesture_poll(now_ms);
+					}
+				}
+			}
+		}
+
+		uint32_t deadline;
+		ui_deadline = gesture_next_deadline(&deadline) ? deadline : NEVER;
+	}
+
+	printf("%-20s %10s %8s %12s\n", "estado", "tempo(s)", "wakeups", "wakeups/min");
+	for (int i = 0; i < STATES; i++){
+		printf("%-20s %10lu %8lu %12.2f\n", state_names[i], (unsigned long)(state_ms[i] / 1000),
+				(unsigned long)state_wakeups[i],
+				state_ms[i] ? state_wakeups[i] * 60000.0 / state_ms[i] : 0.0);
+	}
+	printf("total: %lu wakeups em %lu ms\n", (unsigned long)wakeups_seen, (unsigned long)st.wall_ms);
+	event_queue_dump(sources, SOURCES_SIZE);
+
+	test_long_window();
+	printf("%s: %d erro(s)\n", errors ? "FALHOU" : "OK", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,292 @@
+/*
+ * wash_flow_sim.c
+ *
+ * Roda o fluxo inteiro da lavagem no host com o mesmo codigo do alvo:
+ * desbloqueia, escolhe o ciclo, da start, conta ate "terminou" e bloqueia de
+ * novo. O relogio e o back end virtual (sim/clock_sim.c), o WFI do loop de
+ * eventos pula para o proximo alarme e os toques do usuario sao timers da
+ * propria timebase, entao a execucao e deterministica e um ciclo de uma hora
+ * leva milissegundos. Confere cada segundo da contagem contra o prazo do fim.
+ * Depois corta a energia no meio de cada ciclo e faz o boot do main.c: com
+ * o backup retido tem que voltar na mesma fase (com o mesmo fim se a queda
+ * foi curta), sem ele tem que cair no menu.
+ *
+ *   gcc -DHOST_BUILD -I. sim/wash_flow_sim.c sim/clock_sim.c sim/backup_sim.c timebase.c \
+ *       timer_wheel.c wash_flow.c wash_checkpoint.c wash_program.c cycle_table.c crc32.c \
+ *       event_loop.c event_queue.c -o wash_flow_sim
+ *   ./wash_flow_sim [escala]    (escala: ms virtuais por ms real, 0 = sem esperar)
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "clock_source.h"
+#include "timebase.h"
+#include "event_loop.h"
+#include "wash_flow.h"
+#include "wash_checkpoint.h"
+#include "backup_regs.h"
+#include "cycle_table.h"
+
+#define UNLOCK_AT_MS    5000u   // segura o lock
+#define SELECT_AT_MS    7000u   // escolhe o ciclo
+#define START_AT_MS     8000u   // start com a porta fechada
+#define RELOCK_AFTER_MS 2000u   // depois do "terminou"
+
+EVENT_QUEUE_DEFINE(timer_events, 4);
+
+static event_queue *const sources[] = {&timer_events};
+#define SOURCES_SIZE (sizeof(sources) / sizeof(sources[0]))
+
+static const cycle_entry *ciclo;
+static uint8_t ciclo_id;
+static uint8_t locked;
+static uint8_t running;
+static timebase_timer user_timer;
+static uint32_t last_left;
+static uint32_t updates;
+static uint32_t redraws;
+static int errors;
+
+static uint32_t wall_ms(void){
+	return (uint32_t)clock_now_ms();
+}
+
+static void on_clock_alarm(void){
+	event_queue_post(&timer_events, EV_TIMER, 0, wall_ms());
+}
+
+static void trace(const char *what){
+	uint64_t t = clock_now_ms();
+	printf("  %3lu:%02lu.%03lu  %s\n", (unsigned long)(t / 60000), (unsigned long)(t / 1000 % 60),
+			(unsigned long)(t % 1000), what);
+}
+
+//O QUE O main.c FAZ EM on_wash_flow(), MAIS A CONFERENCIA DA CONTAGEM
+static void on_wash_flow(uint8_t ev, const wash_phase *ph){
+	redraws++;
+	if (ev == WASH_FLOW_EV_PHASE){
+		trace(wash_phase_name(ph->type));
+	}
+	else if (ev == WASH_FLOW_EV_COUNTDOWN){
+		uint64_t now = clock_now_ms();
+		uint64_t end = wash_flow_end();
+		uint32_t expect = (uint32_t)(((end > now ? end - now : 0) + 999) / 1000);
+		uint32_t left = wash_flow_seconds_left();
+
+		if (left != expect || (updates > 0 && left != last_left - 1)){
+			printf("  contagem errada em %llu ms: %lu (esperado %lu)\n",
+					(unsigned long long)now, (unsigned long)left, (unsigned long)expect);
+			errors++;
+		}
+		last_left = left;
+		updates += left > 0;
+	}
+	else if (ev == WASH_FLOW_EV_DONE){
+		trace("terminou");
+		if (clock_now_ms() != wash_flow_end()){
+			errors++;
+		}
+	}
+}
+
+static void on_relock(timebase_timer *t){
+	locked = 1;
+	wash_flow_reset();
+	trace("bloqueia");
+	running = 0;
+}
+
+//ACOES DO USUARIO, UMA POR TIMER, NA ORDEM DO main.c
+static void on_start(timebase_timer *t){
+	locked = 1;
+	wash_flow_start(ciclo_id, &ciclo->program);
+	trace("start");
+}
+
+static void on_select(timebase_timer *t){
+	wash_flow_reset();
+	trace(ciclo->ciclo.nome);
+	timebase_start(&user_timer, START_AT_MS, on_start);
+}
+
+static void on_unlock(timebase_timer *t){
+	locked = 0;
+	wash_flow_reset();
+	trace("desbloqueia");
+	timebase_start(&user_timer, SELECT_AT_MS, on_select);
+}
+
+static void dispatch(void){
+	event ev;
+
+	while (event_queue_get(&timer_events, &ev)){
+		timebase_process();
+	}
+	//"terminou" na tela: o usuario bloqueia de novo
+	if (wash_flow_get_state() == WASH_FLOW_FINISHED && !timebase_armed(&user_timer)){
+		timebase_start(&user_timer, clock_now_ms() + RELOCK_AFTER_MS, on_relock);
+	}
+}
+
+static int run(const cycle_entry *c){
+	event_loop_stats st;
+	int before = errors;
+
+	ciclo = c;
+	ciclo_id = (uint8_t)(c - cycle_table);
+	locked = 1;
+	running = 1;
+	updates = 0;
+	redraws = 0;
+
+	clock_init(on_clock_alarm);
+	timebase_init();
+	wash_flow_init(on_wash_flow);
+	event_loop_init(1000000, wall_ms, sources, SOURCES_SIZE);
+	timebase_start(&user_timer, UNLOCK_AT_MS, on_unlock);
+	timebase_process();
+
+	while (running){
+		event_wait();
+		dispatch();
+		timebase_process();
+	}
+
+	//UMA ATUALIZACAO POR SEGUNDO, DO TOTAL ATE 1; O 0 VEM COM O FIM
+	if (updates != (c->total_ms + 999) / 1000 || !locked
+			|| wash_flow_get_state() != WASH_FLOW_IDLE){
+		errors++;
+	}
+	event_loop_get_stats(&st);
+	printf("  %lu atualizacoes, %lu redesenhos, %lu alarmes, %lu wakeups%s\n\n",
+			(unsigned long)updates, (unsigned long)redraws, (unsigned long)clock_sim_alarms(),
+			(unsigned long)st.wakeups, errors != before ? ", ERRO" : "");
+	return errors != before;
+}
+
+//###############################################################################################################
+//QUEDA DE ENERGIA
+
+static timebase_timer cut_timer;
+static uint8_t cut;
+
+static void on_cut(timebase_timer *t){
+	cut = 1;
+}
+
+static void on_flow_quiet(uint8_t ev, const wash_phase *ph){
+}
+
+//RODA OS TIMERS ATE cut SUBIR OU A LAVAGEM TERMINAR
+static void run_until_cut(void){
+	event ev;
+
+	cut = 0;
+	while (!cut && wash_flow_get_state() == WASH_FLOW_WASHING){
+		event_wait();
+		while (event_queue_get(&timer_events, &ev)){
+			timebase_process();
+		}
+	}
+}
+
+//O QUE O main.c FAZ NO BOOT: timebase, fluxo e retomada do checkpoint
+static bool boot(void){
+	wash_checkpoint cp;
+
+	timebase_init();
+	wash_flow_init(on_flow_quiet);
+	return wash_checkpoint_load(&cp) && cp.program < CYCLE_COUNT
+			&& wash_flow_resume(cp.program, &cycle_table[cp.program].program, cp.phase, cp.deadline_ms);
+}
+
+//CORTA EM at_ms DO CICLO E FICA outage_ms DESLIGADA
+static int power_cut(uint8_t id, uint32_t at_ms, uint32_t outage_ms, bool keep_backup){
+	const cycle_entry *c = &cycle_table[id];
+	event ev;
+	int before = errors;
+
+	backup_sim_power_loss(false);
+	clock_init(on_clock_alarm);
+	timebase_init();
+	wash_flow_init(on_flow_quiet);
+	event_loop_init(1000000, wall_ms, sources, SOURCES_SIZE);
+	wash_flow_start(id, &c->program);
+	timebase_start(&cut_timer, at_ms, on_cut);
+	run_until_cut();
+
+	uint32_t phase_start = wash_flow_phase()->start_ms;
+	uint32_t phase_end = phase_start + wash_flow_phase()->duration_ms;
+	uint64_t end = wash_flow_end();
+
+	//CAI A ENERGIA: A RAM (FILAS, RODA) SE PERDE; O RTT SO CONTINUA COM O BACKUP
+	clock_set_alarm(CLOCK_NO_ALARM);
+	while (event_queue_get(&timer_events, &ev)){
+	}
+	backup_sim_power_loss(keep_backup);
+	if (keep_backup){
+		clock_sim_advance(outage_ms);
+	} else {
+		clock_init(on_clock_alarm);
+	}
+
+	bool resumed = boot();
+	uint64_t now = clock_now_ms();
+
+	if (resumed != keep_backup){
+		printf("  retomada %s esperado\n", resumed ? "sem ser" : "nao");
+		errors++;
+	}
+	else if (resumed){
+		//A MESMA FASE; O FIM SO MUDA SE A FASE TEVE QUE RECOMECAR
+		uint64_t expect = at_ms + outage_ms < phase_end ? end : now + c->total_ms - phase_start;
+		if (wash_flow_phase()->start_ms != phase_start || wash_flow_end() != expect){
+			printf("  retomou errado: fase %lu, fim %llu (esperado %llu)\n", (unsigned long)wash_flow_phase()->start_ms,
+					(unsigned long long)wash_flow_end(), (unsigned long long)expect);
+			errors++;
+		}
+		run_until_cut();
+		if (wash_flow_get_state() != WASH_FLOW_FINISHED || clock_now_ms() != wash_flow_end()){
+			errors++;
+		}
+	}
+	//TERMINOU (OU FOI PARA O MENU): NADA PARA RETOMAR NO PROXIMO BOOT
+	wash_checkpoint cp;
+	if (wash_checkpoint_load(&cp) && wash_flow_get_state() != WASH_FLOW_IDLE){
+		printf("  checkpoint ficou depois do fim\n");
+		errors++;
+	}
+	wash_flow_reset();
+	timebase_stop(&cut_timer);
+	printf("  corte em %lu ms, %lu ms desligada, backup %s: %s\n", (unsigned long)at_ms, (unsigned long)outage_ms,
+			keep_backup ? "retido" : "perdido", errors != before ? "ERRO" : (resumed ? "retomou" : "menu"));
+	return errors != before;
+}
+
+int main(int argc, char **argv){
+	clock_t t0 = clock();
+
+	clock_sim_set_scale(argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 0);
+	event_loop_sim_idle = clock_sim_idle;
+
+	for (unsigned i = 0; i < CYCLE_COUNT; i++){
+		printf("%s\n", cycle_table[i].ciclo.nome);
+		run(&cycle_table[i]);
+	}
+	for (uint8_t i = 0; i < CYCLE_COUNT; i++){
+		uint32_t mid = cycle_table[i].total_ms / 2;
+
+		printf("%s, queda de energia\n", cycle_table[i].ciclo.nome);
+		power_cut(i, mid, 50, true);
+		power_cut(i, mid, 600000, true);
+		power_cut(i, mid, 50, false);
+		printf("\n");
+	}
+	printf("%d erros, %.3f ms de CPU\n", errors, (clock() - t0) * 1000.0 / CLOCKS_PER_SEC);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,94 @@
+/*
+ * wash_sim.c
+ *
+ * Roda os ciclos de ciclos.def no motor de lavagem em tempo virtual: o
+ * relogio pula direto para o proximo prazo do motor, como o wash_timer do
+ * main.c faz no RTT, entao um ciclo de uma hora termina em milissegundos.
+ *
+ *   gcc -DHOST_BUILD -I. sim/wash_sim.c wash_program.c cycle_table.c -o wash_sim
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "wash_program.h"
+#include "cycle_table.h"
+
+static uint64_t now_ms;
+static uint32_t changes;
+
+static void on_phase(const wash_engine *e, const wash_phase *ph){
+	uint64_t elapsed = now_ms - e->start_ms;
+
+	changes++;
+	printf("  %3lu:%02lu  %-14s", (unsigned long)(elapsed / 60000), (unsigned long)(elapsed / 1000 % 60),
+			wash_phase_name(ph->type));
+	if (ph->type == WASH_PHASE_RINSE){
+		printf(" #%u", ph->index);
+	}
+	if (ph->rpm){
+		printf(" %u rpm", ph->rpm);
+	}
+	printf("\n");
+}
+
+//A TABELA GERADA TEM QUE BATER COM O QUE wash_program.c COMPILA HOJE
+static int check_table(const cycle_entry *ce){
+	t_ciclo heavy = ce->ciclo;
+	wash_program p, ph;
+
+	heavy.heavy = 1;
+	wash_program_compile(&ce->ciclo, &p);
+	wash_program_compile(&heavy, &ph);
+	if (p.count != ce->program.count || p.total_ms != ce->program.total_ms
+			|| memcmp(p.phases, ce->program.phases, p.count * sizeof(wash_phase)) != 0
+			|| ce->total_ms != p.total_ms || ce->heavy_ms != ph.total_ms){
+		printf("  cycle_table.c desatualizada, gere de novo\n");
+		return 1;
+	}
+	return 0;
+}
+
+//EXECUTA UM CICLO E CONFERE QUE CADA TROCA CAIU NO INICIO ACUMULADO DA FASE
+static int run(const cycle_entry *ce){
+	const t_ciclo *c = &ce->ciclo;
+	wash_engine e;
+	uint64_t deadline;
+	int errors = check_table(ce);
+
+	printf("%s\n", c->nome);
+	now_ms = 1000;
+	changes = 0;
+	wash_engine_start(&e, c, now_ms, on_phase);
+
+	while ((deadline = wash_engine_next_deadline(&e)) != WASH_NO_DEADLINE){
+		now_ms = deadline;
+		wash_engine_advance(&e, now_ms);
+		if (now_ms - e.start_ms != wash_engine_phase(&e)->start_ms){
+			errors++;
+		}
+	}
+	if (changes != e.program.count || now_ms != wash_engine_end(&e)
+			|| wash_engine_remaining(&e, now_ms) != 0){
+		errors++;
+	}
+	printf("  total %lu min %lu s, %u fases%s\n\n", (unsigned long)(e.program.total_ms / 60000),
+			(unsigned long)(e.program.total_ms / 1000 % 60), e.program.count,
+			errors ? ", ERRO" : "");
+	return errors;
+}
+
+int main(void){
+	clock_t t0 = clock();
+	int errors = 0;
+
+	for (unsigned i = 0; i < CYCLE_COUNT; i++){
+		errors += run(&cycle_table[i]);
+	}
+	printf("%d erros, %.3f ms de CPU\n", errors, (clock() - t0) * 1000.0 / CLOCKS_PER_SEC);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
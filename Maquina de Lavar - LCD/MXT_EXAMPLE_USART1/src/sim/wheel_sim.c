@@ -0,0 +1,184 @@
+/*
+ * wheel_sim.c
+ *
+ * Confere o timer_wheel.c contra uma lista de prazos varrida por forca
+ * bruta. Passos aleatorios (semente fixa) armam, rearmam e cancelam timers
+ * com prazos ja vencidos, curtos, em cada nivel e alem do nivel 3 (lista de
+ * estouro), e andam o tempo ou pulando para wheel_next(), como a timebase
+ * faz, ou com saltos de ate horas. A cada wheel_run() tem que vencer
+ * exatamente o que a lista diz, em ordem de prazo, e wheel_next() nunca
+ * pode passar do proximo prazo. Metade dos callbacks rearma o proprio timer.
+ *
+ *   gcc -DHOST_BUILD -I. sim/wheel_sim.c timer_wheel.c -o wheel_sim && ./wheel_sim
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "timer_wheel.h"
+#include "check.h"
+
+#define TIMERS       64
+#define STEPS        2000000
+#define LEVEL_MS(l)  (1ull << (WHEEL_BITS * (l)))
+#define OVERFLOW_MS  LEVEL_MS(WHEEL_LEVELS)   // ~4,6 h
+
+typedef struct {
+	wheel_timer timer;
+	uint64_t deadline;     // o prazo como foi pedido
+	uint64_t due;          // quando tem que vencer: o prazo, ou o now se ja passou
+	uint8_t armed;
+} sim_timer;
+
+static timer_wheel wheel;
+static sim_timer timers[TIMERS];
+static uint64_t now;
+static uint32_t rng = 0x12345678;
+
+static uint32_t fired, late, early, wrong_time, out_of_order, next_past, never_wrong;
+static uint32_t expired_adds, overflow_adds, rearms, cancels;
+static uint64_t last_due;
+static sim_timer *firing;        // callback em andamento
+
+static uint32_t rnd(void){
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+static uint64_t rnd_range(uint64_t n){
+	return (((uint64_t)rnd() << 32) | rnd()) % n;
+}
+
+//PRAZO RELATIVO A now: VENCIDO, NO MESMO ms OU EM QUALQUER NIVEL, ATE O ESTOURO
+static uint64_t pick_deadline(void){
+	switch (rnd() % 8){
+		case 0:  return now - rnd_range(now < 1000 ? now + 1 : 1000);
+		case 1:  return now;
+		case 2:  return now + OVERFLOW_MS + rnd_range(4 * OVERFLOW_MS);
+		default: return now + rnd_range(LEVEL_MS(1 + rnd() % WHEEL_LEVELS));
+	}
+}
+
+static void arm(sim_timer *s, uint64_t deadline);
+
+static void on_fire(wheel_timer *t){
+	sim_timer *s = (sim_timer *)((char *)t - offsetof(sim_timer, timer));
+
+	fired++;
+	if (!s->armed){
+		early++;    // venceu algo que a lista diz que foi cancelado
+		return;
+	}
+	//A RODA ESTA NO INSTANTE DO SLOT: O PRAZO TEM QUE SER EXATAMENTE ESSE
+	if (s->due != wheel.now){
+		wrong_time++;
+	}
+	if (s->due < last_due){
+		out_of_order++;
+	}
+	last_due = s->due;
+	s->armed = 0;
+	if (rnd() & 1){
+		firing = s;
+		rearms++;
+		arm(s, pick_deadline());
+		firing = NULL;
+	}
+}
+
+static void arm(sim_timer *s, uint64_t deadline){
+	s->deadline = deadline;
+	//FORA DO CALLBACK A RODA JA ESTA EM now; DENTRO, NO INSTANTE QUE VENCEU
+	uint64_t base = firing ? wheel.now : now;
+
+	s->due = deadline > base ? deadline : base;
+	s->armed = 1;
+	expired_adds += deadline < now;
+	wheel_add(&wheel, &s->timer, deadline, on_fire);
+	overflow_adds += s->timer.level == WHEEL_LEVELS;
+}
+
+static uint64_t min_due(void){
+	uint64_t m = WHEEL_NEVER;
+
+	for (int i = 0; i < TIMERS; i++){
+		if (timers[i].armed && timers[i].due < m){
+			m = timers[i].due;
+		}
+	}
+	return m;
+}
+
+//ANDA ATE to; DEPOIS DISSO NADA ARMADO PODE TER PRAZO <= to
+static void advance(uint64_t to){
+	now = to;
+	last_due = 0;
+	wheel_run(&wheel, now);
+	for (int i = 0; i < TIMERS; i++){
+		if (timers[i].armed && timers[i].due <= now){
+			late++;
+		}
+	}
+}
+
+int main(void){
+	wheel_init(&wheel, now);
+
+	for (uint32_t step = 0; step < STEPS; step++){
+		sim_timer *s = &timers[rnd() % TIMERS];
+		uint32_t op = rnd() % 16;
+
+		if (op < 6){
+			arm(s, pick_deadline());
+		} else if (op < 8){
+			cancels += s->armed;
+			s->armed = 0;
+			wheel_cancel(&wheel, &s->timer);
+		} else if (op < 13){
+			uint64_t next = wheel_next(&wheel);
+			if (next != WHEEL_NEVER && next > now){
+				advance(next);
+			}
+		} else if (op < 15){
+			advance(now + rnd_range(LEVEL_MS(1 + rnd() % 3)));
+		} else {
+			advance(now + rnd_range(2 * OVERFLOW_MS));
+		}
+
+		uint64_t due = min_due();
+		uint64_t next = wheel_next(&wheel);
+		next_past += next > due;
+		never_wrong += (due == WHEEL_NEVER) != (next == WHEEL_NEVER);
+	}
+
+	//NO FIM ESVAZIA: CANCELA METADE E DEIXA O RESTO VENCER
+	for (int i = 0; i < TIMERS; i += 2){
+		timers[i].armed = 0;
+		wheel_cancel(&wheel, &timers[i].timer);
+	}
+	while (min_due() != WHEEL_NEVER){
+		advance(min_due());
+	}
+
+	printf("%lu passos, %lu vencimentos, %lu rearmes no callback, %lu cancelamentos\n",
+			(unsigned long)STEPS, (unsigned long)fired, (unsigned long)rearms, (unsigned long)cancels);
+	printf("%lu prazos ja vencidos ao armar, %lu na lista de estouro, agora = %.1f dias\n",
+			(unsigned long)expired_adds, (unsigned long)overflow_adds, now / 86400000.0);
+	check(expired_adds > 0 && overflow_adds > 0, "passou por prazos vencidos e pelo estouro");
+	check(early == 0, "nada vence depois de cancelado");
+	check(wrong_time == 0, "cada vencimento no ms do prazo");
+	check(late == 0, "todo prazo vencido sai no wheel_run()");
+	check(out_of_order == 0, "vencimentos em ordem de prazo");
+	check(next_past == 0, "wheel_next() nunca passa do proximo prazo");
+	check(never_wrong == 0, "WHEEL_NEVER so com a roda vazia");
+	check(wheel_next(&wheel) == WHEEL_NEVER, "roda vazia no fim");
+
+	printf("%s: %d erro(s)\n", errors ? "FALHOU" : "OK", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
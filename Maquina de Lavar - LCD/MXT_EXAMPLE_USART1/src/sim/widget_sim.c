@@ -0,0 +1,356 @@
+/*
+ * widget_sim.c
+ *
+ * Confere o widget.c no host sobre a GRAM do sim/lcd_spi_sim.c. Primeiro
+ * uma arvore pequena, com icones e fonte de mentira: cada mudanca so
+ * escreve dentro de onde o widget estava e de onde ficou, a ordem de z vale
+ * dentro da area recortada, e um quadro sem mudanca nao manda nada. Depois
+ * as telas reais (screens.c) numa sequencia de uso: depois de cada quadro
+ * a GRAM tem que ser igual a de um redesenho da tela inteira.
+ *
+ *   ASF=$(sed -n 's|.*<Value>\.\./src/\(ASF[^<]*\)</Value>|-I./\1|p' ../MXT_EXAMPLE_USART1.cproj)
+ *   gcc -DHOST_BUILD -D__SAME70Q21B__ -DBOARD=SAME70_XPLAINED -DILI9488_SPIMODE -I. -I./config $ASF \
+ *       sim/widget_sim.c sim/lcd_spi_sim.c screens.c widget.c frame_sched.c cycle_table.c wash_program.c \
+ *       prof.c latency.c ASF/sam/components/display/ili9488/ili9488.c -o widget_sim
+ *   ./widget_sim
+ */
+
+#ifdef HOST_BUILD
+
+#include <asf.h>
+#include <stdio.h>
+#include <string.h>
+#include "gui.h"
+#include "screens.h"
+#include "widget.h"
+#include "cycle_table.h"
+#include "wash_flow.h"
+#include "lcd_spi_sim.h"
+#include "check.h"
+
+#define ICON     8
+#define GLYPH_W  4
+#define GLYPH_H  6
+#define GLYPHS   ('9' - '0' + 2)   // '0'..'9' e ':'
+#define SPOTS    (WIDGET_DAMAGE_MAX + 4)
+
+struct ili9488_opt_t g_ili9488_display_opt;
+
+static uint8_t gram_copy[LCD_SIM_WIDTH * LCD_SIM_HEIGHT * 3];
+
+//####################################################################
+//ICONES E FONTE DE MENTIRA: CADA UM DE UMA COR SO
+
+static uint8_t icon_data[2][ICON * ICON * 3];
+static const tImage icon[2] = {{icon_data[0], ICON, ICON, 0}, {icon_data[1], ICON, ICON, 0}};
+static uint8_t glyph_data[GLYPHS][GLYPH_W * GLYPH_H * 3];
+static tImage glyph_image[GLYPHS];
+static tChar glyph_chars[GLYPHS];
+static const tFont font = {GLYPHS, glyph_chars, '0', ':'};
+
+static void make_assets(void){
+	memset(icon_data[0], 0x10, sizeof(icon_data[0]));
+	memset(icon_data[1], 0x20, sizeof(icon_data[1]));
+	for (int i = 0; i < GLYPHS; i++){
+		memset(glyph_data[i], 0x40 + i, sizeof(glyph_data[i]));
+		glyph_image[i] = (tImage){glyph_data[i], GLYPH_W, GLYPH_H, 0};
+		glyph_chars[i] = (tChar){'0' + i, &glyph_image[i]};
+	}
+}
+
+//####################################################################
+//GRAM
+
+static const uint8_t *pixel(uint16_t x, uint16_t y){
+	return lcd_sim_gram() + ((uint32_t)y * LCD_SIM_WIDTH + x) * 3;
+}
+
+static uint32_t touched_count(void){
+	const uint8_t *t = lcd_sim_touched();
+	uint32_t n = 0;
+
+	for (uint32_t i = 0; i < LCD_SIM_WIDTH * LCD_SIM_HEIGHT; i++){
+		n += t[i];
+	}
+	return n;
+}
+
+static int in_rect(const widget_rect *r, uint16_t x, uint16_t y){
+	return x >= r->x && y >= r->y && x < r->x + r->w && y < r->y + r->h;
+}
+
+//CADA PIXEL ESCRITO ESTA EM a OU EM b
+static int touched_within(const widget_rect *a, const widget_rect *b){
+	const uint8_t *t = lcd_sim_touched();
+
+	for (uint16_t y = 0; y < LCD_SIM_HEIGHT; y++){
+		for (uint16_t x = 0; x < LCD_SIM_WIDTH; x++){
+			if (t[y * LCD_SIM_WIDTH + x] && !in_rect(a, x, y) && !in_rect(b, x, y)){
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+static int same_pixel(uint16_t x, uint16_t y, const uint8_t *rgb){
+	return memcmp(pixel(x, y), rgb, 3) == 0;
+}
+
+static void save_gram(void){
+	memcpy(gram_copy, lcd_sim_gram(), sizeof(gram_copy));
+}
+
+//SUJA A TELA INTEIRA POR FORA DA ARVORE
+static void scribble(void){
+	ili9488_set_foreground_color(COLOR_CONVERT(COLOR_RED));
+	ili9488_draw_filled_rectangle(0, 0, ILI9488_LCD_WIDTH - 1, ILI9488_LCD_HEIGHT - 1);
+}
+
+//####################################################################
+//ARVORE PEQUENA
+
+static widget root, a, b, text, clock, bar, group, hidden, spots[SPOTS];
+
+static void tree_repaint_matches(const char *what){
+	save_gram();
+	scribble();
+	widget_damage(0, 0, ILI9488_LCD_WIDTH, ILI9488_LCD_HEIGHT);
+	widget_render(&root);
+	check(memcmp(gram_copy, lcd_sim_gram(), sizeof(gram_copy)) == 0, what);
+}
+
+static void test_tree(void){
+	widget_stats s0, s1;
+	widget_rect before, empty = {0, 0, 0, 0};
+	uint8_t bg[3];
+
+	widget_container(&root, 0, 0, ILI9488_LCD_WIDTH, ILI9488_LCD_HEIGHT, true, COLOR_CONVERT(COLOR_WHITE));
+	widget_image_button(&a, 10, 10, &icon[0], &icon[1]);
+	widget_image_button(&b, 14, 14, &icon[1], &icon[0]);
+	widget_label(&text, 50, 50, &font, 1, "0123");
+	widget_number(&clock, 50, 80, &font, 1, NUMBER_MMSS);
+	widget_progress(&bar, 20, 200, 100, 10, COLOR_CONVERT(COLOR_BLUE), COLOR_CONVERT(COLOR_LIGHTGREY));
+	widget_container(&group, 0, 0, ILI9488_LCD_WIDTH, ILI9488_LCD_HEIGHT, false, 0);
+	widget_image_button(&hidden, 200, 300, &icon[0], &icon[1]);
+	widget_add(&root, &b, 1);
+	widget_add(&root, &a, 0);
+	widget_add(&root, &text, 0);
+	widget_add(&root, &clock, 0);
+	widget_add(&root, &bar, 0);
+	widget_add(&group, &hidden, 0);
+	widget_add(&root, &group, 0);
+	widget_set_visible(&group, false);
+
+	printf("arvore pequena\n");
+	lcd_sim_reset();
+	widget_render(&root);
+	check(touched_count() == LCD_SIM_WIDTH * LCD_SIM_HEIGHT, "primeiro quadro pinta a tela inteira");
+	check(text.bounds.w == 4 * GLYPH_W + 3 && text.bounds.h == GLYPH_H, "bounds do texto medidos pela fonte");
+	memcpy(bg, pixel(LCD_SIM_WIDTH - 1, LCD_SIM_HEIGHT - 1), 3);
+	check(same_pixel(15, 15, icon_data[1]), "b (z 1) por cima de a (z 0)");
+
+	lcd_sim_reset();
+	widget_get_stats(&s0);
+	widget_render(&root);
+	widget_get_stats(&s1);
+	check(touched_count() == 0 && s1.renders == s0.renders, "quadro sem mudanca nao manda nada");
+
+	//MESMO ESTADO NAO SUJA
+	widget_set_state(&a, 0);
+	widget_set_text(&text, "0123");
+	widget_set_value(&clock, 0);
+	check(!widget_pending(&root), "setter com o mesmo valor nao suja");
+
+	//a TROCA DE ICONE: SO OS BOUNDS DELE, b CONTINUA POR CIMA
+	lcd_sim_reset();
+	widget_set_state(&a, 1);
+	widget_render(&root);
+	check(touched_count() == ICON * ICON && touched_within(&a.bounds, &empty), "botao: so os bounds dele");
+	check(same_pixel(10, 10, icon_data[1]) && same_pixel(15, 15, icon_data[1]), "botao: icone novo, b por cima");
+
+	//NUMERO QUE CRESCE: DENTRO DO ANTIGO E DO NOVO
+	lcd_sim_reset();
+	before = clock.painted;
+	widget_set_value(&clock, 600);
+	widget_render(&root);
+	check(clock.bounds.w == 5 * GLYPH_W + 4, "numero: 10:00 medido");
+	check(touched_within(&before, &clock.bounds), "numero: so onde estava e onde esta");
+
+	//TEXTO QUE ENCOLHE: O QUE SOBRA VOLTA AO FUNDO
+	lcd_sim_reset();
+	before = text.painted;
+	widget_set_text(&text, "0");
+	widget_render(&root);
+	check(touched_within(&before, &empty), "texto: so onde estava");
+	check(same_pixel(50, 50, glyph_data[0]) && same_pixel(50 + 3 * GLYPH_W, 50, bg), "texto: resto apagado");
+
+	//BARRA: SO AS COLUNAS QUE MUDARAM
+	widget_set_range(&bar, 0, 100);
+	widget_render(&root);
+	lcd_sim_reset();
+	widget_set_value(&bar, 50);
+	widget_render(&root);
+	widget_rect half = {20, 200, 50, 10};
+	check(touched_count() == 50 * 10 && touched_within(&half, &empty), "barra: so as colunas novas");
+	lcd_sim_reset();
+	widget_set_value(&bar, 30);
+	widget_render(&root);
+	widget_rect back = {50, 200, 20, 10};
+	check(touched_count() == 20 * 10 && touched_within(&back, &empty), "barra: recuo so nas colunas");
+
+	//GRUPO ESCONDIDO: MOSTRAR E ESCONDER SO MEXE NO FILHO
+	lcd_sim_reset();
+	widget_set_visible(&group, true);
+	widget_render(&root);
+	check(touched_count() == ICON * ICON && same_pixel(200, 300, icon_data[0]), "grupo: aparece so o filho");
+	lcd_sim_reset();
+	widget_set_visible(&group, false);
+	widget_render(&root);
+	check(touched_within(&hidden.bounds, &empty) && same_pixel(200, 300, bg), "grupo: some e volta o fundo");
+	check(hidden.painted.w == 0, "grupo: filho escondido sem painted");
+
+	//FILHO ESCONDIDO MUDANDO NAO VAI PARA A TELA
+	lcd_sim_reset();
+	widget_set_state(&hidden, 1);
+	widget_render(&root);
+	check(touched_count() == 0, "escondido: mudanca nao desenha");
+
+	widget_get_stats(&s0);
+	check(s0.merges == 0, "sem juntar areas ate aqui");
+	tree_repaint_matches("GRAM igual ao redesenho inteiro");
+
+	//MAIS AREAS QUE WIDGET_DAMAGE_MAX: JUNTA, MAS A TELA FICA CERTA
+	for (int i = 0; i < SPOTS; i++){
+		widget_image_button(&spots[i], 20 + (i % 10) * 28, 400 + (i / 10) * 30, &icon[0], &icon[1]);
+		widget_add(&root, &spots[i], 2);
+	}
+	widget_render(&root);
+	lcd_sim_reset();
+	for (int i = 0; i < SPOTS; i++){
+		widget_set_state(&spots[i], 1);
+	}
+	widget_render(&root);
+	widget_get_stats(&s1);
+	check(s1.merges > 0 && same_pixel(20, 400, icon_data[1]), "cheio: junta areas");
+	tree_repaint_matches("cheio: GRAM igual ao redesenho inteiro");
+}
+
+//####################################################################
+//TELAS REAIS
+
+static uint8_t button_state[BUTTONS_SIZE];
+static ui_view view = {.button_state = button_state};
+
+static void frame(const char *what){
+	char name[64];
+
+	lcd_sim_reset();
+	draw_display(&view);
+	save_gram();
+	scribble();
+	screens_repaint();
+	draw_display(&view);
+	snprintf(name, sizeof(name), "%s: igual ao redesenho inteiro", what);
+	check(memcmp(gram_copy, lcd_sim_gram(), sizeof(gram_copy)) == 0, name);
+
+	lcd_sim_reset();
+	draw_display(&view);
+	snprintf(name, sizeof(name), "%s: repetido nao manda nada", what);
+	check(touched_count() == 0, name);
+}
+
+static void select_mode(uint8_t mode){
+	for (int i = BUT_FIRST_CICLE; i < BUTTONS_SIZE; i++){
+		button_state[i] = CLICKED;
+	}
+	if (mode < CICLE_BUTTONS){
+		button_state[BUT_FIRST_CICLE + mode] = RELEASED;
+	}
+	view.mode = mode;
+}
+
+static void test_screens(void){
+	widget_stats s0, s1;
+
+	printf("telas\n");
+	for (int i = 0; i < BUTTONS_SIZE; i++){
+		button_state[i] = CLICKED;
+	}
+	widget_get_stats(&s0);
+	screens_init();
+	view.locked = 1;
+	view.wash_state = WASH_FLOW_IDLE;
+	frame("bloqueada");
+
+	//AS LARGURAS GERADAS SAO AS QUE O widget_set_text() MEDIRIA
+	bool widths = true;
+	for (uint8_t k = 0; k < CYCLE_COUNT; k++){
+		for (uint8_t i = 0; i < CYCLE_LABELS; i++){
+			const cycle_label *l = &cycle_table[k].labels[i];
+			widths &= l->width == widget_text_width(&calibri_24, SPACE, l->text);
+		}
+	}
+	check(widths, "larguras da cycle_table");
+
+	view.locked = 0;
+	button_state[BUT_LOCK] = RELEASED;
+	for (uint8_t k = 0; k < CYCLE_COUNT; k++){
+		select_mode(k);
+		frame(cycle_table[k].ciclo.nome);
+	}
+
+	select_mode(0);
+	view.door_msg = 1;
+	frame("fechar porta");
+	view.door_msg = 0;
+	frame("aviso some");
+
+	const cycle_entry *e = &cycle_table[view.mode];
+	view.locked = 1;
+	view.wash_state = WASH_FLOW_WASHING;
+	view.phase = e->program.phases[0].type;
+	view.seconds_left = e->total_ms / 1000;
+	button_state[BUT_LOCK] = CLICKED;
+	frame("lavando");
+	for (int i = 0; i < 3; i++){
+		view.seconds_left -= 61;
+		frame("contagem");
+	}
+	view.phase = e->program.phases[1].type;
+	frame("troca de fase");
+	view.wash_state = WASH_FLOW_FINISHED;
+	frame("terminou");
+
+	view.locked = 0;
+	view.wash_state = WASH_FLOW_IDLE;
+	button_state[BUT_LOCK] = RELEASED;
+	frame("volta ao menu");
+
+	widget_get_stats(&s1);
+	check(s1.merges == s0.merges, "telas: nenhuma area juntada");
+}
+
+int main(void){
+	if (!lcd_sim_init()){
+		printf("nao mapeou o SPI0\n");
+		return 1;
+	}
+	g_ili9488_display_opt.ul_width = ILI9488_LCD_WIDTH;
+	g_ili9488_display_opt.ul_height = ILI9488_LCD_HEIGHT;
+	g_ili9488_display_opt.foreground_color = COLOR_CONVERT(COLOR_WHITE);
+	g_ili9488_display_opt.background_color = COLOR_CONVERT(COLOR_WHITE);
+	if (ili9488_init(&g_ili9488_display_opt) != 0){
+		printf("ili9488_init falhou\n");
+		return 1;
+	}
+	make_assets();
+
+	test_tree();
+	test_screens();
+
+	printf("%s: %d erro(s)\n", errors ? "FALHOU" : "OK", errors);
+	return errors != 0;
+}
+
+#endif /* HOST_BUILD */
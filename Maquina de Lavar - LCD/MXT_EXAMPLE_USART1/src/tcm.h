@@ -0,0 +1,40 @@
+/*
+ * tcm.h
+ *
+ * Posicionamento nos TCM do Cortex-M7 (32 KB de cada, GPNVM 8:7 = 01 no
+ * board_init()). ITCM_FUNC poe a funcao na secao .itcm: gravada na flash
+ * e copiada para o ITCM no boot, roda sem esperar a flash nem disputar o
+ * I-cache. DTCM_BSS poe a variavel na .dtcm: so dados zerados (a secao e
+ * NOLOAD e o board_init() zera), sem inicializador. O uso sai no link
+ * (--print-memory-usage: regioes itcm e dtcm). Com TCM_ENABLE 0, ou no
+ * host, as macros somem e tudo volta para flash e SRAM, para comparar.
+ * O tcm_bench() (buffers na DTCM e copia no ITCM) so entra no build com
+ * CONF_TCM_BENCH 1; sem ele o console responde "nao disponivel".
+ */
+
+
+#ifndef TCM_H_
+#define TCM_H_
+
+#ifndef TCM_ENABLE
+#define TCM_ENABLE  1
+#endif
+
+#ifndef CONF_TCM_BENCH
+#define CONF_TCM_BENCH  0
+#endif
+
+#if TCM_ENABLE && !defined(HOST_BUILD)
+//noinline: INLINE NUM CHAMADOR DA FLASH, O CODIGO RODARIA DA FLASH
+#define ITCM_FUNC   __attribute__((section(".itcm"), noinline))
+#define DTCM_BSS    __attribute__((section(".dtcm")))
+#else
+#define ITCM_FUNC
+#define DTCM_BSS
+#endif
+
+#if CONF_TCM_BENCH
+void tcm_bench(void);
+#endif
+
+#endif /* TCM_H_ */
@@ -0,0 +1,90 @@
+/*
+ * tcm_bench.c
+ *
+ * Benchmark de bancada do tcm.h (comando "bench" do console): a mesma copia
+ * de uma linha do LCD (320 pixels de 3 bytes, trocando R e B para o
+ * compilador nao virar memcpy) compilada duas vezes, uma na flash e outra
+ * no ITCM, sobre buffers na SRAM e na DTCM. Imprime ciclos e MB/s de cada
+ * combinacao e os enderecos, para conferir onde o linker pos cada coisa.
+ * Com TCM_ENABLE 0 as quatro linhas tem que dar o mesmo. So compila com
+ * CONF_TCM_BENCH 1 (tcm.h): os 1920 bytes de DTCM e a copia no ITCM nao
+ * ficam no build normal.
+ */
+
+#include <asf.h>
+#include <stdio.h>
+#include "tcm.h"
+#include "prof.h"
+
+#if CONF_TCM_BENCH
+
+#define BENCH_PIXELS  320
+#define BENCH_BYTES   (BENCH_PIXELS * 3)
+#define BENCH_RUNS    1000
+
+#define BLIT_ROW(name, attr) \
+	static attr void name(uint8_t *dst, const uint8_t *src, uint32_t pixels){ \
+		for (uint32_t i = 0; i < pixels; i++, dst += 3, src += 3){ \
+			dst[0] = src[2]; \
+			dst[1] = src[1]; \
+			dst[2] = src[0]; \
+		} \
+	}
+
+BLIT_ROW(blit_flash, __attribute__((noinline)))
+BLIT_ROW(blit_tcm, ITCM_FUNC)
+
+typedef void (*blit_fn)(uint8_t *dst, const uint8_t *src, uint32_t pixels);
+
+static uint8_t sram_src[BENCH_BYTES];
+static uint8_t sram_dst[BENCH_BYTES];
+static uint8_t dtcm_src[BENCH_BYTES] DTCM_BSS;
+static uint8_t dtcm_dst[BENCH_BYTES] DTCM_BSS;
+
+typedef struct {
+	const char *name;
+	blit_fn fn;
+	uint8_t *dst;
+	const uint8_t *src;
+} bench_case;
+
+static const bench_case cases[] = {
+	{"flash/sram", blit_flash, sram_dst, sram_src},
+	{"flash/dtcm", blit_flash, dtcm_dst, dtcm_src},
+	{"itcm/sram",  blit_tcm,   sram_dst, sram_src},
+	{"itcm/dtcm",  blit_tcm,   dtcm_dst, dtcm_src},
+};
+
+//SEM INTERRUPCAO DURANTE A MEDIDA; A PRIMEIRA PASSADA SO AQUECE O CACHE
+static uint32_t run_case(const bench_case *c){
+	irqflags_t flags = cpu_irq_save();
+
+	c->fn(c->dst, c->src, BENCH_PIXELS);
+	uint32_t start = prof_ticks();
+	for (uint32_t i = 0; i < BENCH_RUNS; i++){
+		c->fn(c->dst, c->src, BENCH_PIXELS);
+	}
+	uint32_t ticks = prof_ticks() - start;
+	cpu_irq_restore(flags);
+	return ticks;
+}
+
+void tcm_bench(void){
+	uint32_t mhz = sysclk_get_cpu_hz() / 1000000;
+
+	for (uint32_t i = 0; i < BENCH_BYTES; i++){
+		sram_src[i] = dtcm_src[i] = (uint8_t)i;
+	}
+	printf("tcm: TCM_ENABLE %d, %d x %d bytes\n\r", TCM_ENABLE, BENCH_RUNS, BENCH_BYTES);
+	for (uint8_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++){
+		const bench_case *c = &cases[i];
+		uint32_t ticks = run_case(c);
+		uint32_t mbs = (uint32_t)((uint64_t)BENCH_BYTES * BENCH_RUNS * mhz / (ticks ? ticks : 1));
+
+		printf("%-10s %8lu ciclos/linha %4lu MB/s  fn %08lx dst %08lx\n\r", c->name,
+				(unsigned long)(ticks / BENCH_RUNS), (unsigned long)mbs,
+				(unsigned long)(uintptr_t)c->fn, (unsigned long)(uintptr_t)c->dst);
+	}
+}
+
+#endif /* CONF_TCM_BENCH */
@@ -0,0 +1,184 @@
+/*
+ * telemetry.c
+ *
+ * Um quadro em montagem em RAM. Um registro que nao cabe fecha o quadro
+ * (vai para a linha se houver espaco no anel da serial); se o anterior
+ * ainda esta esperando espaco, o registro novo e descartado. So o main
+ * chama: nao e seguro em interrupcao.
+ */
+
+#include <string.h>
+#include "telemetry.h"
+#include "cobs.h"
+#include "crc32.h"
+
+#define FRAME_HEADER  5   // seq u8, base_ms u32
+#define FRAME_MAX     (FRAME_HEADER + TELEM_PAYLOAD_MAX + 4)
+
+static uint32_t (*clock_ms)(void);
+static uint16_t (*line_room)(void);
+static uint16_t (*line_write)(const void *data, uint16_t len);
+
+static uint8_t frame[FRAME_MAX];
+static uint16_t used;           // 0 = nenhum quadro aberto
+static uint32_t base_ms;
+static uint8_t seq;
+static uint8_t wire[COBS_MAX(FRAME_MAX) + 2];
+static uint16_t wire_len;       // quadro codificado esperando espaco
+static telem_stats stats;
+
+static inline uint8_t *put16(uint8_t *p, uint16_t v){
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	return p + 2;
+}
+
+static inline uint8_t *put32(uint8_t *p, uint32_t v){
+	p = put16(p, (uint16_t)v);
+	return put16(p, (uint16_t)(v >> 16));
+}
+
+//MANDA O QUADRO CODIFICADO SE O ANEL DA SERIAL TEM ESPACO PARA ELE INTEIRO
+static bool push_wire(void){
+	if (wire_len == 0){
+		return true;
+	}
+	if (line_room() < wire_len){
+		return false;
+	}
+	line_write(wire, wire_len);
+	stats.bytes += wire_len;
+	stats.frames++;
+	wire_len = 0;
+	return true;
+}
+
+//FECHA O QUADRO ABERTO: CRC, COBS E OS DOIS SEPARADORES
+static void close_frame(void){
+	if (used == 0 || wire_len != 0){
+		return;
+	}
+	put32(frame + used, crc32(frame, used));
+	used += 4;
+	wire[0] = 0;
+	wire_len = 1 + cobs_encode(frame, used, wire + 1);
+	wire[wire_len++] = 0;
+	used = 0;
+}
+
+//RESERVA len BYTES DE REGISTRO NO QUADRO; NULL SE NAO HA ONDE POR
+static uint8_t *reserve(uint8_t type, uint8_t len){
+	uint32_t now = clock_ms();
+
+	//QUADRO CHEIO OU dt ESTOURANDO 16 BITS: FECHA E TENTA MANDAR
+	if (used && (used + TELEM_REC_HEADER + len > FRAME_HEADER + TELEM_PAYLOAD_MAX || now - base_ms > 0xFFFF)){
+		close_frame();
+		push_wire();
+	}
+	if (used == 0){
+		if (wire_len != 0){
+			stats.dropped++;
+			return NULL;
+		}
+		base_ms = now;
+		frame[0] = seq++;
+		put32(frame + 1, base_ms);
+		used = FRAME_HEADER;
+	}
+	uint8_t *p = frame + used;
+	p[0] = type;
+	put16(p + 1, (uint16_t)(now - base_ms));
+	used += TELEM_REC_HEADER + len;
+	stats.records++;
+	return p + TELEM_REC_HEADER;
+}
+
+void telem_init(uint32_t (*now_ms)(void), uint16_t (*room)(void), uint16_t (*write)(const void *data, uint16_t len)){
+	clock_ms = now_ms;
+	line_room = room;
+	line_write = write;
+	used = 0;
+	wire_len = 0;
+	seq = 0;
+	memset(&stats, 0, sizeof(stats));
+}
+
+void telem_touch(uint8_t id, uint8_t status, uint16_t x, uint16_t y){
+	uint8_t *p = reserve(TELEM_TOUCH, 6);
+
+	if (p){
+		p[0] = id;
+		p[1] = status;
+		put16(put16(p + 2, x), y);
+	}
+}
+
+void telem_frame(uint32_t render_us){
+	uint8_t *p = reserve(TELEM_FRAME, 4);
+
+	if (p){
+		put32(p, render_us);
+	}
+}
+
+void telem_bus(uint32_t spi_bytes){
+	uint8_t *p = reserve(TELEM_BUS, 4);
+
+	if (p){
+		put32(p, spi_bytes);
+	}
+}
+
+void telem_phase(uint8_t cycle, uint8_t phase, uint8_t rinse, uint16_t seconds_left){
+	uint8_t *p = reserve(TELEM_PHASE, 5);
+
+	if (p){
+		p[0] = cycle;
+		p[1] = phase;
+		p[2] = rinse;
+		put16(p + 3, seconds_left);
+	}
+}
+
+void telem_queue(uint8_t queue, uint8_t depth, uint8_t high_water, uint32_t dropped){
+	uint8_t *p = reserve(TELEM_QUEUE, 7);
+
+	if (p){
+		p[0] = queue;
+		p[1] = depth;
+		p[2] = high_water;
+		put32(p + 3, dropped);
+	}
+}
+
+//len <= TELEM_PAYLOAD_MAX - TELEM_REC_HEADER - 1
+void telem_log(const uint8_t *record, uint8_t len){
+	uint8_t *p = reserve(TELEM_LOG, 1 + len);
+
+	if (p){
+		p[0] = len;
+		memcpy(p + 1, record, len);
+	}
+}
+
+void telem_overrun(uint32_t render_us, uint32_t flush_us, uint8_t call, uint32_t call_us){
+	uint8_t *p = reserve(TELEM_OVERRUN, 13);
+
+	if (p){
+		p = put32(put32(p, render_us), flush_us);
+		p[0] = call;
+		put32(p + 1, call_us);
+	}
+}
+
+//NO FIM DE CADA VOLTA DO LOOP: MANDA O QUE ESPERA E FECHA O QUADRO VELHO
+void telem_flush(void){
+	if (push_wire() && used && clock_ms() - base_ms >= TELEM_BATCH_MS){
+		close_frame();
+		push_wire();
+	}
+}
+
+void telem_get_stats(telem_stats *s){
+	*s = stats;
+}
@@ -0,0 +1,60 @@
+/*
+ * telemetry.h
+ *
+ * Telemetria binaria pela serial: registros tipados (toque, tempo de
+ * renderizacao, bytes no barramento do LCD, troca de fase, filas, log
+ * tokenizado, quadros da tela que estouraram o orcamento) juntados num quadro {seq, ms base, registros, CRC-32},
+ * codificado com COBS (cobs.h) e cercado por 0x00. Um quadro junta
+ * registros por ate TELEM_BATCH_MS (ou TELEM_PAYLOAD_MAX bytes), entao o
+ * custo fixo de ~11 bytes se divide entre muitos registros: ~10 bytes por
+ * registro na linha, >1000 registros/s a 115200 baud (sim/telem_sim.c).
+ * Nada espera a linha: o quadro so vai para o anel da serial se couber
+ * inteiro, senao fica para o proximo telem_flush(); registros que chegam
+ * com o quadro cheio e o anterior ainda esperando sao descartados.
+ * Decodificador no host: sim/telem_decode.c (gera CSV).
+ */
+
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TELEM_PAYLOAD_MAX  240
+#define TELEM_BATCH_MS     20    // idade maxima de um quadro aberto
+
+//REGISTRO: {tipo, dt (ms desde a base do quadro, 16 bits), campos little-endian}
+typedef enum {
+	TELEM_TOUCH = 1,   // id u8, status u8, x u16, y u16
+	TELEM_FRAME,       // render_us u32
+	TELEM_BUS,         // spi_bytes u32 (bytes para o LCD no quadro da tela)
+	TELEM_PHASE,       // ciclo u8, fase u8, enxague u8, segundos u16
+	TELEM_QUEUE,       // fila u8, profundidade u8, maximo u8, descartados u32
+	TELEM_LOG,         // tamanho u8, registros inteiros do tlog (tlog.h)
+	TELEM_OVERRUN,     // render_us u32, flush_us u32, chamada u8 (draw_calls.def), chamada_us u32
+	TELEM_TYPES
+} telem_type;
+
+#define TELEM_REC_HEADER  3
+
+typedef struct {
+	uint32_t records;
+	uint32_t frames;
+	uint32_t bytes;      // bytes na linha, com COBS e separadores
+	uint32_t dropped;    // registros que nao couberam
+} telem_stats;
+
+//now_ms: RELOGIO; room/write: O ANEL DA SERIAL (serial_tx_free/serial_tx_write)
+void telem_init(uint32_t (*now_ms)(void), uint16_t (*room)(void), uint16_t (*write)(const void *data, uint16_t len));
+void telem_touch(uint8_t id, uint8_t status, uint16_t x, uint16_t y);
+void telem_frame(uint32_t render_us);
+void telem_bus(uint32_t spi_bytes);
+void telem_phase(uint8_t cycle, uint8_t phase, uint8_t rinse, uint16_t seconds_left);
+void telem_queue(uint8_t queue, uint8_t depth, uint8_t high_water, uint32_t dropped);
+void telem_log(const uint8_t *record, uint8_t len);
+void telem_overrun(uint32_t render_us, uint32_t flush_us, uint8_t call, uint32_t call_us);
+void telem_flush(void);
+void telem_get_stats(telem_stats *stats);
+
+#endif /* TELEMETRY_H_ */
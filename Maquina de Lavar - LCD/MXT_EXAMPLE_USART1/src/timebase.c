@@ -0,0 +1,53 @@
+/*
+ * timebase.c
+ *
+ * O handler do alarme (main.c) so posta o evento; os callbacks rodam no
+ * main, em timebase_process(). O alarme vai para wheel_next(), que pode ser
+ * uma cascata da roda e nao um vencimento: um timer longo acorda no maximo
+ * uma vez por nivel antes do prazo. clock_init() vem antes, no boot.
+ */
+
+#include "timebase.h"
+
+static timer_wheel wheel;
+
+void timebase_init(void){
+	wheel_init(&wheel, clock_now_ms());
+}
+
+uint64_t timebase_now(void){
+	return clock_now_ms();
+}
+
+//WHEEL_NEVER == CLOCK_NO_ALARM: SEM TRABALHO, O RELOGIO SO CUIDA DE SI
+static void program_alarm(void){
+	clock_set_alarm(wheel_next(&wheel));
+}
+
+void timebase_start(timebase_timer *timer, uint64_t deadline_ms, timebase_callback callback){
+	uint64_t before = wheel_next(&wheel);
+
+	wheel_add(&wheel, timer, deadline_ms, callback);
+	if (wheel_next(&wheel) < before){
+		program_alarm();
+	}
+}
+
+void timebase_stop(timebase_timer *timer){
+	wheel_cancel(&wheel, timer);
+}
+
+bool timebase_armed(const timebase_timer *timer){
+	return timer->armed;
+}
+
+//CHAMA OS TIMERS VENCIDOS E REARMA O ALARME; O CALLBACK PODE REARMAR O TIMER
+void timebase_process(void){
+	wheel_run(&wheel, clock_now_ms());
+	program_alarm();
+
+	//O CONTADOR PODE TER PASSADO DO PRAZO ENQUANTO O ALARME ERA ESCRITO
+	if (wheel_next(&wheel) <= clock_now_ms()){
+		timebase_process();
+	}
+}
@@ -0,0 +1,30 @@
+/*
+ * timebase.h
+ *
+ * Timers de prazo absoluto (ms) sobre o clock_source. Os timers ficam numa
+ * roda hierarquica (timer_wheel.h); timebase_process(), no main, chama os
+ * que venceram e reprograma o unico alarme do relogio para o proximo
+ * trabalho da roda. Sem timer armado, nao ha interrupcao periodica. Nao
+ * depende do RTT, entao roda no host com o relogio virtual.
+ */
+
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "clock_source.h"
+#include "timer_wheel.h"
+
+typedef wheel_timer timebase_timer;
+typedef wheel_callback timebase_callback;
+
+void timebase_init(void);
+uint64_t timebase_now(void);
+void timebase_start(timebase_timer *timer, uint64_t deadline_ms, timebase_callback callback);
+void timebase_stop(timebase_timer *timer);
+bool timebase_armed(const timebase_timer *timer);
+void timebase_process(void);
+
+#endif /* TIMEBASE_H_ */
@@ -0,0 +1,162 @@
+/*
+ * timer_wheel.c
+ *
+ * Um timer vai para o menor nivel L em que o prazo e o "now" da roda tem os
+ * mesmos bits acima de 6*(L+1); o slot sao os 6 bits do prazo no nivel L.
+ * Assim todo slot ocupado esta adiante do indice atual do seu nivel, e o
+ * inicio do primeiro slot ocupado de cada nivel e o proximo instante com
+ * trabalho. Nesse instante um slot de nivel alto e redistribuido (cascata)
+ * para os niveis de baixo; um slot do nivel 0 vence.
+ */
+
+#include <stddef.h>
+#include "timer_wheel.h"
+
+#define LEVEL_SHIFT(l)  ((l) * WHEEL_BITS)
+#define OVERFLOW_SHIFT  (WHEEL_LEVELS * WHEEL_BITS)
+
+static void slot_link(wheel_timer **head, wheel_timer *t){
+	t->next = *head;
+	if (t->next){
+		t->next->pprev = &t->next;
+	}
+	t->pprev = head;
+	*head = t;
+}
+
+static void slot_unlink(timer_wheel *w, wheel_timer *t){
+	*t->pprev = t->next;
+	if (t->next){
+		t->next->pprev = t->pprev;
+	}
+	if (t->level < WHEEL_LEVELS && w->slots[t->level][t->slot] == NULL){
+		w->bitmap[t->level] &= ~(1ull << t->slot);
+	}
+	t->next = NULL;
+	t->pprev = NULL;
+}
+
+static void place(timer_wheel *w, wheel_timer *t){
+	uint64_t d = t->deadline > w->now ? t->deadline : w->now;
+
+	for (uint8_t l = 0; l < WHEEL_LEVELS; l++){
+		uint8_t up = LEVEL_SHIFT(l + 1);
+
+		if ((d >> up) == (w->now >> up)){
+			t->level = l;
+			t->slot = (d >> LEVEL_SHIFT(l)) & (WHEEL_SLOTS - 1);
+			slot_link(&w->slots[l][t->slot], t);
+			w->bitmap[l] |= 1ull << t->slot;
+			return;
+		}
+	}
+	t->level = WHEEL_LEVELS;
+	slot_link(&w->overflow, t);
+}
+
+void wheel_init(timer_wheel *w, uint64_t now_ms){
+	w->now = now_ms;
+	w->overflow = NULL;
+	for (uint8_t l = 0; l < WHEEL_LEVELS; l++){
+		w->bitmap[l] = 0;
+		for (uint8_t s = 0; s < WHEEL_SLOTS; s++){
+			w->slots[l][s] = NULL;
+		}
+	}
+}
+
+void wheel_add(timer_wheel *w, wheel_timer *t, uint64_t deadline_ms, wheel_callback callback){
+	wheel_cancel(w, t);
+	t->deadline = deadline_ms;
+	t->callback = callback;
+	t->armed = true;
+	place(w, t);
+}
+
+void wheel_cancel(timer_wheel *w, wheel_timer *t){
+	if (t->armed){
+		slot_unlink(w, t);
+		t->armed = false;
+	}
+}
+
+//INICIO DO PRIMEIRO SLOT OCUPADO DO NIVEL, A PARTIR DO INDICE ATUAL
+static uint64_t level_next(const timer_wheel *w, uint8_t l){
+	uint8_t shift = LEVEL_SHIFT(l);
+	uint8_t idx = (w->now >> shift) & (WHEEL_SLOTS - 1);
+	uint64_t pending = w->bitmap[l] & (~0ull << idx);
+
+	if (pending == 0){
+		return WHEEL_NEVER;
+	}
+	uint64_t base = (w->now >> LEVEL_SHIFT(l + 1)) << LEVEL_SHIFT(l + 1);
+	return base + ((uint64_t)__builtin_ctzll(pending) << shift);
+}
+
+static uint64_t overflow_next(const timer_wheel *w){
+	if (w->overflow == NULL){
+		return WHEEL_NEVER;
+	}
+	return ((w->now >> OVERFLOW_SHIFT) + 1) << OVERFLOW_SHIFT;
+}
+
+//PROXIMO INSTANTE EM QUE wheel_run() TEM TRABALHO (VENCIMENTO OU CASCATA)
+uint64_t wheel_next(const timer_wheel *w){
+	uint64_t next = overflow_next(w);
+
+	for (uint8_t l = 0; l < WHEEL_LEVELS; l++){
+		uint64_t t = level_next(w, l);
+		if (t < next){
+			next = t;
+		}
+	}
+	return next;
+}
+
+//REDISTRIBUI O SLOT (OU O ESTOURO, level = WHEEL_LEVELS) RELATIVO AO NOVO
+//now; A LISTA E SOLTA ANTES PORQUE UM PRAZO LONGO VOLTA PARA O ESTOURO
+static void cascade(timer_wheel *w, uint8_t level, uint8_t slot){
+	wheel_timer **head = level < WHEEL_LEVELS ? &w->slots[level][slot] : &w->overflow;
+	wheel_timer *t = *head;
+
+	*head = NULL;
+	if (level < WHEEL_LEVELS){
+		w->bitmap[level] &= ~(1ull << slot);
+	}
+	while (t != NULL){
+		wheel_timer *next = t->next;
+		place(w, t);
+		t = next;
+	}
+}
+
+void wheel_run(timer_wheel *w, uint64_t now_ms){
+	uint64_t t;
+
+	while ((t = wheel_next(w)) <= now_ms){
+		//A FRONTEIRA DO ESTOURO E RELATIVA AO now ANTIGO
+		bool overflow = overflow_next(w) == t;
+
+		w->now = t;
+		if (overflow){
+			cascade(w, WHEEL_LEVELS, 0);
+		}
+		for (uint8_t l = WHEEL_LEVELS - 1; l > 0; l--){
+			if (level_next(w, l) == t){
+				cascade(w, l, (t >> LEVEL_SHIFT(l)) & (WHEEL_SLOTS - 1));
+			}
+		}
+
+		//O CALLBACK PODE ARMAR OU CANCELAR TIMERS, INCLUSIVE NESTE SLOT
+		wheel_timer **slot = &w->slots[0][t & (WHEEL_SLOTS - 1)];
+		wheel_timer *e;
+		while ((e = *slot) != NULL){
+			slot_unlink(w, e);
+			e->armed = false;
+			e->callback(e);
+		}
+	}
+	if (now_ms > w->now){
+		w->now = now_ms;
+	}
+}
@@ -0,0 +1,50 @@
+/*
+ * timer_wheel.h
+ *
+ * Roda de timers hierarquica: 4 niveis de 64 slots de 1 ms, 64 ms, 4 s e
+ * 4,4 min (alcance de ~4,6 h; prazos mais longos ficam numa lista de
+ * estouro). Inserir e cancelar sao O(1) e wheel_next() acha o proximo
+ * trabalho pelos bitmaps dos niveis, entao nao existe tick periodico: quem
+ * usa programa um unico alarme para wheel_next() e chama wheel_run().
+ * O tempo (ms absoluto) vem de quem chama.
+ */
+
+
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define WHEEL_LEVELS  4
+#define WHEEL_BITS    6
+#define WHEEL_SLOTS   (1 << WHEEL_BITS)
+#define WHEEL_NEVER   UINT64_MAX
+
+typedef struct wheel_timer wheel_timer;
+typedef void (*wheel_callback)(wheel_timer *timer);
+
+struct wheel_timer {
+	uint64_t deadline;        // ms absoluto
+	wheel_callback callback;
+	wheel_timer *next;        // lista do slot
+	wheel_timer **pprev;      // quem aponta para este timer, para cancelar em O(1)
+	uint8_t level;            // WHEEL_LEVELS = lista de estouro
+	uint8_t slot;
+	bool armed;
+};
+
+typedef struct {
+	uint64_t now;             // ate onde a roda ja foi processada
+	uint64_t bitmap[WHEEL_LEVELS];
+	wheel_timer *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+	wheel_timer *overflow;
+} timer_wheel;
+
+void wheel_init(timer_wheel *wheel, uint64_t now_ms);
+void wheel_add(timer_wheel *wheel, wheel_timer *timer, uint64_t deadline_ms, wheel_callback callback);
+void wheel_cancel(timer_wheel *wheel, wheel_timer *timer);
+uint64_t wheel_next(const timer_wheel *wheel);
+void wheel_run(timer_wheel *wheel, uint64_t now_ms);
+
+#endif /* TIMER_WHEEL_H_ */
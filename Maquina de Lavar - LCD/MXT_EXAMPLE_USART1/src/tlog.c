@@ -0,0 +1,62 @@
+/*
+ * tlog.c
+ *
+ * Lado do consumidor: tlog_drain() copia so registros inteiros, em bytes
+ * little-endian, e so depois libera o tail. Os produtores escrevem com as
+ * interrupcoes mascaradas, entao o head publicado sempre fecha um registro.
+ */
+
+#include <string.h>
+#include "tlog.h"
+
+#ifdef HOST_BUILD
+#define barrier()   __atomic_thread_fence(__ATOMIC_SEQ_CST)
+uint32_t tlog_sim_cycles;
+#endif
+
+#define MASK  (TLOG_WORDS - 1)
+
+tlog_ring tlog;
+
+//O CONTADOR DE CICLOS E O prof_ticks(), LIGADO PELO prof_init()
+void tlog_init(void){
+	tlog.head = 0;
+	tlog.tail = 0;
+	tlog.records = 0;
+	tlog.dropped = 0;
+}
+
+//COPIA REGISTROS INTEIROS ATE max BYTES; DEVOLVE QUANTOS BYTES
+uint16_t tlog_drain(void *out, uint16_t max){
+	uint8_t *p = out;
+	uint16_t tail = tlog.tail;
+	uint16_t head = tlog.head;
+	uint16_t used = 0;
+
+	barrier();
+	while (tail != head){
+		uint16_t words = 2 + ((tlog.buf[tail] >> 16) & 0xFF);
+
+		if (used + words * 4u > max){
+			break;
+		}
+		for (uint16_t i = 0; i < words; i++){
+			memcpy(p + used, &tlog.buf[(tail + i) & MASK], 4);
+			used += 4;
+		}
+		tail = (tail + words) & MASK;
+	}
+	barrier();
+	tlog.tail = tail;
+	return used;
+}
+
+bool tlog_empty(void){
+	return tlog.head == tlog.tail;
+}
+
+void tlog_get_stats(tlog_stats *stats){
+	stats->depth = (tlog.head - tlog.tail) & MASK;
+	stats->records = tlog.records;
+	stats->dropped = tlog.dropped;
+}
@@ -0,0 +1,98 @@
+/*
+ * tlog.h
+ *
+ * Log tokenizado: em vez de formatar texto, cada chamada grava num anel de
+ * palavras o id da mensagem (tlog_msgs.def), o contador de ciclos e ate 4
+ * argumentos crus. Sao algumas dezenas de ciclos, sem printf nem string no
+ * firmware; o main esvazia o anel em registros TELEM_LOG da telemetria
+ * (telemetry.h) e o host refaz o texto (sim/telem_decode.c, ou o
+ * sim/tlog_decode.c para os bytes crus). Pode ser chamado de interrupcao.
+ *
+ * Registro: {TLOG_MAGIC<<24 | nargs<<16 | id, ciclos, args...}
+ */
+
+
+#ifndef TLOG_H_
+#define TLOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef HOST_BUILD
+#include <compiler.h>
+#include "prof.h"
+#endif
+
+#define TLOG_WORDS    512   // potencia de 2
+#define TLOG_MAGIC    0xA5u
+#define TLOG_MAX_ARGS 4
+
+typedef enum {
+#define TLOG_MSG(id, fmt) TLOG_##id,
+#include "tlog_msgs.def"
+#undef TLOG_MSG
+	TLOG_COUNT
+} tlog_id;
+
+typedef struct {
+	uint32_t buf[TLOG_WORDS];
+	volatile uint16_t head;   // produtores, com interrupcoes mascaradas
+	volatile uint16_t tail;   // so tlog_drain()
+	uint32_t records;
+	uint32_t dropped;
+} tlog_ring;
+
+typedef struct {
+	uint16_t depth;           // palavras no anel
+	uint32_t records;
+	uint32_t dropped;
+} tlog_stats;
+
+extern tlog_ring tlog;
+
+#ifdef HOST_BUILD
+extern uint32_t tlog_sim_cycles;
+static inline uint32_t tlog_cycles(void){ return tlog_sim_cycles; }
+static inline uint32_t tlog_lock(void){ return 0; }
+static inline void tlog_unlock(uint32_t m){ (void)m; }
+#else
+static inline uint32_t tlog_cycles(void){ return prof_ticks(); }
+static inline uint32_t tlog_lock(void){ uint32_t m = __get_PRIMASK(); __disable_irq(); return m; }
+static inline void tlog_unlock(uint32_t m){ __set_PRIMASK(m); }
+#endif
+
+//COM n CONSTANTE O COMPILADOR DESENROLA; ANEL CHEIO DESCARTA O REGISTRO
+static inline __attribute__((always_inline))
+void tlog_emit(uint16_t id, uint8_t n, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3){
+	const uint16_t mask = TLOG_WORDS - 1;
+	uint32_t m = tlog_lock();
+	uint16_t head = tlog.head;
+
+	if (((tlog.tail - head - 1) & mask) < 2u + n){
+		tlog.dropped++;
+	} else {
+		uint32_t *w = tlog.buf;
+		w[head] = (TLOG_MAGIC << 24) | ((uint32_t)n << 16) | id;  head = (head + 1) & mask;
+		w[head] = tlog_cycles();                                 head = (head + 1) & mask;
+		if (n > 0){ w[head] = a0; head = (head + 1) & mask; }
+		if (n > 1){ w[head] = a1; head = (head + 1) & mask; }
+		if (n > 2){ w[head] = a2; head = (head + 1) & mask; }
+		if (n > 3){ w[head] = a3; head = (head + 1) & mask; }
+		tlog.head = head;
+		tlog.records++;
+	}
+	tlog_unlock(m);
+}
+
+#define TLOG(id)                 tlog_emit(TLOG_##id, 0, 0, 0, 0, 0)
+#define TLOG1(id, a)             tlog_emit(TLOG_##id, 1, (uint32_t)(a), 0, 0, 0)
+#define TLOG2(id, a, b)          tlog_emit(TLOG_##id, 2, (uint32_t)(a), (uint32_t)(b), 0, 0)
+#define TLOG3(id, a, b, c)       tlog_emit(TLOG_##id, 3, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), 0)
+#define TLOG4(id, a, b, c, d)    tlog_emit(TLOG_##id, 4, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d))
+
+void tlog_init(void);
+uint16_t tlog_drain(void *out, uint16_t max);
+bool tlog_empty(void);
+void tlog_get_stats(tlog_stats *stats);
+
+#endif /* TLOG_H_ */
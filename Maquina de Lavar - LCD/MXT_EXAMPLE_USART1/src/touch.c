@@ -0,0 +1,174 @@
+/*
+ * touch.c
+ *
+ * A configuracao dos objetos e a leitura da fila sao as do exemplo do ASF;
+ * cada mensagem passa pela calibracao, pelo gesture.c e sai na telemetria,
+ * com as marcas de latencia de cada etapa. No host o clock_source e o
+ * sim/clock_sim.c e o TWIHS e o sim/mxt_sim.c.
+ */
+
+#include <asf.h>
+#include "touch.h"
+#include "screens.h"
+#include "gesture.h"
+#include "latency.h"
+#include "telemetry.h"
+#include "tlog.h"
+#include "prof.h"
+#include "tcm.h"
+#include "clock_source.h"
+#include "conf_example.h"
+
+#define MAX_ENTRIES  3
+
+static const touch_calib *touch_map;
+static uint32_t (*now_ms)(void);
+
+void touch_init(const touch_calib *map, uint32_t (*clock)(void)){
+	touch_map = map;
+	now_ms = clock;
+}
+
+/**
+ * \brief Set maXTouch configuration
+ *
+ * This function writes a set of predefined, optimal maXTouch configuration data
+ * to the maXTouch Xplained Pro.
+ *
+ * \param device Pointer to mxt_device struct
+ */
+void touch_device_init(struct mxt_device *device)
+{
+	enum status_code status;
+
+	/* T8 configuration object data */
+	uint8_t t8_object[] = {
+		0x0d, 0x00, 0x05, 0x0a, 0x4b, 0x00, 0x00,
+		0x00, 0x32, 0x19
+	};
+
+	/* T9 configuration object data */
+	uint8_t t9_object[] = {
+		0x8B, 0x00, 0x00, 0x0E, 0x08, 0x00, 0x80,
+		0x32, 0x05, 0x02, 0x0A, 0x03, 0x03, 0x20,
+		0x02, 0x0F, 0x0F, 0x0A, 0x00, 0x00, 0x00,
+		0x00, 0x18, 0x18, 0x20, 0x20, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x02,
+		0x02
+	};
+
+	/* T46 configuration object data */
+	uint8_t t46_object[] = {
+		0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x03,
+		0x00, 0x00
+	};
+	
+	/* T56 configuration object data */
+	uint8_t t56_object[] = {
+		0x02, 0x00, 0x01, 0x18, 0x1E, 0x1E, 0x1E,
+		0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E,
+		0x1E, 0x1E, 0x1E, 0x1E, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00
+	};
+
+	/* Initialize the maXTouch device */
+	status = mxt_init_device(device, MAXTOUCH_TWI_INTERFACE,
+			MAXTOUCH_TWI_ADDRESS, MAXTOUCH_XPRO_CHG_PIO);
+	Assert(status == STATUS_OK);
+
+	/* Issue soft reset of maXTouch device by writing a non-zero value to
+	 * the reset register */
+	mxt_write_config_reg(device, mxt_get_object_address(device,
+			MXT_GEN_COMMANDPROCESSOR_T6, 0)
+			+ MXT_GEN_COMMANDPROCESSOR_RESET, 0x01);
+
+	/* Wait for the reset of the device to complete */
+	clock_sleep_until(clock_now_ms() + MXT_RESET_TIME);
+
+	/* Write data to configuration registers in T7 configuration object */
+	mxt_write_config_reg(device, mxt_get_object_address(device,
+			MXT_GEN_POWERCONFIG_T7, 0) + 0, 0x20);
+	mxt_write_config_reg(device, mxt_get_object_address(device,
+			MXT_GEN_POWERCONFIG_T7, 0) + 1, 0x10);
+	mxt_write_config_reg(device, mxt_get_object_address(device,
+			MXT_GEN_POWERCONFIG_T7, 0) + 2, 0x4b);
+	mxt_write_config_reg(device, mxt_get_object_address(device,
+			MXT_GEN_POWERCONFIG_T7, 0) + 3, 0x84);
+
+	/* Write predefined configuration data to configuration objects */
+	mxt_write_config_object(device, mxt_get_object_address(device,
+			MXT_GEN_ACQUISITIONCONFIG_T8, 0), &t8_object);
+	mxt_write_config_object(device, mxt_get_object_address(device,
+			MXT_TOUCH_MULTITOUCHSCREEN_T9, 0), &t9_object);
+	mxt_write_config_object(device, mxt_get_object_address(device,
+			MXT_SPT_CTE_CONFIGURATION_T46, 0), &t46_object);
+	mxt_write_config_object(device, mxt_get_object_address(device,
+			MXT_PROCI_SHIELDLESS_T56, 0), &t56_object);
+
+	/* Issue recalibration command to maXTouch device by writing a non-zero
+	 * value to the calibrate register */
+	mxt_write_config_reg(device, mxt_get_object_address(device,
+			MXT_GEN_COMMANDPROCESSOR_T6, 0)
+			+ MXT_GEN_COMMANDPROCESSOR_CALIBRATE, 0x01);
+}
+
+static ITCM_FUNC void mxt_handler(struct mxt_device *device)
+{
+	uint8_t i = 0; /* Iterator */
+
+	/* Temporary touch event data struct */
+	struct mxt_touch_event touch_event;
+
+	PROF_BEGIN(MXT_HANDLER);
+
+	/* Collect touch events, maximum MAX_ENTRIES at the time */
+	do {
+		/* Read next next touch event in the queue, discard if read fails */
+		if (mxt_read_touch_event(device, &touch_event) != STATUS_OK) {
+			continue;
+		}
+		latency_mark(LAT_TWI);
+		
+		uint16_t conv_x, conv_y;
+		touch_calib_apply(touch_map, touch_event.x, touch_event.y, &conv_x, &conv_y);
+		
+		//printf("%d", conv_x);
+		//printf("%d", conv_y);
+		//printf("\nstatus do evento: %d",touch_event.status);
+		gesture_feed(touch_event.id, touch_event.status, conv_x, conv_y, now_ms());
+		
+		/* Registro binario de telemetria: o host gera o CSV (sim/telem_decode.c) */
+		telem_touch(touch_event.id, touch_event.status, conv_x, conv_y);
+		i++;
+
+		/* Check if there is still messages in the queue and
+		 * if we have reached the maximum numbers of events */
+	} while ((mxt_is_message_pending(device)) & (i < MAX_ENTRIES));
+	PROF_END(MXT_HANDLER);
+}
+
+//mxt_handler() LE NO MAXIMO MAX_ENTRIES; O CHG CONTINUA BAIXO SEM NOVA BORDA,
+//ENTAO A PROXIMA LEVA COMECA QUANDO A ANTERIOR TERMINA. chg_stamp: latency_now() DA BORDA
+void touch_read(struct mxt_device *device, uint32_t chg_stamp){
+	while (mxt_is_message_pending(device)){
+		latency_mark_at(LAT_CHG, chg_stamp);
+		mxt_handler(device);
+		chg_stamp = latency_now();
+	}
+}
+
+//BUSCA O BOTAO PELO INDICE ESPACIAL, SEM VARRER A TABELA
+int touch_buttons(const touch_grid *grid, uint8_t size, uint8_t locked, uint16_t xTouch, uint16_t yTouch){
+	int i = touch_grid_find(grid, xTouch, yTouch);
+	latency_mark(LAT_HIT);
+
+	if (i == TOUCH_GRID_NONE){
+		return size + 1;
+	}
+	TLOG1(TOQUE_BOTAO, i);
+	if(locked && i != BUT_LOCK){
+		return size+1;
+	}
+	return i;
+}
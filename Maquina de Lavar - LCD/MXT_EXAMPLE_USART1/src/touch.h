@@ -0,0 +1,28 @@
+/*
+ * touch.h
+ *
+ * Caminho do toque do maXTouch, da borda do CHG ate o botao: configura os
+ * objetos do chip, le a fila de mensagens em levas de MAX_ENTRIES
+ * (mxt_read_touch_event()), aplica a calibracao e entrega ao gesture.c; o
+ * callback dos gestos acha o botao com touch_buttons(). O barramento TWIHS
+ * e a interrupcao do CHG ficam no main. O mesmo codigo roda no host sobre
+ * o modelo do chip (sim/touch_sim.c com sim/mxt_sim.c).
+ */
+
+
+#ifndef TOUCH_H_
+#define TOUCH_H_
+
+#include <stdint.h>
+#include "touch_calib.h"
+#include "touch_grid.h"
+
+struct mxt_device;
+
+//map: MATRIZ DO TOQUE (O MAIN TROCA O CONTEUDO NA CALIBRACAO); now_ms: RELOGIO DOS GESTOS
+void touch_init(const touch_calib *map, uint32_t (*now_ms)(void));
+void touch_device_init(struct mxt_device *device);
+void touch_read(struct mxt_device *device, uint32_t chg_stamp);
+int touch_buttons(const touch_grid *grid, uint8_t size, uint8_t locked, uint16_t xTouch, uint16_t yTouch);
+
+#endif /* TOUCH_H_ */
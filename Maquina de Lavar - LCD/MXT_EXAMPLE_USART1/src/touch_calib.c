@@ -0,0 +1,105 @@
+/*
+ * touch_calib.c
+ *
+ * Calculo da matriz de calibracao (3 pontos) e composicao com a orientacao
+ * do LCD. So roda na calibracao ou na troca de orientacao; o caminho do
+ * toque usa apenas touch_calib_apply().
+ */
+
+#include "touch_calib.h"
+
+//MATRIZ NOMINAL DO PAINEL NA ORIENTACAO 0 (PAISAGEM), SEM CORRECAO DE OFFSET
+void touch_calib_nominal(touch_calib *m, uint16_t width, uint16_t height){
+	// x_tela = W*x/4096, y_tela = H - H*y/4096
+	m->a = ((int32_t)width << TOUCH_CALIB_SHIFT) / TOUCH_RAW_RANGE;
+	m->b = 0;
+	m->c = 0;
+	m->d = 0;
+	m->e = -(((int32_t)height << TOUCH_CALIB_SHIFT) / TOUCH_RAW_RANGE);
+	m->f = (int32_t)height << TOUCH_CALIB_SHIFT;
+	m->width = width;
+	m->height = height;
+}
+
+//RESOLVE A MATRIZ AFIM A PARTIR DE 3 PONTOS (CRU -> TELA), 0 SE DEGENERADO
+int touch_calib_compute(touch_calib *m, const touch_point raw[3], const touch_point screen[3]){
+	int64_t x0 = raw[0].x, y0 = raw[0].y;
+	int64_t x1 = raw[1].x, y1 = raw[1].y;
+	int64_t x2 = raw[2].x, y2 = raw[2].y;
+	int64_t X0 = screen[0].x, X1 = screen[1].x, X2 = screen[2].x;
+	int64_t Y0 = screen[0].y, Y1 = screen[1].y, Y2 = screen[2].y;
+
+	int64_t det = (x0 - x2) * (y1 - y2) - (x1 - x2) * (y0 - y2);
+	if (det == 0){
+		return 0;
+	}
+
+	int64_t a = (((X0 - X2) * (y1 - y2) - (X1 - X2) * (y0 - y2)) * (1 << TOUCH_CALIB_SHIFT)) / det;
+	int64_t b = (((x0 - x2) * (X1 - X2) - (X0 - X2) * (x1 - x2)) * (1 << TOUCH_CALIB_SHIFT)) / det;
+	int64_t d = (((Y0 - Y2) * (y1 - y2) - (Y1 - Y2) * (y0 - y2)) * (1 << TOUCH_CALIB_SHIFT)) / det;
+	int64_t e = (((x0 - x2) * (Y1 - Y2) - (Y0 - Y2) * (x1 - x2)) * (1 << TOUCH_CALIB_SHIFT)) / det;
+
+	m->a = a;
+	m->b = b;
+	m->c = (X0 << TOUCH_CALIB_SHIFT) - a * x0 - b * y0;
+	m->d = d;
+	m->e = e;
+	m->f = (Y0 << TOUCH_CALIB_SHIFT) - d * x0 - e * y0;
+	return 1;
+}
+
+static void swap_xy(touch_calib *m){
+	touch_calib t = *m;
+
+	m->a = t.d;
+	m->b = t.e;
+	m->c = t.f;
+	m->d = t.a;
+	m->e = t.b;
+	m->f = t.c;
+	m->width = t.height;
+	m->height = t.width;
+}
+
+static void flip_x(touch_calib *m){
+	m->a = -m->a;
+	m->b = -m->b;
+	m->c = ((int32_t)(m->width - 1) << TOUCH_CALIB_SHIFT) - m->c;
+}
+
+static void flip_y(touch_calib *m){
+	m->d = -m->d;
+	m->e = -m->e;
+	m->f = ((int32_t)(m->height - 1) << TOUCH_CALIB_SHIFT) - m->f;
+}
+
+//DERIVA A MATRIZ DO TOQUE PARA AS FLAGS DE ORIENTACAO DO LCD
+//(primeiro troca os eixos, depois espelha no novo sistema)
+void touch_calib_orient(const touch_calib *panel, uint8_t flags, touch_calib *out){
+	*out = *panel;
+
+	if (flags & TOUCH_SWITCH_XY){
+		swap_xy(out);
+	}
+	if (flags & TOUCH_FLIP_X){
+		flip_x(out);
+	}
+	if (flags & TOUCH_FLIP_Y){
+		flip_y(out);
+	}
+}
+
+//CAMINHO INVERSO: MATRIZ MEDIDA NUMA ORIENTACAO -> MATRIZ DO PAINEL
+void touch_calib_to_panel(const touch_calib *m, uint8_t flags, touch_calib *panel){
+	*panel = *m;
+
+	if (flags & TOUCH_FLIP_Y){
+		flip_y(panel);
+	}
+	if (flags & TOUCH_FLIP_X){
+		flip_x(panel);
+	}
+	if (flags & TOUCH_SWITCH_XY){
+		swap_xy(panel);
+	}
+}
@@ -0,0 +1,52 @@
+/*
+ * touch_calib.h
+ *
+ * Calibracao afim do touch em ponto fixo Q16:
+ *   x_tela = (a*x + b*y + c) >> 16
+ *   y_tela = (d*x + e*y + f) >> 16
+ * A matriz do painel vale para a orientacao 0 de ili9488_set_orientation();
+ * a matriz usada no toque e derivada dela a partir das flags de orientacao.
+ */
+
+
+#ifndef TOUCH_CALIB_H_
+#define TOUCH_CALIB_H_
+
+#include <stdint.h>
+
+#define TOUCH_CALIB_SHIFT   16
+#define TOUCH_RAW_RANGE     4096
+
+/* Flags de orientacao (mesmos valores de ili9488.h) */
+#define TOUCH_FLIP_X        1
+#define TOUCH_FLIP_Y        2
+#define TOUCH_SWITCH_XY     4
+
+typedef struct {
+	int32_t a, b, c;
+	int32_t d, e, f;
+	uint16_t width;   // dimensoes da tela nessa orientacao
+	uint16_t height;
+} touch_calib;
+
+typedef struct {
+	uint16_t x;
+	uint16_t y;
+} touch_point;
+
+void touch_calib_nominal(touch_calib *m, uint16_t width, uint16_t height);
+int touch_calib_compute(touch_calib *m, const touch_point raw[3], const touch_point screen[3]);
+void touch_calib_orient(const touch_calib *panel, uint8_t flags, touch_calib *out);
+void touch_calib_to_panel(const touch_calib *m, uint8_t flags, touch_calib *panel);
+
+//APLICA A MATRIZ, SO MULTIPLICACOES E SHIFT
+static inline void touch_calib_apply(const touch_calib *m, uint16_t rx, uint16_t ry,
+		uint16_t *sx, uint16_t *sy){
+	int32_t x = (m->a * rx + m->b * ry + m->c) >> TOUCH_CALIB_SHIFT;
+	int32_t y = (m->d * rx + m->e * ry + m->f) >> TOUCH_CALIB_SHIFT;
+
+	*sx = x < 0 ? 0 : (x >= m->width ? m->width - 1 : x);
+	*sy = y < 0 ? 0 : (y >= m->height ? m->height - 1 : y);
+}
+
+#endif /* TOUCH_CALIB_H_ */
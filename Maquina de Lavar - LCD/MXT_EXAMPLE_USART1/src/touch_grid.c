@@ -0,0 +1,58 @@
+/*
+ * touch_grid.c
+ *
+ * Monta o indice uma vez a partir da tabela de widgets; a busca por toque
+ * e O(1): uma celula e, em geral, um unico teste de caixa.
+ */
+
+#include <string.h>
+#include "touch_grid.h"
+
+static uint16_t clamp_col(uint16_t x){
+	uint16_t c = x >> TOUCH_GRID_SHIFT;
+	return c < TOUCH_GRID_COLS ? c : TOUCH_GRID_COLS - 1;
+}
+
+static uint16_t clamp_row(uint16_t y){
+	uint16_t r = y >> TOUCH_GRID_SHIFT;
+	return r < TOUCH_GRID_ROWS ? r : TOUCH_GRID_ROWS - 1;
+}
+
+void touch_grid_build(touch_grid *grid, const hit_box *boxes, uint8_t size){
+	if (size > TOUCH_GRID_MAX_WIDGETS){
+		size = TOUCH_GRID_MAX_WIDGETS;
+	}
+
+	grid->boxes = boxes;
+	grid->size = size;
+	memset(grid->cells, 0, sizeof(grid->cells));
+
+	for (uint8_t i = 0; i < size; i++){
+		uint16_t c0 = clamp_col(boxes[i].x0);
+		uint16_t c1 = clamp_col(boxes[i].x1);
+		uint16_t r0 = clamp_row(boxes[i].y0);
+		uint16_t r1 = clamp_row(boxes[i].y1);
+
+		for (uint16_t r = r0; r <= r1; r++){
+			for (uint16_t c = c0; c <= c1; c++){
+				grid->cells[r][c] |= (1ul << i);
+			}
+		}
+	}
+}
+
+//RETORNA O INDICE DO WIDGET TOCADO OU TOUCH_GRID_NONE
+int touch_grid_find(const touch_grid *grid, uint16_t x, uint16_t y){
+	uint32_t mask = grid->cells[clamp_row(y)][clamp_col(x)];
+
+	while (mask){
+		int i = __builtin_ctz(mask);
+		const hit_box *b = &grid->boxes[i];
+
+		if (x >= b->x0 && x <= b->x1 && y >= b->y0 && y <= b->y1){
+			return i;
+		}
+		mask &= mask - 1;
+	}
+	return TOUCH_GRID_NONE;
+}
@@ -0,0 +1,38 @@
+/*
+ * touch_grid.h
+ *
+ * Indice espacial para o hit-test do touch. A tela (320x480) e dividida em
+ * celulas de 32x32 px e cada celula guarda uma mascara com os widgets que a
+ * cobrem, entao um toque testa so os poucos widgets da sua celula.
+ */
+
+
+#ifndef TOUCH_GRID_H_
+#define TOUCH_GRID_H_
+
+#include <stdint.h>
+
+#define TOUCH_GRID_SHIFT        5
+#define TOUCH_GRID_COLS         (320 >> TOUCH_GRID_SHIFT)
+#define TOUCH_GRID_ROWS         (480 >> TOUCH_GRID_SHIFT)
+#define TOUCH_GRID_MAX_WIDGETS  32
+#define TOUCH_GRID_NONE         (-1)
+
+//CAIXA DE TOQUE, LIMITES INCLUSIVOS
+typedef struct {
+	uint16_t x0;
+	uint16_t y0;
+	uint16_t x1;
+	uint16_t y1;
+} hit_box;
+
+typedef struct {
+	const hit_box *boxes;
+	uint8_t size;
+	uint32_t cells[TOUCH_GRID_ROWS][TOUCH_GRID_COLS];
+} touch_grid;
+
+void touch_grid_build(touch_grid *grid, const hit_box *boxes, uint8_t size);
+int touch_grid_find(const touch_grid *grid, uint16_t x, uint16_t y);
+
+#endif /* TOUCH_GRID_H_ */
@@ -0,0 +1,104 @@
+/*
+ * tx_ring.c
+ *
+ * Mesmo protocolo da event_queue: o produtor grava os bytes e so depois
+ * publica o head, o consumidor le o byte e so depois libera o tail. No
+ * TX_BLOCK, wait() e chamado enquanto nao ha espaco (no alvo, garante que
+ * a interrupcao esta ligada e espera); no TX_DROP_OLDEST o tail anda pelo
+ * produtor, entao quem chama tem que segurar a interrupcao enquanto isso.
+ */
+
+#include "tx_ring.h"
+
+#ifdef HOST_BUILD
+#define barrier()   __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#include <compiler.h>   // barrier() = __DMB()
+#endif
+
+static inline uint16_t space(const tx_ring *r){
+	return (r->tail - r->head - 1) & r->mask;
+}
+
+//CHAMADO SO PELO PRODUTOR; DEVOLVE QUANTOS BYTES ENTRARAM
+uint16_t tx_ring_write(tx_ring *r, const void *data, uint16_t len, void (*wait)(void)){
+	const uint8_t *p = data;
+	uint16_t done = 0;
+
+	while (done < len){
+		uint16_t free = space(r);
+
+		if (free == 0){
+			if (r->policy == TX_BLOCK && wait){
+				r->blocked++;
+				while (space(r) == 0){
+					wait();
+				}
+				continue;
+			}
+			if (r->policy == TX_DROP_OLDEST){
+				uint16_t room = len - done < r->mask ? len - done : r->mask;
+				r->tail = (r->tail + room) & r->mask;
+				r->dropped += room;
+				continue;
+			}
+			r->dropped += len - done;
+			break;
+		}
+
+		//COPIA ATE O FIM DO BUFFER OU DO ESPACO LIVRE, O QUE VIER ANTES
+		uint16_t head = r->head;
+		uint16_t n = len - done;
+		uint16_t to_end = r->mask + 1 - head;
+		if (n > free){
+			n = free;
+		}
+		if (n > to_end){
+			n = to_end;
+		}
+		for (uint16_t i = 0; i < n; i++){
+			r->buf[head + i] = p[done + i];
+		}
+		barrier();
+		r->head = (head + n) & r->mask;
+		done += n;
+	}
+	r->written += done;
+
+	uint16_t depth = (r->head - r->tail) & r->mask;
+	if (depth > r->high_water){
+		r->high_water = depth;
+	}
+	return done;
+}
+
+//CHAMADO SO PELO CONSUMIDOR (A INTERRUPCAO DA UART)
+bool tx_ring_pop(tx_ring *r, uint8_t *c){
+	uint16_t tail = r->tail;
+
+	if (tail == r->head){
+		return false;
+	}
+	barrier();
+	*c = r->buf[tail];
+	barrier();
+	r->tail = (tail + 1) & r->mask;
+	return true;
+}
+
+bool tx_ring_empty(const tx_ring *r){
+	return r->head == r->tail;
+}
+
+uint16_t tx_ring_free(const tx_ring *r){
+	return space(r);
+}
+
+void tx_ring_get_stats(const tx_ring *r, tx_ring_stats *stats){
+	stats->depth = (r->head - r->tail) & r->mask;
+	stats->capacity = r->mask;
+	stats->high_water = r->high_water;
+	stats->written = r->written;
+	stats->dropped = r->dropped;
+	stats->blocked = r->blocked;
+}
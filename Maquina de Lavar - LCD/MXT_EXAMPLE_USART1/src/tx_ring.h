@@ -0,0 +1,57 @@
+/*
+ * tx_ring.h
+ *
+ * Anel de bytes para a transmissao serial: o main escreve, a interrupcao
+ * da UART consome. Com o anel cheio vale a politica escolhida na criacao:
+ * descartar o byte novo, descartar o mais antigo ou esperar a interrupcao
+ * abrir espaco. Conta bytes aceitos, descartados e esperas.
+ */
+
+
+#ifndef TX_RING_H_
+#define TX_RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tcm.h"
+
+typedef enum {
+	TX_DROP_NEWEST,   // o que nao cabe se perde (nao precisa travar nada)
+	TX_DROP_OLDEST,   // abre espaco no inicio; quem chama exclui o consumidor
+	TX_BLOCK          // espera o consumidor; nunca chamar com ele parado
+} tx_policy;
+
+typedef struct {
+	const char *name;
+	uint8_t *buf;
+	uint16_t mask;           // capacidade - 1, capacidade potencia de 2
+	uint8_t policy;          // tx_policy
+	volatile uint16_t head;  // so o produtor escreve
+	volatile uint16_t tail;  // so o consumidor escreve (e o TX_DROP_OLDEST)
+	uint16_t high_water;
+	uint32_t written;
+	uint32_t dropped;
+	uint32_t blocked;        // vezes que o produtor esperou espaco
+} tx_ring;
+
+typedef struct {
+	uint16_t depth;
+	uint16_t capacity;
+	uint16_t high_water;
+	uint32_t written;
+	uint32_t dropped;
+	uint32_t blocked;
+} tx_ring_stats;
+
+//CRIA O ANEL E O BUFFER; size TEM QUE SER POTENCIA DE 2 (ATE 32768)
+#define TX_RING_DEFINE(r, size, policy) \
+	static uint8_t r##_buf[(size)] DTCM_BSS; \
+	tx_ring r = {#r, r##_buf, (size) - 1, (policy), 0, 0, 0, 0, 0, 0}
+
+uint16_t tx_ring_write(tx_ring *r, const void *data, uint16_t len, void (*wait)(void));
+bool tx_ring_pop(tx_ring *r, uint8_t *c);
+bool tx_ring_empty(const tx_ring *r);
+uint16_t tx_ring_free(const tx_ring *r);
+void tx_ring_get_stats(const tx_ring *r, tx_ring_stats *stats);
+
+#endif /* TX_RING_H_ */
@@ -0,0 +1,85 @@
+/*
+ * user_programs.c
+ *
+ * O registro tem largura fixa por campo e uma versao na frente: um formato
+ * novo muda a versao e user_program_load() recusa o antigo em vez de ler
+ * lixo.
+ */
+
+#include <string.h>
+#include "user_programs.h"
+
+#define RECORD_VERSION  1
+
+typedef struct {
+	uint8_t version;
+	uint8_t enxagueTempo;
+	uint8_t enxagueQnt;
+	uint8_t centrifugacaoTempo;
+	uint16_t centrifugacaoRPM;
+	uint8_t heavy;
+	uint8_t bubblesOn;
+	char nome[USER_PROGRAM_NAME];
+} user_program_record;
+
+kv_status user_program_save(uint8_t slot, const t_ciclo *c){
+	user_program_record r;
+
+	if (slot >= USER_PROGRAM_SLOTS){
+		return KV_ERR_NOT_FOUND;
+	}
+	memset(&r, 0, sizeof(r));
+	r.version = RECORD_VERSION;
+	r.enxagueTempo = (uint8_t)c->enxagueTempo;
+	r.enxagueQnt = (uint8_t)c->enxagueQnt;
+	r.centrifugacaoTempo = (uint8_t)c->centrifugacaoTempo;
+	r.centrifugacaoRPM = (uint16_t)c->centrifugacaoRPM;
+	r.heavy = c->heavy;
+	r.bubblesOn = c->bubblesOn;
+	strncpy(r.nome, c->nome, USER_PROGRAM_NAME - 1);
+	return kv_put(USER_PROGRAM_KEY + slot, &r, sizeof(r));
+}
+
+kv_status user_program_load(uint8_t slot, t_ciclo *c){
+	user_program_record r;
+	uint16_t len;
+	kv_status st;
+
+	if (slot >= USER_PROGRAM_SLOTS){
+		return KV_ERR_NOT_FOUND;
+	}
+	st = kv_get(USER_PROGRAM_KEY + slot, &r, sizeof(r), &len);
+	if (st != KV_OK){
+		return st;
+	}
+	if (len != sizeof(r) || r.version != RECORD_VERSION){
+		return KV_ERR_NOT_FOUND;
+	}
+	memset(c, 0, sizeof(*c));
+	memcpy(c->nome, r.nome, USER_PROGRAM_NAME);
+	c->nome[USER_PROGRAM_NAME - 1] = '\0';
+	c->enxagueTempo = r.enxagueTempo;
+	c->enxagueQnt = r.enxagueQnt;
+	c->centrifugacaoTempo = r.centrifugacaoTempo;
+	c->centrifugacaoRPM = r.centrifugacaoRPM;
+	c->heavy = r.heavy;
+	c->bubblesOn = r.bubblesOn;
+	return KV_OK;
+}
+
+kv_status user_program_delete(uint8_t slot){
+	if (slot >= USER_PROGRAM_SLOTS){
+		return KV_ERR_NOT_FOUND;
+	}
+	return kv_delete(USER_PROGRAM_KEY + slot);
+}
+
+uint8_t user_program_count(void){
+	uint8_t n = 0;
+
+	for (uint8_t i = 0; i < kv_count(); i++){
+		uint16_t key = kv_key_at(i);
+		n += key >= USER_PROGRAM_KEY && key < USER_PROGRAM_KEY + USER_PROGRAM_SLOTS;
+	}
+	return n;
+}
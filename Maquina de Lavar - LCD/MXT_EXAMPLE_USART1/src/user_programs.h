@@ -0,0 +1,28 @@
+/*
+ * user_programs.h
+ *
+ * Programas de lavagem criados pelo usuario, guardados no kv_store (um por
+ * chave, USER_PROGRAM_KEY + slot) e por isso mantidos sem energia. O valor
+ * e um registro compacto com os campos do t_ciclo; o nome fica limitado a
+ * USER_PROGRAM_NAME - 1 caracteres.
+ */
+
+
+#ifndef USER_PROGRAMS_H_
+#define USER_PROGRAMS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ciclo.h"
+#include "kv_store.h"
+
+#define USER_PROGRAM_SLOTS  16
+#define USER_PROGRAM_KEY    0x0100
+#define USER_PROGRAM_NAME   16
+
+kv_status user_program_save(uint8_t slot, const t_ciclo *ciclo);
+kv_status user_program_load(uint8_t slot, t_ciclo *ciclo);
+kv_status user_program_delete(uint8_t slot);
+uint8_t user_program_count(void);
+
+#endif /* USER_PROGRAMS_H_ */
@@ -0,0 +1,78 @@
+/*
+ * wash_checkpoint.c
+ *
+ * Cada slot sao 4 registradores: {marca, sequencia, programa, fase}, prazo
+ * (parte baixa), prazo (parte alta) e o CRC-32 dos tres. A gravacao vai
+ * para o slot que nao tem o checkpoint atual e o CRC e escrito por ultimo;
+ * a leitura fica com o slot valido de sequencia mais nova. Sao 4 escritas
+ * de registrador e um CRC de 12 bytes por troca de fase.
+ */
+
+#include "wash_checkpoint.h"
+#include "backup_regs.h"
+#include "crc32.h"
+
+#define SLOT_WORDS  4u
+#define SLOTS       2u
+#define MAGIC       0x57u   // 'W'
+
+_Static_assert(SLOT_WORDS * SLOTS <= BACKUP_REGS, "checkpoint nao cabe nos registradores de backup");
+
+static uint8_t seq;
+
+static void slot_read(uint8_t slot, uint32_t w[SLOT_WORDS]){
+	for (uint8_t i = 0; i < SLOT_WORDS; i++){
+		w[i] = backup_read(slot * SLOT_WORDS + i);
+	}
+}
+
+static bool slot_valid(const uint32_t w[SLOT_WORDS]){
+	return (w[0] >> 24) == MAGIC && crc32(w, 3 * sizeof(uint32_t)) == w[3];
+}
+
+void wash_checkpoint_save(const wash_checkpoint *cp){
+	uint32_t w[SLOT_WORDS];
+	uint8_t slot;
+
+	seq++;
+	slot = seq % SLOTS;
+	w[0] = ((uint32_t)MAGIC << 24) | ((uint32_t)seq << 16) | ((uint32_t)cp->program << 8) | cp->phase;
+	w[1] = (uint32_t)cp->deadline_ms;
+	w[2] = (uint32_t)(cp->deadline_ms >> 32);
+	w[3] = crc32(w, 3 * sizeof(uint32_t));
+
+	//O CRC POR ULTIMO: ATE ELE, O SLOT E INVALIDO E VALE O OUTRO
+	for (uint8_t i = 0; i < SLOT_WORDS; i++){
+		backup_write(slot * SLOT_WORDS + i, w[i]);
+	}
+}
+
+bool wash_checkpoint_load(wash_checkpoint *cp){
+	uint32_t w[SLOTS][SLOT_WORDS];
+	int8_t best = -1;
+
+	for (uint8_t s = 0; s < SLOTS; s++){
+		slot_read(s, w[s]);
+		if (!slot_valid(w[s])){
+			continue;
+		}
+		//SEQUENCIA DE 8 BITS: A MAIS NOVA E A QUE ESTA A FRENTE NA VOLTA
+		if (best < 0 || (int8_t)((uint8_t)(w[s][0] >> 16) - (uint8_t)(w[best][0] >> 16)) > 0){
+			best = s;
+		}
+	}
+	if (best < 0){
+		return false;
+	}
+	seq = (uint8_t)(w[best][0] >> 16);
+	cp->program = (uint8_t)(w[best][0] >> 8);
+	cp->phase = (uint8_t)w[best][0];
+	cp->deadline_ms = ((uint64_t)w[best][2] << 32) | w[best][1];
+	return true;
+}
+
+void wash_checkpoint_clear(void){
+	for (uint8_t s = 0; s < SLOTS; s++){
+		backup_write(s * SLOT_WORDS, 0);
+	}
+}
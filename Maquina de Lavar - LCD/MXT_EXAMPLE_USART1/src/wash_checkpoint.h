@@ -0,0 +1,29 @@
+/*
+ * wash_checkpoint.h
+ *
+ * Ponto de retomada da lavagem nos registradores de backup (backup_regs.h):
+ * qual programa, em que fase e o prazo absoluto (ms do clock_source) do fim
+ * dessa fase. wash_flow.c grava a cada troca de fase e apaga no fim ou no
+ * cancelamento; no boot, um checkpoint valido volta direto para a lavagem.
+ * Sao dois slots alternados com numero de sequencia e CRC, entao uma queda
+ * no meio da gravacao deixa o checkpoint anterior valido.
+ */
+
+
+#ifndef WASH_CHECKPOINT_H_
+#define WASH_CHECKPOINT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+	uint8_t program;       // indice na cycle_table
+	uint8_t phase;         // indice da fase no wash_program
+	uint64_t deadline_ms;  // fim da fase, ms absoluto
+} wash_checkpoint;
+
+void wash_checkpoint_save(const wash_checkpoint *cp);
+bool wash_checkpoint_load(wash_checkpoint *cp);
+void wash_checkpoint_clear(void);
+
+#endif /* WASH_CHECKPOINT_H_ */
@@ -0,0 +1,138 @@
+/*
+ * wash_flow.c
+ *
+ * A contagem e derivada do prazo absoluto do fim, nao decrementada: o timer
+ * da contagem vence exatamente quando o teto de (fim - agora) em segundos
+ * muda, entao a tela nunca escorrega mesmo que um callback atrase.
+ */
+
+#include <stddef.h>
+#include "wash_flow.h"
+#include "timebase.h"
+#include "wash_checkpoint.h"
+
+static wash_engine washer;
+static uint64_t wash_deadline;
+static timebase_timer wash_timer;
+static timebase_timer countdown_timer;
+static uint8_t state;
+static uint8_t program_id;
+static uint32_t seconds_left;
+static wash_flow_handler notify;
+
+static void emit(uint8_t event, const wash_phase *phase){
+	if (notify){
+		notify(event, phase);
+	}
+}
+
+//ATUALIZA A CONTAGEM A PARTIR DO PRAZO E ARMA A PROXIMA TROCA DE SEGUNDO
+static void on_countdown(timebase_timer *t){
+	uint64_t now = timebase_now();
+	uint64_t left = wash_deadline > now ? wash_deadline - now : 0;
+
+	(void)t;
+	seconds_left = (uint32_t)((left + 999) / 1000);
+	emit(WASH_FLOW_EV_COUNTDOWN, NULL);
+	if (seconds_left > 0){
+		timebase_start(&countdown_timer, wash_deadline - (uint64_t)(seconds_left - 1) * 1000, on_countdown);
+	}
+}
+
+//CADA TROCA DE FASE VAI PARA O CHECKPOINT ANTES DE AVISAR A TELA
+static void on_wash_phase(const wash_engine *e, const wash_phase *ph){
+	if (ph->type != WASH_PHASE_DONE){
+		wash_checkpoint cp = {program_id, e->current, wash_engine_next_deadline(e)};
+		wash_checkpoint_save(&cp);
+	}
+	emit(WASH_FLOW_EV_PHASE, ph);
+	if (ph->type == WASH_PHASE_DONE && state == WASH_FLOW_WASHING){
+		state = WASH_FLOW_FINISHED;
+		wash_checkpoint_clear();
+		timebase_stop(&countdown_timer);
+		seconds_left = 0;
+		emit(WASH_FLOW_EV_DONE, ph);
+	}
+}
+
+//FIM DA FASE ATUAL: AVANCA O MOTOR E ARMA O FIM DA PROXIMA
+static void on_wash_timer(timebase_timer *t){
+	(void)t;
+	wash_engine_advance(&washer, timebase_now());
+
+	uint64_t next = wash_engine_next_deadline(&washer);
+	if (next != WASH_NO_DEADLINE){
+		timebase_start(&wash_timer, next, on_wash_timer);
+	}
+}
+
+//BOOT, DEPOIS DO timebase_init(): OS TIMERS NAO ESTAO EM RODA NENHUMA E O
+//CHECKPOINT FICA, PARA O wash_flow_resume()
+void wash_flow_init(wash_flow_handler handler){
+	notify = handler;
+	state = WASH_FLOW_IDLE;
+	seconds_left = 0;
+	wash_engine_stop(&washer);
+	wash_timer.armed = false;
+	countdown_timer.armed = false;
+}
+
+//ARMA O FIM DA FASE ATUAL E A CONTAGEM DO MOTOR JA CARREGADO
+static void begin(void){
+	wash_deadline = wash_engine_end(&washer);
+	on_wash_timer(&wash_timer);
+	on_countdown(&countdown_timer);
+}
+
+void wash_flow_start(uint8_t id, const wash_program *program){
+	program_id = id;
+	state = WASH_FLOW_WASHING;
+	wash_engine_load(&washer, program, timebase_now(), on_wash_phase);
+	begin();
+}
+
+//VOLTA DE UMA QUEDA NA FASE DO CHECKPOINT, COM O MESMO PRAZO ABSOLUTO. SE O
+//PRAZO JA PASSOU (QUEDA LONGA) OU ESTA MAIS LONGE QUE A FASE INTEIRA (O RTT
+//RECOMECOU), A FASE RECOMECA: A ROUPA NAO ANDOU COM A MAQUINA DESLIGADA
+bool wash_flow_resume(uint8_t id, const wash_program *program, uint8_t phase, uint64_t deadline_ms){
+	uint64_t now = timebase_now();
+
+	if (phase + 1 >= program->count){
+		return false;
+	}
+	uint32_t duration = program->phases[phase].duration_ms;
+	if (deadline_ms <= now || deadline_ms - now > duration){
+		deadline_ms = now + duration;
+	}
+	program_id = id;
+	state = WASH_FLOW_WASHING;
+	wash_engine_resume(&washer, program, phase, deadline_ms, on_wash_phase);
+	begin();
+	return true;
+}
+
+//PARA O CICLO (SE HOUVER) E VOLTA PARA A TELA DE ESCOLHA
+void wash_flow_reset(void){
+	state = WASH_FLOW_IDLE;
+	seconds_left = 0;
+	wash_checkpoint_clear();
+	wash_engine_stop(&washer);
+	timebase_stop(&wash_timer);
+	timebase_stop(&countdown_timer);
+}
+
+uint8_t wash_flow_get_state(void){
+	return state;
+}
+
+uint32_t wash_flow_seconds_left(void){
+	return seconds_left;
+}
+
+uint64_t wash_flow_end(void){
+	return wash_deadline;
+}
+
+const wash_phase *wash_flow_phase(void){
+	return wash_engine_phase(&washer);
+}
@@ -0,0 +1,44 @@
+/*
+ * wash_flow.h
+ *
+ * Fluxo da lavagem que o main.c usava direto: inicia o motor de
+ * wash_program.h, mantem a contagem regressiva na tela (um timer na troca
+ * de cada segundo) e o fim de cada fase (outro timer) e termina em
+ * "terminou". Tudo pela timebase, entao roda igual no RTT e no relogio
+ * virtual do host. O handler avisa o main para redesenhar. Cada troca de
+ * fase grava o checkpoint (wash_checkpoint.h) e wash_flow_resume() volta
+ * dele depois de uma queda de energia; id e o indice na cycle_table.
+ */
+
+
+#ifndef WASH_FLOW_H_
+#define WASH_FLOW_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "wash_program.h"
+
+typedef enum {
+	WASH_FLOW_IDLE,
+	WASH_FLOW_WASHING,
+	WASH_FLOW_FINISHED
+} wash_flow_state;
+
+typedef enum {
+	WASH_FLOW_EV_COUNTDOWN,   // mudou o segundo da contagem
+	WASH_FLOW_EV_PHASE,       // comecou uma fase (inclusive WASH_PHASE_DONE)
+	WASH_FLOW_EV_DONE         // terminou a lavagem
+} wash_flow_event;
+
+typedef void (*wash_flow_handler)(uint8_t event, const wash_phase *phase);
+
+void wash_flow_init(wash_flow_handler handler);
+void wash_flow_start(uint8_t id, const wash_program *program);
+bool wash_flow_resume(uint8_t id, const wash_program *program, uint8_t phase, uint64_t deadline_ms);
+void wash_flow_reset(void);
+uint8_t wash_flow_get_state(void);
+uint32_t wash_flow_seconds_left(void);
+uint64_t wash_flow_end(void);
+const wash_phase *wash_flow_phase(void);
+
+#endif /* WASH_FLOW_H_ */
@@ -0,0 +1,173 @@
+/*
+ * wash_program.c
+ *
+ * Tempos do t_ciclo em minutos. Fases de duracao zero nao entram na
+ * linha do tempo, entao "Centrifuga" comeca direto na subida e "Enxague"
+ * termina sem centrifugar.
+ *
+ * A linha do tempo NAO e a conta do antigo wash_time(), que dava
+ * (enxagueTempo * enxagueQnt + centrifugacaoTempo) * 1.2 no pesado. Aqui
+ * entram fases que a maquina tem e a conta ignorava: o enchimento
+ * (WASH_FILL_MS), uma lavagem de enxagueTempo antes dos enxagues e a
+ * subida da centrifuga (WASH_SPIN_RAMP_MS). O pesado estica so as fases
+ * com agua (lavagem e enxagues); a centrifuga fica igual. Por isso os
+ * ciclos ficam mais longos que antes:
+ *
+ *   Rapido      26.5 min (era 20)      Enxague   21 min (era 10)
+ *   Centrifuga  10.5 min (era 10)      Diario    54.5 min (era 38)
+ *   Pesado      59.5 min (era 48)
+ */
+
+#include "wash_program.h"
+
+#define MIN_MS 60000u
+
+static const char *phase_names[] = {
+	[WASH_PHASE_FILL]      = "Enchendo",
+	[WASH_PHASE_WASH]      = "Lavando",
+	[WASH_PHASE_RINSE]     = "Enxaguando",
+	[WASH_PHASE_SPIN_RAMP] = "Acelerando",
+	[WASH_PHASE_SPIN]      = "Centrifugando",
+	[WASH_PHASE_DONE]      = "Fim",
+};
+
+static void add_phase(wash_program *p, uint8_t type, uint8_t index, uint16_t rpm, uint32_t duration_ms){
+	if (duration_ms == 0 && type != WASH_PHASE_DONE){
+		return;
+	}
+	wash_phase *ph = &p->phases[p->count++];
+	ph->type = type;
+	ph->index = index;
+	ph->rpm = rpm;
+	ph->start_ms = p->total_ms;
+	ph->duration_ms = duration_ms;
+	p->total_ms += duration_ms;
+}
+
+void wash_program_compile(const t_ciclo *c, wash_program *p){
+	uint32_t water_ms = (uint32_t)c->enxagueTempo * MIN_MS;
+	uint8_t rinses = c->enxagueQnt > WASH_MAX_RINSES ? WASH_MAX_RINSES : c->enxagueQnt;
+
+	if (c->heavy){
+		water_ms = water_ms * 6 / 5;
+	}
+
+	p->count = 0;
+	p->total_ms = 0;
+
+	if (rinses > 0 && water_ms > 0){
+		add_phase(p, WASH_PHASE_FILL, 0, 0, WASH_FILL_MS);
+		add_phase(p, WASH_PHASE_WASH, 0, 0, water_ms);
+		for (uint8_t i = 1; i <= rinses; i++){
+			add_phase(p, WASH_PHASE_RINSE, i, 0, water_ms);
+		}
+	}
+	if (c->centrifugacaoRPM > 0 && c->centrifugacaoTempo > 0){
+		add_phase(p, WASH_PHASE_SPIN_RAMP, 0, c->centrifugacaoRPM, WASH_SPIN_RAMP_MS);
+		add_phase(p, WASH_PHASE_SPIN, 0, c->centrifugacaoRPM, (uint32_t)c->centrifugacaoTempo * MIN_MS);
+	}
+	add_phase(p, WASH_PHASE_DONE, 0, 0, 0);
+}
+
+const char *wash_phase_name(uint8_t type){
+	return type <= WASH_PHASE_DONE ? phase_names[type] : "";
+}
+
+//###############################################################################################################
+//MOTOR
+
+static void engine_begin(wash_engine *e, uint64_t now_ms, wash_phase_handler handler){
+	e->start_ms = now_ms;
+	e->current = 0;
+	e->running = true;
+	e->on_phase = handler;
+
+	if (e->on_phase){
+		e->on_phase(e, &e->program.phases[0]);
+	}
+	//CICLO VAZIO (SO A FASE DONE) TERMINA NA HORA
+	if (e->program.count == 1){
+		e->running = false;
+	}
+}
+
+void wash_engine_start(wash_engine *e, const t_ciclo *c, uint64_t now_ms, wash_phase_handler handler){
+	wash_program_compile(c, &e->program);
+	engine_begin(e, now_ms, handler);
+}
+
+//PROGRAMA JA COMPILADO (TABELA EM FLASH, cycle_table.c): SO COPIA
+void wash_engine_load(wash_engine *e, const wash_program *program, uint64_t now_ms, wash_phase_handler handler){
+	e->program = *program;
+	engine_begin(e, now_ms, handler);
+}
+
+//RETOMA NA FASE phase COM O FIM DELA EM phase_end_ms (CHECKPOINT DE ANTES DA QUEDA)
+void wash_engine_resume(wash_engine *e, const wash_program *program, uint8_t phase, uint64_t phase_end_ms,
+		wash_phase_handler handler){
+	const wash_phase *ph = &program->phases[phase];
+
+	e->program = *program;
+	e->start_ms = phase_end_ms - ph->start_ms - ph->duration_ms;
+	e->current = phase;
+	e->running = phase < program->count - 1;
+	e->on_phase = handler;
+
+	if (e->on_phase){
+		e->on_phase(e, ph);
+	}
+}
+
+void wash_engine_stop(wash_engine *e){
+	e->running = false;
+}
+
+//PASSA POR TODAS AS FASES QUE TERMINARAM ATE now_ms, AVISANDO CADA TROCA
+void wash_engine_advance(wash_engine *e, uint64_t now_ms){
+	if (!e->running){
+		return;
+	}
+	uint64_t elapsed = now_ms - e->start_ms;
+	uint8_t last = e->program.count - 1;
+
+	while (e->current < last){
+		const wash_phase *ph = &e->program.phases[e->current];
+
+		if (elapsed < (uint64_t)ph->start_ms + ph->duration_ms){
+			break;
+		}
+		e->current++;
+		if (e->current == last){
+			e->running = false;
+		}
+		if (e->on_phase){
+			e->on_phase(e, &e->program.phases[e->current]);
+		}
+	}
+}
+
+//FIM DA FASE ATUAL EM ms ABSOLUTO: O UNICO PRAZO QUE O MOTOR PRECISA
+uint64_t wash_engine_next_deadline(const wash_engine *e){
+	if (!e->running){
+		return WASH_NO_DEADLINE;
+	}
+	const wash_phase *ph = &e->program.phases[e->current];
+	return e->start_ms + ph->start_ms + ph->duration_ms;
+}
+
+uint64_t wash_engine_end(const wash_engine *e){
+	return e->start_ms + e->program.total_ms;
+}
+
+uint32_t wash_engine_remaining(const wash_engine *e, uint64_t now_ms){
+	uint64_t end = wash_engine_end(e);
+
+	if (!e->running || now_ms >= end){
+		return 0;
+	}
+	return (uint32_t)(end - now_ms);
+}
+
+const wash_phase *wash_engine_phase(const wash_engine *e){
+	return &e->program.phases[e->current];
+}
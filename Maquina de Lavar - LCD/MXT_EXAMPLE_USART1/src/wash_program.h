@@ -0,0 +1,75 @@
+/*
+ * wash_program.h
+ *
+ * Execucao do ciclo de lavagem. wash_program_compile() transforma um
+ * t_ciclo numa linha do tempo de fases (encher, lavar, cada enxague, subida
+ * da centrifuga, centrifugar) com o inicio acumulado de cada uma. O motor
+ * guarda a fase atual, entao fase e tempo restante saem em O(1), e so
+ * precisa de um timer: o fim da fase atual. O tempo vem de quem chama
+ * (ms absolutos), entao o mesmo codigo roda no RTT ou em tempo virtual.
+ */
+
+
+#ifndef WASH_PROGRAM_H_
+#define WASH_PROGRAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ciclo.h"
+
+#define WASH_MAX_RINSES     8
+#define WASH_MAX_PHASES     (WASH_MAX_RINSES + 5)  // encher, lavar, enxagues, subida, centrifuga, fim
+
+#define WASH_FILL_MS        60000u   // encher o tambor
+#define WASH_SPIN_RAMP_MS   30000u   // subida ate a rotacao da centrifuga
+#define WASH_NO_DEADLINE    UINT64_MAX
+
+typedef enum {
+	WASH_PHASE_FILL,
+	WASH_PHASE_WASH,
+	WASH_PHASE_RINSE,
+	WASH_PHASE_SPIN_RAMP,
+	WASH_PHASE_SPIN,
+	WASH_PHASE_DONE     // ultima entrada, duracao 0
+} wash_phase_type;
+
+typedef struct {
+	uint8_t type;        // wash_phase_type
+	uint8_t index;       // numero do enxague (1..n), 0 nas outras
+	uint16_t rpm;        // rotacao alvo do tambor
+	uint32_t start_ms;   // inicio, relativo ao comeco do ciclo
+	uint32_t duration_ms;
+} wash_phase;
+
+typedef struct {
+	wash_phase phases[WASH_MAX_PHASES];
+	uint8_t count;       // inclui a fase WASH_PHASE_DONE
+	uint32_t total_ms;
+} wash_program;
+
+typedef struct wash_engine wash_engine;
+typedef void (*wash_phase_handler)(const wash_engine *engine, const wash_phase *phase);
+
+struct wash_engine {
+	wash_program program;
+	uint64_t start_ms;   // ms absoluto do inicio
+	uint8_t current;     // indice da fase atual
+	bool running;
+	wash_phase_handler on_phase;
+};
+
+void wash_program_compile(const t_ciclo *ciclo, wash_program *program);
+const char *wash_phase_name(uint8_t type);
+
+void wash_engine_start(wash_engine *engine, const t_ciclo *ciclo, uint64_t now_ms, wash_phase_handler handler);
+void wash_engine_load(wash_engine *engine, const wash_program *program, uint64_t now_ms, wash_phase_handler handler);
+void wash_engine_resume(wash_engine *engine, const wash_program *program, uint8_t phase, uint64_t phase_end_ms,
+		wash_phase_handler handler);
+void wash_engine_stop(wash_engine *engine);
+void wash_engine_advance(wash_engine *engine, uint64_t now_ms);
+uint64_t wash_engine_next_deadline(const wash_engine *engine);
+uint64_t wash_engine_end(const wash_engine *engine);
+uint32_t wash_engine_remaining(const wash_engine *engine, uint64_t now_ms);
+const wash_phase *wash_engine_phase(const wash_engine *engine);
+
+#endif /* WASH_PROGRAM_H_ */
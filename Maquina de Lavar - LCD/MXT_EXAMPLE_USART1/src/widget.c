@@ -0,0 +1,473 @@
+/*
+ * widget.c
+ *
+ * O render tem duas passadas. A primeira desce so pelos ramos com
+ * WIDGET_CHILD_DIRTY e junta, de cada widget sujo, a area onde ele estava
+ * (painted) e a area onde esta agora; areas contidas em outras somem. A
+ * segunda pinta cada area de baixo para cima (pre-ordem da arvore, irmaos
+ * em ordem de z), recortada nela, comecando pelo ultimo widget opaco que
+ * cobre a area inteira: o que esta embaixo dele nao aparece.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ili9488.h"
+#include "widget.h"
+#include "frame_sched.h"
+#include "latency.h"
+
+static widget_rect damage[WIDGET_DAMAGE_MAX];
+static uint8_t damage_count;
+static const widget *cover;
+static bool started;
+static widget_stats stats;
+
+//####################################################################
+//RETANGULOS
+
+static inline bool rect_empty(const widget_rect *r){
+	return r->w == 0 || r->h == 0;
+}
+
+static inline uint32_t rect_area(const widget_rect *r){
+	return (uint32_t)r->w * r->h;
+}
+
+static bool rect_intersect(const widget_rect *a, const widget_rect *b, widget_rect *out){
+	uint16_t x0 = a->x > b->x ? a->x : b->x;
+	uint16_t y0 = a->y > b->y ? a->y : b->y;
+	uint32_t ax1 = a->x + a->w, bx1 = b->x + b->w;
+	uint32_t ay1 = a->y + a->h, by1 = b->y + b->h;
+	uint32_t x1 = ax1 < bx1 ? ax1 : bx1;
+	uint32_t y1 = ay1 < by1 ? ay1 : by1;
+
+	if (x1 <= x0 || y1 <= y0){
+		return false;
+	}
+	*out = (widget_rect){x0, y0, x1 - x0, y1 - y0};
+	return true;
+}
+
+//a CONTEM b
+static bool rect_contains(const widget_rect *a, const widget_rect *b){
+	return b->x >= a->x && b->y >= a->y && b->x + b->w <= a->x + a->w && b->y + b->h <= a->y + a->h;
+}
+
+static widget_rect rect_union(const widget_rect *a, const widget_rect *b){
+	uint16_t x0 = a->x < b->x ? a->x : b->x;
+	uint16_t y0 = a->y < b->y ? a->y : b->y;
+	uint32_t ax1 = a->x + a->w, bx1 = b->x + b->w;
+	uint32_t ay1 = a->y + a->h, by1 = b->y + b->h;
+
+	return (widget_rect){x0, y0, (ax1 > bx1 ? ax1 : bx1) - x0, (ay1 > by1 ? ay1 : by1) - y0};
+}
+
+//####################################################################
+//AREAS A REDESENHAR
+
+static void damage_add(const widget_rect *r){
+	static const widget_rect screen = {0, 0, ILI9488_LCD_WIDTH, ILI9488_LCD_HEIGHT};
+	widget_rect a;
+
+	if (rect_empty(r) || !rect_intersect(r, &screen, &a)){
+		return;
+	}
+	for (uint8_t i = 0; i < damage_count; i++){
+		if (rect_contains(&damage[i], &a)){
+			return;
+		}
+	}
+	for (uint8_t i = 0; i < damage_count; ){
+		if (rect_contains(&a, &damage[i])){
+			damage[i] = damage[--damage_count];
+		} else {
+			i++;
+		}
+	}
+	if (damage_count < WIDGET_DAMAGE_MAX){
+		damage[damage_count++] = a;
+		return;
+	}
+
+	//CHEIO: JUNTA COM A QUE CRESCE MENOS
+	uint8_t best = 0;
+	uint32_t best_growth = UINT32_MAX;
+	for (uint8_t i = 0; i < damage_count; i++){
+		widget_rect u = rect_union(&damage[i], &a);
+		uint32_t growth = rect_area(&u) - rect_area(&damage[i]);
+		if (growth < best_growth){
+			best_growth = growth;
+			best = i;
+		}
+	}
+	damage[best] = rect_union(&damage[best], &a);
+	stats.merges++;
+}
+
+void widget_damage(uint16_t x, uint16_t y, uint16_t width, uint16_t height){
+	widget_rect r = {x, y, width, height};
+	damage_add(&r);
+}
+
+//####################################################################
+//TEXTO
+
+static const tImage *glyph(const tFont *font, char c){
+	if (c < font->start_char || c > font->end_char){
+		return NULL;
+	}
+	return font->chars[c - font->start_char].image;
+}
+
+uint16_t widget_text_width(const tFont *font, uint8_t spacing, const char *text){
+	uint16_t width = 0;
+
+	for (const char *p = text; *p != '\0'; p++){
+		const tImage *g = glyph(font, *p);
+		if (g != NULL){
+			width += g->width + (width ? spacing : 0);
+		}
+	}
+	return width;
+}
+
+static const char *number_text(const widget *w, char buf[12]){
+	uint32_t v = w->number.value;
+
+	if (w->number.format == NUMBER_MMSS){
+		snprintf(buf, 12, "%02lu:%02lu", (unsigned long)(v / 60), (unsigned long)(v % 60));
+	} else {
+		snprintf(buf, 12, "%lu", (unsigned long)v);
+	}
+	return buf;
+}
+
+//BOUNDS DE TEXTO E NUMERO SAEM DO TEXTO, ANCORADOS NO CANTO DE CIMA
+static void text_bounds(widget *w, const tFont *font, uint8_t spacing, const char *text){
+	w->bounds.w = widget_text_width(font, spacing, text);
+	w->bounds.h = font->chars[0].image->height;
+}
+
+//####################################################################
+//DESENHO, SEMPRE RECORTADO EM clip
+
+static void draw_fill(uint32_t color, const widget_rect *r, const widget_rect *clip){
+	widget_rect c;
+
+	if (rect_intersect(r, clip, &c)){
+		ili9488_set_foreground_color(color);
+		ili9488_draw_filled_rectangle(c.x, c.y, c.x + c.w - 1, c.y + c.h - 1);
+	}
+}
+
+static void draw_image(const tImage *img, uint16_t x, uint16_t y, const widget_rect *clip){
+	widget_rect r = {x, y, img->width, img->height};
+	widget_rect c;
+
+	if (rect_intersect(&r, clip, &c)){
+		const uint8_t *p = img->data + ((uint32_t)(c.y - y) * img->width + (c.x - x)) * LCD_DATA_COLOR_UNIT;
+		ili9488_draw_pixmap_rect(c.x, c.y, c.w, c.h, p, img->width);
+	}
+}
+
+static void draw_text(const tFont *font, uint8_t spacing, const char *text, uint16_t x, uint16_t y,
+		const widget_rect *clip){
+	for (const char *p = text; *p != '\0'; p++){
+		const tImage *g = glyph(font, *p);
+		if (g != NULL){
+			draw_image(g, x, y, clip);
+			x += g->width + spacing;
+		}
+	}
+}
+
+static void draw_progress(const widget *w, const widget_rect *clip){
+	const widget_rect *b = &w->bounds;
+	uint16_t done = w->progress.max ? (uint64_t)b->w * w->progress.value / w->progress.max : 0;
+	widget_rect fg = {b->x, b->y, done, b->h};
+	widget_rect bg = {b->x + done, b->y, b->w - done, b->h};
+
+	if (!rect_empty(&fg)){
+		draw_fill(w->progress.fg, &fg, clip);
+	}
+	if (!rect_empty(&bg)){
+		draw_fill(w->progress.bg, &bg, clip);
+	}
+}
+
+static void draw_widget(const widget *w, const widget_rect *clip){
+	char buf[12];
+
+	switch (w->type){
+		case WIDGET_CONTAINER:
+			FRAME_DRAW(WIDGET_FILL, draw_fill(w->container.color, &w->bounds, clip));
+			break;
+		case WIDGET_IMAGE_BUTTON:
+			FRAME_DRAW(WIDGET_BUTTON, draw_image(w->button.image[w->button.state], w->bounds.x, w->bounds.y, clip));
+			//O PRIMEIRO ICONE ESCRITO DEPOIS DO CALLBACK FECHA A AMOSTRA DE LATENCIA
+			latency_mark(LAT_DISPLAY);
+			break;
+		case WIDGET_LABEL:
+			FRAME_DRAW(WIDGET_LABEL, draw_text(w->label.font, w->label.spacing, w->label.text, w->bounds.x,
+					w->bounds.y, clip));
+			break;
+		case WIDGET_NUMBER:
+			FRAME_DRAW(WIDGET_NUMBER, draw_text(w->number.font, w->number.spacing, number_text(w, buf),
+					w->bounds.x, w->bounds.y, clip));
+			break;
+		case WIDGET_PROGRESS:
+			FRAME_DRAW(WIDGET_PROGRESS, draw_progress(w, clip));
+			break;
+		default: break;
+	}
+}
+
+//####################################################################
+//ARVORE
+
+static void widget_base(widget *w, uint8_t type, uint16_t x, uint16_t y, uint16_t width, uint16_t height){
+	memset(w, 0, sizeof(*w));
+	w->type = type;
+	w->flags = WIDGET_VISIBLE | WIDGET_DIRTY;
+	w->bounds = (widget_rect){x, y, width, height};
+}
+
+void widget_container(widget *w, uint16_t x, uint16_t y, uint16_t width, uint16_t height, bool opaque,
+		uint32_t color){
+	widget_base(w, WIDGET_CONTAINER, x, y, width, height);
+	w->flags |= opaque ? WIDGET_OPAQUE : 0;
+	w->container.color = color;
+}
+
+void widget_image_button(widget *w, uint16_t x, uint16_t y, const tImage *image0, const tImage *image1){
+	widget_base(w, WIDGET_IMAGE_BUTTON, x, y, image0->width, image0->height);
+	w->flags |= WIDGET_OPAQUE;
+	w->button.image[0] = image0;
+	w->button.image[1] = image1;
+}
+
+void widget_label(widget *w, uint16_t x, uint16_t y, const tFont *font, uint8_t spacing, const char *text){
+	widget_base(w, WIDGET_LABEL, x, y, 0, 0);
+	w->label.font = font;
+	w->label.spacing = spacing;
+	w->label.text = text;
+	text_bounds(w, font, spacing, text);
+}
+
+void widget_number(widget *w, uint16_t x, uint16_t y, const tFont *font, uint8_t spacing, uint8_t format){
+	char buf[12];
+
+	widget_base(w, WIDGET_NUMBER, x, y, 0, 0);
+	w->number.font = font;
+	w->number.spacing = spacing;
+	w->number.format = format;
+	text_bounds(w, font, spacing, number_text(w, buf));
+}
+
+void widget_progress(widget *w, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t fg,
+		uint32_t bg){
+	widget_base(w, WIDGET_PROGRESS, x, y, width, height);
+	w->flags |= WIDGET_OPAQUE;
+	w->progress.fg = fg;
+	w->progress.bg = bg;
+}
+
+//SOBE MARCANDO QUE HA DESCENDENTE SUJO; PARA NO PRIMEIRO QUE JA ESTAVA
+static void mark_parents(widget *w){
+	for (widget *p = w->parent; p != NULL && !(p->flags & WIDGET_CHILD_DIRTY); p = p->parent){
+		p->flags |= WIDGET_CHILD_DIRTY;
+	}
+}
+
+void widget_invalidate(widget *w){
+	w->flags |= WIDGET_DIRTY;
+	mark_parents(w);
+}
+
+static void invalidate_subtree(widget *w){
+	w->flags |= WIDGET_DIRTY;
+	if (w->child != NULL){
+		w->flags |= WIDGET_CHILD_DIRTY;
+	}
+	for (widget *c = w->child; c != NULL; c = c->next){
+		invalidate_subtree(c);
+	}
+}
+
+//O FILHO ENTRA DEPOIS DOS IRMAOS DE z MENOR OU IGUAL
+void widget_add(widget *parent, widget *child, uint8_t z){
+	widget **p = &parent->child;
+
+	while (*p != NULL && (*p)->z <= z){
+		p = &(*p)->next;
+	}
+	child->parent = parent;
+	child->z = z;
+	child->next = *p;
+	*p = child;
+	widget_invalidate(child);
+}
+
+static bool shown(const widget *w){
+	for (; w != NULL; w = w->parent){
+		if (!(w->flags & WIDGET_VISIBLE)){
+			return false;
+		}
+	}
+	return true;
+}
+
+//MOSTRAR OU ESCONDER SUJA A SUBARVORE INTEIRA: CADA UM SAI OU ENTRA NA TELA
+void widget_set_visible(widget *w, bool visible){
+	if (!(w->flags & WIDGET_VISIBLE) == !visible){
+		return;
+	}
+	w->flags ^= WIDGET_VISIBLE;
+	invalidate_subtree(w);
+	mark_parents(w);
+}
+
+void widget_set_state(widget *w, uint8_t state){
+	if (w->button.state != state){
+		w->button.state = state;
+		widget_invalidate(w);
+	}
+}
+
+void widget_set_text(widget *w, const char *text){
+	if (text == w->label.text || strcmp(text, w->label.text) == 0){
+		return;
+	}
+	w->label.text = text;
+	text_bounds(w, w->label.font, w->label.spacing, text);
+	widget_invalidate(w);
+}
+
+//TEXTO CONSTANTE COM A LARGURA JA MEDIDA (cycle_table.c): NAO PERCORRE OS GLIFOS
+void widget_set_text_w(widget *w, const char *text, uint16_t width){
+	if (text == w->label.text || strcmp(text, w->label.text) == 0){
+		return;
+	}
+	w->label.text = text;
+	w->bounds.w = width;
+	w->bounds.h = w->label.font->chars[0].image->height;
+	widget_invalidate(w);
+}
+
+//NA BARRA, SO AS COLUNAS QUE MUDARAM DE COR VAO PARA O REDESENHO
+static void progress_update(widget *w, uint32_t value, uint32_t max){
+	const widget_rect *b = &w->bounds;
+	uint16_t before = w->progress.max ? (uint64_t)b->w * w->progress.value / w->progress.max : 0;
+	uint16_t after = max ? (uint64_t)b->w * (value < max ? value : max) / max : 0;
+
+	w->progress.value = value < max ? value : max;
+	w->progress.max = max;
+	if (before != after && shown(w) && !(w->flags & WIDGET_DIRTY)){
+		uint16_t x0 = before < after ? before : after;
+		uint16_t x1 = before < after ? after : before;
+		widget_damage(b->x + x0, b->y, x1 - x0, b->h);
+	}
+}
+
+void widget_set_value(widget *w, uint32_t value){
+	char buf[12];
+
+	if (w->type == WIDGET_PROGRESS){
+		progress_update(w, value, w->progress.max);
+		return;
+	}
+	if (w->number.value == value){
+		return;
+	}
+	w->number.value = value;
+	text_bounds(w, w->number.font, w->number.spacing, number_text(w, buf));
+	widget_invalidate(w);
+}
+
+void widget_set_range(widget *w, uint32_t value, uint32_t max){
+	if (w->progress.max != max){
+		w->progress.max = max;
+		w->progress.value = value < max ? value : max;
+		widget_invalidate(w);
+		return;
+	}
+	progress_update(w, value, max);
+}
+
+//####################################################################
+//RENDER
+
+static bool paints(const widget *w){
+	return w->type != WIDGET_CONTAINER || (w->flags & WIDGET_OPAQUE);
+}
+
+static void collect(widget *w, bool parent_shown){
+	bool on = parent_shown && (w->flags & WIDGET_VISIBLE) && paints(w);
+
+	if (w->flags & WIDGET_DIRTY){
+		damage_add(&w->painted);
+		w->painted = on ? w->bounds : (widget_rect){0, 0, 0, 0};
+		damage_add(&w->painted);
+	}
+	if (w->flags & WIDGET_CHILD_DIRTY){
+		for (widget *c = w->child; c != NULL; c = c->next){
+			collect(c, parent_shown && (w->flags & WIDGET_VISIBLE));
+		}
+	}
+	w->flags &= ~(WIDGET_DIRTY | WIDGET_CHILD_DIRTY);
+}
+
+static void find_cover(const widget *w, const widget_rect *area){
+	if (!(w->flags & WIDGET_VISIBLE)){
+		return;
+	}
+	if ((w->flags & WIDGET_OPAQUE) && rect_contains(&w->bounds, area)){
+		cover = w;
+	}
+	for (const widget *c = w->child; c != NULL; c = c->next){
+		find_cover(c, area);
+	}
+}
+
+static void paint(const widget *w, const widget_rect *area){
+	widget_rect clip;
+
+	if (!(w->flags & WIDGET_VISIBLE)){
+		return;
+	}
+	if (w == cover){
+		started = true;
+	}
+	if (started && paints(w) && rect_intersect(&w->bounds, area, &clip)){
+		draw_widget(w, &clip);
+		stats.draws++;
+	}
+	for (const widget *c = w->child; c != NULL; c = c->next){
+		paint(c, area);
+	}
+}
+
+bool widget_pending(const widget *root){
+	return damage_count || (root->flags & (WIDGET_DIRTY | WIDGET_CHILD_DIRTY));
+}
+
+void widget_render(widget *root){
+	collect(root, true);
+	if (damage_count == 0){
+		return;
+	}
+	stats.renders++;
+	for (uint8_t i = 0; i < damage_count; i++){
+		cover = NULL;
+		find_cover(root, &damage[i]);
+		started = cover == NULL;
+		paint(root, &damage[i]);
+		stats.areas++;
+		stats.pixels += rect_area(&damage[i]);
+	}
+	damage_count = 0;
+}
+
+void widget_get_stats(widget_stats *out){
+	*out = stats;
+}
@@ -0,0 +1,119 @@
+/*
+ * widget.h
+ *
+ * Camada de widgets em modo retido: a tela e uma arvore de widgets
+ * estaticos (botao de imagem, texto, numero, barra de progresso e
+ * container), cada um com os bounds e o estado de sujo. Os setters so
+ * sujam quando o valor muda; widget_render() junta as areas dos sujos
+ * (onde estavam e onde estao) e redesenha so elas, pintando em ordem de z
+ * tudo que as cruza, recortado na area. Nada usa heap: quem usa declara
+ * os widgets e monta a arvore com widget_add() uma vez.
+ */
+
+
+#ifndef WIDGET_H_
+#define WIDGET_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tfont.h"
+
+#define WIDGET_DAMAGE_MAX  16   // areas por render; acima disso junta as mais proximas
+
+//flags
+#define WIDGET_VISIBLE      0x01
+#define WIDGET_OPAQUE       0x02   // pinta os bounds inteiros: o que esta embaixo nao aparece
+#define WIDGET_DIRTY        0x04   // mudou desde o ultimo widget_render()
+#define WIDGET_CHILD_DIRTY  0x08   // algum descendente mudou
+
+typedef enum {
+	WIDGET_CONTAINER,
+	WIDGET_IMAGE_BUTTON,
+	WIDGET_LABEL,
+	WIDGET_NUMBER,
+	WIDGET_PROGRESS
+} widget_type;
+
+typedef enum {
+	NUMBER_DEC,
+	NUMBER_MMSS
+} number_format;
+
+typedef struct {
+	uint16_t x;
+	uint16_t y;
+	uint16_t w;          // 0: vazio
+	uint16_t h;
+} widget_rect;
+
+typedef struct widget widget;
+
+struct widget {
+	widget_rect bounds;
+	widget_rect painted;     // bounds no ultimo render; vazio se nao estava na tela
+	uint8_t type;            // widget_type
+	uint8_t flags;
+	uint8_t z;               // ordem entre irmaos, maior fica por cima
+	widget *parent;
+	widget *child;           // primeiro filho, o de baixo
+	widget *next;            // proximo irmao, z maior ou igual
+	union {
+		struct {
+			uint32_t color;          // fundo, so com WIDGET_OPAQUE
+		} container;
+		struct {
+			const tImage *image[2];
+			uint8_t state;           // indice de image[]
+		} button;
+		struct {
+			const tFont *font;
+			const char *text;        // tem que continuar valido enquanto aparece
+			uint8_t spacing;
+		} label;
+		struct {
+			const tFont *font;
+			uint32_t value;
+			uint8_t format;          // number_format
+			uint8_t spacing;
+		} number;
+		struct {
+			uint32_t value;
+			uint32_t max;
+			uint32_t fg;
+			uint32_t bg;
+		} progress;
+	};
+};
+
+typedef struct {
+	uint32_t renders;
+	uint32_t areas;          // areas redesenhadas
+	uint32_t merges;         // areas juntadas por falta de espaco
+	uint32_t pixels;         // soma das areas
+	uint32_t draws;          // widgets pintados
+} widget_stats;
+
+void widget_container(widget *w, uint16_t x, uint16_t y, uint16_t width, uint16_t height, bool opaque,
+		uint32_t color);
+void widget_image_button(widget *w, uint16_t x, uint16_t y, const tImage *image0, const tImage *image1);
+void widget_label(widget *w, uint16_t x, uint16_t y, const tFont *font, uint8_t spacing, const char *text);
+void widget_number(widget *w, uint16_t x, uint16_t y, const tFont *font, uint8_t spacing, uint8_t format);
+void widget_progress(widget *w, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t fg,
+		uint32_t bg);
+void widget_add(widget *parent, widget *child, uint8_t z);
+
+void widget_set_visible(widget *w, bool visible);
+void widget_set_state(widget *w, uint8_t state);
+void widget_set_text(widget *w, const char *text);
+void widget_set_text_w(widget *w, const char *text, uint16_t width);
+void widget_set_value(widget *w, uint32_t value);
+void widget_set_range(widget *w, uint32_t value, uint32_t max);
+void widget_invalidate(widget *w);
+void widget_damage(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+bool widget_pending(const widget *root);
+void widget_render(widget *root);
+uint16_t widget_text_width(const tFont *font, uint8_t spacing, const char *text);
+void widget_get_stats(widget_stats *stats);
+
+#endif /* WIDGET_H_ */